@@ -0,0 +1,723 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "BatchCarver.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <stdexcept>
+
+#include "WorkPool.h"
+
+BatchCarver::BatchCarver(ILog &log, SnoopConfig &appConfig) :
+    _log(log),
+    _appConfig(appConfig) {
+}
+
+// Also write a record of every exported image
+// - The writer must outlive the carving; nullptr turns the records off
+//
+void BatchCarver::setResultWriter(ResultWriter *results) {
+    _results = results;
+}
+
+// Send the images to pack files instead of exporting one file per image
+// - The writer must outlive the carving; nullptr restores file exports
+// - Images from different workers reach the packs in no set order; the
+//   pack index is sorted when it is written
+//
+void BatchCarver::setPackWriter(PackWriter *pack) {
+    _pack = pack;
+}
+
+// Leave out the images whose MD5 is in a known-file hash set
+// - The set must outlive the carving; nullptr exports every image
+//
+void BatchCarver::setKnownHashSet(const KnownHashSet *known) {
+    _known = known;
+}
+
+// Also write the MD5 of every exported file to a manifest
+// - The manifest must outlive the carving; nullptr turns it off
+//
+void BatchCarver::setHashManifest(HashManifest *manifest) {
+    _manifest = manifest;
+}
+
+// Carve every file in the list into the output directory
+//
+void BatchCarver::run(const QStringList &filePaths, const QString &outputDir) {
+    carve(buildIndex(filePaths), outputDir);
+}
+
+// Keep the candidate indexes in a directory between runs
+// - buildIndex() reuses the index saved for a file when the file's size
+//   and modification time still match, and saves the ones it scans
+// - An empty path turns this off
+//
+void BatchCarver::setIndexDir(const QString &indexDir) {
+    _indexDir = indexDir;
+}
+
+// Phase one: index the candidates of every file
+//
+// RETURN:
+// - One index per file, sorted by file path
+//
+std::vector<CandidateIndex> BatchCarver::buildIndex(const QStringList &filePaths) {
+    const auto jobs = makeJobs(filePaths);
+
+    std::vector<CandidateIndex> indexes;
+    indexes.reserve(jobs.size());
+
+    std::vector<bool> reused(jobs.size(), false);
+
+    for (size_t nJob = 0; nJob < jobs.size(); nJob++) {
+        const auto &job = jobs[nJob];
+
+        CandidateIndex saved;
+        if (!_indexDir.isEmpty() && saved.load(indexFilePath(_indexDir, job.outBaseName))
+            && saved.filePath() == job.filePath && saved.fileSize() == job.fileSize
+            && saved.fileModified() == job.fileModified && (saved.eoiIndexed() || !_appConfig.indexEoi())) {
+            indexes.push_back(std::move(saved));
+            reused[nJob] = true;
+        } else {
+            indexes.emplace_back(job.filePath, job.fileSize, job.fileModified);
+        }
+    }
+
+    WorkPool pool(_appConfig.threadCount());
+    _cores.resize(qMax<size_t>(_cores.size(), pool.threadCount()));
+
+    // Splitting only pays off when there are other workers to take chunks
+    auto chunks = makeChunks(jobs, pool.threadCount() > 1 ? _appConfig.chunkSize() : 0);
+    chunks.erase(std::remove_if(chunks.begin(), chunks.end(), [&](const Chunk &chunk) { return reused[chunk.job]; }),
+                 chunks.end());
+
+    std::vector<CandidateIndex> chunkIndexes(chunks.size());
+
+    pool.run(chunks.size(), [&](uint32_t nWorker, size_t nChunk) {
+        const auto &chunk = chunks[nChunk];
+        scanChunk(workerCore(nWorker), jobs[chunk.job], chunk, chunkIndexes[nChunk]);
+    });
+
+    // Chunks are in file and offset order, so they can simply be joined
+    for (size_t nChunk = 0; nChunk < chunks.size(); nChunk++) {
+        indexes[chunks[nChunk].job].append(chunkIndexes[nChunk]);
+    }
+
+    // A file is always tried from its start, even without an SOI there
+    for (auto &index : indexes) {
+        if (index.fileSize() > 0) {
+            index.addSoi(0);
+        }
+    }
+
+    if (!_indexDir.isEmpty()) {
+        for (size_t nJob = 0; nJob < jobs.size(); nJob++) {
+            const auto indexPath = indexFilePath(_indexDir, jobs[nJob].outBaseName);
+            if (!reused[nJob] && !indexes[nJob].save(indexPath)) {
+                _log.error(QString("Couldn't save the index [%1]").arg(indexPath));
+            }
+        }
+    }
+
+    if (LOG_INFO_ON(_log)) {
+        for (size_t nJob = 0; nJob < jobs.size(); nJob++) {
+            const auto &index = indexes[nJob];
+
+            auto summary = QString("Index of [%1]: %2 candidates").arg(index.filePath()).arg(index.soi().size());
+            if (index.eoiIndexed()) {
+                summary += QString(", %1 EOI markers").arg(index.eoi().size());
+            }
+
+            if (reused[nJob]) {
+                summary += " (reused)";
+            }
+
+            _log.info(summary);
+
+            // The other containers come from the same pass, at no extra read
+            for (const auto &cand : index.containers()) {
+                _log.info(QString("%1 signature at 0x%2 in [%3]")
+                              .arg(SigScan::typeName(cand.eType))
+                              .arg(cand.nPos, 8, 16, QChar('0'))
+                              .arg(index.filePath()));
+            }
+        }
+    }
+
+    return indexes;
+}
+
+// Phase two: validate the indexed candidates and export the images
+// - May be run again on the same indexes, eg. with other settings
+//
+void BatchCarver::carve(const std::vector<CandidateIndex> &indexes, const QString &outputDir) {
+    // Match every index to its job, which sorts by file path
+    std::vector<const CandidateIndex *> sortedIndexes;
+    for (const auto &index : indexes) {
+        sortedIndexes.push_back(&index);
+    }
+
+    std::sort(sortedIndexes.begin(), sortedIndexes.end(), [](const CandidateIndex *a, const CandidateIndex *b) {
+        return a->filePath() < b->filePath();
+    });
+
+    QStringList filePaths;
+    for (const auto index : sortedIndexes) {
+        filePaths += index->filePath();
+    }
+
+    const auto jobs = makeJobs(filePaths);
+
+    WorkPool pool(_appConfig.threadCount());
+    _cores.resize(qMax<size_t>(_cores.size(), pool.threadCount()));
+
+    std::vector<Batch> batches;
+    for (size_t nJob = 0; nJob < jobs.size(); nJob++) {
+        const auto nCount = sortedIndexes[nJob]->soi().size();
+
+        // Which candidates get skipped depends on the images before them,
+        // so a file carved with skipValidated() is never split
+        const auto split = pool.threadCount() > 1 && nCount > CARVE_BATCH && !_appConfig.skipValidated();
+
+        if (!split) {
+            if (nCount > 0) {
+                batches.push_back({nJob, 0, nCount, false});
+            }
+
+            continue;
+        }
+
+        for (size_t nFirst = 0; nFirst < nCount; nFirst += CARVE_BATCH) {
+            batches.push_back({nJob, nFirst, qMin(nFirst + CARVE_BATCH, nCount), true});
+        }
+    }
+
+    for (auto &core : _cores) {
+        if (core) {
+            core->headerCheck().resetCounts();
+        }
+    }
+
+    _dedup = _appConfig.dedup() ? std::make_unique<DedupSet>() : nullptr;
+    _knownSkipped = 0;
+
+    std::vector<std::vector<Export>> exports(batches.size());
+
+    pool.run(batches.size(), [&](uint32_t nWorker, size_t nBatch) {
+        const auto &batch = batches[nBatch];
+        carveBatch(workerCore(nWorker), jobs[batch.job], *sortedIndexes[batch.job], batch, outputDir, exports[nBatch]);
+    });
+
+    uint64_t duplicates = 0;
+    if (_dedup) {
+        duplicates = resolveDuplicates(jobs, batches, exports);
+    }
+
+    // Batches are in file and offset order and never share a candidate,
+    // so the exports of each split file can be gathered and numbered as
+    // if carved in one pass
+    for (size_t nBatch = 0; nBatch < batches.size() && !_pack;) {
+        const auto nJob = batches[nBatch].job;
+
+        std::vector<Export> jobExports;
+        for (; nBatch < batches.size() && batches[nBatch].job == nJob; nBatch++) {
+            if (!batches[nBatch].split) continue;
+
+            jobExports.insert(jobExports.end(), exports[nBatch].begin(), exports[nBatch].end());
+        }
+
+        if (!jobExports.empty()) {
+            numberExports(jobs[nJob], jobExports, outputDir);
+        }
+    }
+
+    reportHeaderChecks();
+
+    if (_known) {
+        LOG_INFO(_log, QString("Known files not exported: %1").arg(_knownSkipped.load()));
+    }
+
+    if (_dedup) {
+        LOG_INFO(_log, QString("Duplicates not exported: %1").arg(duplicates));
+    }
+
+    if (_results) {
+        _results->flush();
+    }
+
+    if (_manifest) {
+        _manifest->flush();
+    }
+}
+
+// Index the candidates that start inside a chunk
+//
+void BatchCarver::scanChunk(SnoopCore &core, const Job &job, const Chunk &chunk, CandidateIndex &index) {
+    try {
+        core.openFile(job.filePath);
+        core.indexCandidates(index, chunk.start, chunk.end);
+    } catch (const std::exception &ex) {
+        _log.error(ex.what());
+        core.closeFile();
+    }
+
+    _log.flush();
+}
+
+// Validate a batch of candidates and export every image that decodes
+// - A file carved in one batch is exported under its final names
+//   straight away
+// - A batch of a split file is exported under names that hold the image
+//   offset, as the final numbering depends on the batches before it
+// - With SnoopConfig::skipValidated(), candidates inside an image that
+//   decoded are skipped and its embedded images are exported from the
+//   positions reported by the analysis
+// - With a KnownHashSet set, an image whose MD5 is in it is only
+//   recorded as a known file
+// - With SnoopConfig::dedup(), an image whose content was already
+//   exported from an earlier position (by any worker) is left out.
+//   Exported copies are only recorded by resolveDuplicates(), which
+//   keeps the earliest.
+//
+void BatchCarver::carveBatch(SnoopCore &core, const Job &job, const CandidateIndex &index, const Batch &batch,
+                             const QString &outputDir, std::vector<Export> &exports) {
+    // Exports written but not yet hashed for the manifest
+    std::vector<HashJob> hashJobs(_manifest ? CARVE_HASH_GROUP : 0);
+    size_t nHashJobs = 0;
+
+    try {
+        core.openFile(job.filePath);
+
+        // The index already tells whether the file is an AVI
+        core.setAviCheck(index.hasContainer(SIG_T_AVI, 0));
+
+        auto outIndex = 1;
+
+        QByteArray imageData;     // Reused for every image sent to the packs
+
+        // Keep an exported copy of a content (with dedup()) until
+        // resolveDuplicates() knows whether it is the one to keep
+        const auto keepKeyed = [&](uint64_t offset, const QString &filePath, const ImageInfo &info,
+                                   const ContentKey &key, bool exported) {
+            Export exp = {offset, filePath, info};
+            exp.keyed = true;
+            exp.exported = exported;
+            exp.key = key;
+            exports.push_back(exp);
+        };
+
+        // Append the image the core has just validated to the packs
+        const auto packImage = [&](uint64_t offset, const ContentKey *key) {
+            if (!core.exportJpeg(imageData)) return false;
+
+            QString location;
+            uint8_t md5[16];
+            if (!_pack->append(job.filePath, offset, imageData, &location, md5)) {
+                _log.error(QString("Couldn't add image at 0x%1 of [%2] to the packs").arg(offset, 0, 16).arg(job.filePath));
+                return false;
+            }
+
+            ImageInfo info = {};
+            if (_results) {
+                core.imageInfo(info);
+            }
+
+            if (key) {
+                keepKeyed(offset, location, info, *key, true);
+
+                auto &exp = exports.back();
+                exp.hashed = true;
+                memcpy(exp.md5, md5, sizeof(exp.md5));
+                return true;
+            }
+
+            if (_manifest) {
+                _manifest->add(md5, location);
+            }
+
+            if (_results) {
+                _results->write(job.filePath, location, info);
+            }
+
+            return true;
+        };
+
+        // Export the image the core has just validated to a file of its own
+        const auto fileImage = [&](uint64_t offset, const QString &filePath, const ContentKey *key) {
+            const auto exported = _manifest ? core.exportJpeg(filePath, hashJobs[nHashJobs].data)
+                                  : core.exportJpeg(filePath);
+
+            ImageInfo info = {};
+            if (exported && _results) {
+                core.imageInfo(info);
+            }
+
+            // Split files and exported copies of a content are recorded
+            // once all batches are done
+            const auto keyed = key && exported;
+            const auto deferred = batch.split || keyed;
+
+            if (keyed) {
+                keepKeyed(offset, filePath, info, *key, true);
+            } else if (batch.split) {
+                exports.push_back({offset, filePath, info});
+            } else if (exported && _results) {
+                _results->write(job.filePath, filePath, info);
+            }
+
+            if (exported && _manifest) {
+                hashJobs[nHashJobs].filePath = filePath;
+                hashJobs[nHashJobs].exportIndex = deferred ? exports.size() - 1 : SIZE_MAX;
+
+                if (++nHashJobs == CARVE_HASH_GROUP) {
+                    hashExports(hashJobs, nHashJobs, exports);
+                    nHashJobs = 0;
+                }
+            }
+
+            return exported;
+        };
+
+        // Export the image the core has just validated, unless it is a
+        // known file or a copy of one already carved in this run
+        // - A skipped image still uses up its number, so names stay the
+        //   same whichever images are skipped
+        const auto exportImage = [&](uint64_t offset) {
+            const auto filePath = _pack ? QString()
+                                  : batch.split
+                                  ? QDir(outputDir).filePath(QString("%1_@%2.part").arg(job.outBaseName).arg(offset, 0, 16))
+                                  : outFilePath(outputDir, job.outBaseName, outIndex++);
+
+            uint8_t md5[16];
+            if (_known && core.imageMd5(md5) && _known->contains(md5)) {
+                _knownSkipped++;
+
+                if (batch.split && !_pack) {
+                    // Never created, so numberExports() skips it
+                    exports.push_back({offset, filePath, {}});
+                }
+
+                if (_results) {
+                    ImageInfo info = {};
+                    core.imageInfo(info);
+                    _results->writeKnown(job.filePath, info);
+                }
+
+                return;
+            }
+
+            ContentKey key = {};
+            const auto dedup = _dedup && (_appConfig.dedupIdentity() ? core.identityKey(key) : core.contentKey(key));
+
+            // A copy with an earlier copy already exported is left out.
+            // Its record waits for resolveDuplicates(), as a yet earlier
+            // copy may still turn up. (Never created, so numberExports()
+            // skips it.)
+            DedupOrigin origin;
+            if (dedup && _dedup->findEarlier(key, job.filePath, offset, origin)) {
+                ImageInfo info = {};
+                if (_results) {
+                    core.imageInfo(info);
+                }
+
+                keepKeyed(offset, filePath, info, key, false);
+                return;
+            }
+
+            const auto exported = _pack ? packImage(offset, dedup ? &key : nullptr)
+                                  : fileImage(offset, filePath, dedup ? &key : nullptr);
+
+            // A copy that failed to export never claims the content, so
+            // copies after it are still exported
+            if (dedup && exported) {
+                _dedup->claim(key, job.filePath, offset);
+            }
+        };
+
+        uint64_t skipEnd = 0;
+
+        for (auto nCand = batch.first; nCand < batch.last; nCand++) {
+            const auto offset = index.soi()[nCand];
+            if (offset < skipEnd) continue;
+
+            // Keep the report of each candidate in one piece
+            _log.flush();
+
+            core.setOffset(offset);
+            if (!core.analyze()) continue;
+
+            exportImage(offset);
+
+            if (!_appConfig.skipValidated()) continue;
+
+            // Read both before the embedded images replace the analysis
+            skipEnd = core.resumePosition();
+            const auto embedded = core.embeddedImages();
+
+            for (const auto embeddedOffset : embedded) {
+                core.setOffset(embeddedOffset);
+                if (core.analyze()) {
+                    exportImage(embeddedOffset);
+                }
+            }
+        }
+    } catch (const std::exception &ex) {
+        _log.error(ex.what());
+        core.closeFile();
+    }
+
+    if (nHashJobs > 0) {
+        hashExports(hashJobs, nHashJobs, exports);
+    }
+
+    _log.flush();
+}
+
+// Hash a group of exported files side by side, for the manifest
+// - The hash of an export of a split file is kept until numberExports()
+//   gives the file its final name
+//
+void BatchCarver::hashExports(std::vector<HashJob> &hashJobs, size_t nCount, std::vector<Export> &exports) {
+    const uint8_t *apData[CARVE_HASH_GROUP];
+    uint64_t anLen[CARVE_HASH_GROUP];
+    uint8_t aanMd5[CARVE_HASH_GROUP][16];
+
+    for (size_t nJob = 0; nJob < nCount; nJob++) {
+        apData[nJob] = reinterpret_cast<const uint8_t *>(hashJobs[nJob].data.constData());
+        anLen[nJob] = static_cast<uint64_t>(hashJobs[nJob].data.size());
+    }
+
+    Md5Multi::hash(apData, anLen, nCount, aanMd5);
+
+    for (size_t nJob = 0; nJob < nCount; nJob++) {
+        const auto &hashJob = hashJobs[nJob];
+
+        if (hashJob.exportIndex == SIZE_MAX) {
+            _manifest->add(aanMd5[nJob], hashJob.filePath);
+        } else {
+            auto &exp = exports[hashJob.exportIndex];
+            exp.hashed = true;
+            memcpy(exp.md5, aanMd5[nJob], sizeof(exp.md5));
+        }
+    }
+}
+
+// Keep one copy of every content carved with dedup()
+// - The copy kept is the earliest one exported, in file path and offset
+//   order, whichever worker got to it first
+// - Other copies that were exported anyway (before the earlier copy
+//   claimed the content) are deleted, or left out of the pack index
+// - Every copy not kept gets a duplicate record, pointing at the one kept
+//
+// RETURN:
+// - Number of copies not kept
+//
+uint64_t BatchCarver::resolveDuplicates(const std::vector<Job> &jobs, const std::vector<Batch> &batches,
+                                        std::vector<std::vector<Export>> &exports) {
+    uint64_t duplicates = 0;
+
+    for (size_t nBatch = 0; nBatch < batches.size(); nBatch++) {
+        const auto &batch = batches[nBatch];
+        const auto &job = jobs[batch.job];
+
+        for (auto &exp : exports[nBatch]) {
+            if (!exp.keyed) continue;
+
+            // A copy only waits on, or is exported before, one that claims
+            // the content, so there always is an origin
+            DedupOrigin origin;
+            if (!_dedup->find(exp.key, origin)) continue;
+
+            if (origin.srcPath == job.filePath && origin.srcOffset == exp.offset) {
+                // Files of split batches are recorded by numberExports()
+                if (batch.split && !_pack) continue;
+
+                if (_results) {
+                    _results->write(job.filePath, exp.filePath, exp.info);
+                }
+
+                if (_manifest && exp.hashed) {
+                    _manifest->add(exp.md5, exp.filePath);
+                }
+
+                continue;
+            }
+
+            if (exp.exported) {
+                if (_pack) {
+                    _pack->remove(job.filePath, exp.offset);
+                } else {
+                    QFile::remove(exp.filePath);
+                }
+
+                exp.exported = false;
+            }
+
+            duplicates++;
+
+            if (_results) {
+                _results->writeDuplicate(job.filePath, exp.info, origin.srcPath, origin.srcOffset);
+            }
+        }
+    }
+
+    return duplicates;
+}
+
+// Give the exports of a split file their final names
+// - Images that failed to export, or weren't exported as duplicates,
+//   still use up their number, as they would have in a single pass
+//
+void BatchCarver::numberExports(const Job &job, std::vector<Export> &exports, const QString &outputDir) {
+    auto index = 1;
+
+    for (const auto &exp : exports) {
+        const auto filePath = outFilePath(outputDir, job.outBaseName, index++);
+        if (!QFile::exists(exp.filePath)) continue;
+
+        QFile::remove(filePath);
+        if (!QFile::rename(exp.filePath, filePath)) {
+            _log.error(QString("Couldn't rename [%1] to [%2]").arg(exp.filePath, filePath));
+            continue;
+        }
+
+        if (_results) {
+            _results->write(job.filePath, filePath, exp.info);
+        }
+
+        if (_manifest && exp.hashed) {
+            _manifest->add(exp.md5, filePath);
+        }
+    }
+}
+
+// Log how many candidates the header check passed, and why it rejected
+// the others
+//
+void BatchCarver::reportHeaderChecks() {
+    if (!LOG_INFO_ON(_log)) return;
+
+    uint64_t counts[HDR_NUM_RESULTS] = {};
+    uint64_t total = 0;
+
+    for (const auto &core : _cores) {
+        if (!core) continue;
+
+        for (auto nResult = 0; nResult < HDR_NUM_RESULTS; nResult++) {
+            const auto count = core->headerCheck().count(static_cast<teHdrCheck>(nResult));
+            counts[nResult] += count;
+            total += count;
+        }
+    }
+
+    if (total == 0) return;
+
+    _log.info(QString("Header check: %1 candidates").arg(total));
+
+    for (auto nResult = 0; nResult < HDR_NUM_RESULTS; nResult++) {
+        if (counts[nResult] == 0) continue;
+
+        _log.info(QString("  %1: %2")
+                      .arg(HeaderCheck::resultName(static_cast<teHdrCheck>(nResult)))
+                      .arg(counts[nResult]));
+    }
+}
+
+// The SnoopCore owned by a worker, created on first use
+//
+SnoopCore &BatchCarver::workerCore(uint32_t nWorker) {
+    auto &core = _cores[nWorker];
+    if (!core) {
+        core = std::make_unique<SnoopCore>(_log, _appConfig);
+    }
+
+    return *core;
+}
+
+// Sort the files and give each one a distinct output prefix
+// - The prefix is the file's base name. A file whose base name is
+//   already taken by an earlier file gets "_2", "_3", ... appended, so
+//   that no two files export to the same names.
+//
+std::vector<BatchCarver::Job> BatchCarver::makeJobs(const QStringList &filePaths) {
+    auto sortedPaths = filePaths;
+    sortedPaths.sort();
+
+    std::vector<Job> jobs;
+    std::set<QString> usedNames;
+
+    for (const auto &filePath : sortedPaths) {
+        const auto baseName = QFileInfo(filePath).baseName();
+
+        auto outBaseName = baseName;
+        for (auto count = 2; usedNames.count(outBaseName) > 0; count++) {
+            outBaseName = QString("%1_%2").arg(baseName).arg(count);
+        }
+
+        usedNames.insert(outBaseName);
+        const QFileInfo info(filePath);
+        jobs.push_back({filePath, outBaseName, info.size(), info.lastModified().toMSecsSinceEpoch()});
+    }
+
+    return jobs;
+}
+
+// Split the files into phase-one work items
+// - Files up to chunkSize bytes (or all files, if chunkSize is 0) make
+//   a single chunk
+//
+std::vector<BatchCarver::Chunk> BatchCarver::makeChunks(const std::vector<Job> &jobs, qint64 chunkSize) {
+    std::vector<Chunk> chunks;
+
+    for (size_t nJob = 0; nJob < jobs.size(); nJob++) {
+        const auto fileSize = static_cast<uint64_t>(qMax<qint64>(jobs[nJob].fileSize, 0));
+
+        if (chunkSize <= 0 || fileSize <= static_cast<uint64_t>(chunkSize)) {
+            chunks.push_back({nJob, 0, fileSize});
+            continue;
+        }
+
+        for (uint64_t start = 0; start < fileSize; start += chunkSize) {
+            chunks.push_back({nJob, start, qMin<uint64_t>(start + chunkSize, fileSize)});
+        }
+    }
+
+    return chunks;
+}
+
+QString BatchCarver::indexFilePath(const QString &indexDir, const QString &outBaseName) {
+    return QDir(indexDir).filePath(QString("%1.cidx").arg(outBaseName));
+}
+
+QString BatchCarver::outFilePath(const QString &outputDir, const QString &outBaseName, int index) {
+    const auto newFileName = QString("%1_%2.jpg")
+        .arg(outBaseName, QString::number(index).rightJustified(4, '0'));
+
+    QDir dir(outputDir);
+    return dir.filePath(newFileName);
+}
@@ -0,0 +1,170 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Carves the JPEG images out of a list of files in two phases
+// - Phase one indexes the candidates (SOI signatures) of every file,
+//   along with its other container signatures, in one pass by SigScan.
+//   Files larger than SnoopConfig::chunkSize() are split into chunks
+//   that are scanned on their own. With an index directory set, the
+//   indexes are saved there and reused by later runs.
+// - Phase two validates and exports the candidates from the index, in
+//   batches of up to CARVE_BATCH candidates
+// - Work in both phases is spread over SnoopConfig::threadCount()
+//   workers by a WorkPool, each worker owning its own SnoopCore (and so
+//   its own WindowBuf, JfifDecode and ImgDecode)
+// - Decoding reads on past the end of a chunk or batch, so images that
+//   cross a boundary are carved whole by the candidate they start at
+// - Output names depend only on the file list, never on which worker
+//   handled a file, chunk or batch, or in what order
+// - With a ResultWriter set, every exported image also gets a record
+//   there, under its final name
+// - With a PackWriter set, images are appended to its pack files
+//   instead of being exported to files of their own
+// - With a HashManifest set, every exported file also gets a line
+//   there with its MD5. Exports then go through memory, and the bytes
+//   are hashed CARVE_HASH_GROUP images at a time by Md5Multi, so the
+//   files are never read back. Images sent to packs get a line under
+//   their "<pack path>@<offset>" location, with the MD5 the pack index
+//   holds for them.
+// - With a KnownHashSet set, images whose MD5 is in it are left out
+//   and only get a result record
+// - With SnoopConfig::dedup(), each distinct image content is exported
+//   once per carve(), and other copies only get a result record. The
+//   copy kept is the earliest in file path and offset order, so it too
+//   depends only on the file list. With SnoopConfig::dedupIdentity()
+//   too, copies that differ only in their metadata count as the same
+//   content.
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_BATCHCARVER_H
+#define JPEGSNOOP_BATCHCARVER_H
+
+#include <QString>
+#include <QStringList>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "CandidateIndex.h"
+#include "DedupSet.h"
+#include "HashManifest.h"
+#include "KnownHashSet.h"
+#include "Md5Multi.h"
+#include "PackWriter.h"
+#include "ResultWriter.h"
+#include "SnoopConfig.h"
+#include "SnoopCore.h"
+#include "log/ILog.h"
+
+// Candidates validated per phase-two work item
+static constexpr size_t CARVE_BATCH = 256;
+
+// Exports a worker holds before hashing them for the manifest. Several
+// per lane keep the lanes busy while images of different sizes finish.
+static constexpr size_t CARVE_HASH_GROUP = 4 * MD5_MULTI_LANES;
+
+class BatchCarver {
+    Q_DISABLE_COPY(BatchCarver)
+public:
+    BatchCarver(ILog &log, SnoopConfig &appConfig);
+
+    void setResultWriter(ResultWriter *results);
+    void setPackWriter(PackWriter *pack);
+    void setKnownHashSet(const KnownHashSet *known);
+    void setHashManifest(HashManifest *manifest);
+    void setIndexDir(const QString &indexDir);
+
+    void run(const QStringList &filePaths, const QString &outputDir);
+
+    std::vector<CandidateIndex> buildIndex(const QStringList &filePaths);
+    void carve(const std::vector<CandidateIndex> &indexes, const QString &outputDir);
+
+private:
+    struct Job {
+        QString filePath;
+        QString outBaseName;    // Prefix of the exported file names
+        qint64 fileSize;
+        qint64 fileModified;    // Milliseconds since the epoch
+    };
+
+    struct Chunk {
+        size_t job;             // Index into the job list
+        uint64_t start;         // First candidate position (inclusive)
+        uint64_t end;           // End of the candidate range (exclusive)
+    };
+
+    struct Batch {
+        size_t job;             // Index into the job list
+        size_t first;           // First candidate in the job's index
+        size_t last;            // One past the last candidate
+        bool split;             // The file is carved in several batches
+    };
+
+    struct Export {
+        uint64_t offset;        // File position of the image
+        QString filePath;       // Where it was exported to
+        ImageInfo info;         // Analysis, kept for the result record
+        bool hashed = false;    // md5 is set, for the manifest
+        uint8_t md5[16] = {};
+        bool keyed = false;     // A copy left to resolveDuplicates()
+        bool exported = false;  // If keyed: written (else left out for an earlier copy)
+        ContentKey key = {};    // If keyed: the image's content
+    };
+
+    struct HashJob {
+        QByteArray data;        // The exported bytes
+        QString filePath;       // Where they were written
+        size_t exportIndex;     // Entry in the batch's exports, or SIZE_MAX
+    };
+
+    void scanChunk(SnoopCore &core, const Job &job, const Chunk &chunk, CandidateIndex &index);
+    void carveBatch(SnoopCore &core, const Job &job, const CandidateIndex &index, const Batch &batch,
+                    const QString &outputDir, std::vector<Export> &exports);
+    void hashExports(std::vector<HashJob> &hashJobs, size_t nCount, std::vector<Export> &exports);
+    uint64_t resolveDuplicates(const std::vector<Job> &jobs, const std::vector<Batch> &batches,
+                               std::vector<std::vector<Export>> &exports);
+    void numberExports(const Job &job, std::vector<Export> &exports, const QString &outputDir);
+    void reportHeaderChecks();
+
+    SnoopCore &workerCore(uint32_t nWorker);
+
+    static std::vector<Job> makeJobs(const QStringList &filePaths);
+    static std::vector<Chunk> makeChunks(const std::vector<Job> &jobs, qint64 chunkSize);
+    static QString indexFilePath(const QString &indexDir, const QString &outBaseName);
+    static QString outFilePath(const QString &outputDir, const QString &outBaseName, int index);
+
+    ILog &_log;
+    SnoopConfig &_appConfig;
+    ResultWriter *_results = nullptr;
+    PackWriter *_pack = nullptr;
+    const KnownHashSet *_known = nullptr;
+    HashManifest *_manifest = nullptr;
+    QString _indexDir;                                // Where indexes are kept between runs (if set)
+    std::atomic<uint64_t> _knownSkipped{0};           // Images left out as known files
+    std::unique_ptr<DedupSet> _dedup;                 // Contents carved in this run (with dedup())
+
+    std::vector<std::unique_ptr<SnoopCore>> _cores;   // One per worker, created on first use
+};
+
+#endif
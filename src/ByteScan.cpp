@@ -0,0 +1,400 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstring>
+
+#include "ByteScan.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BYTESCAN_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef BYTESCAN_SSE2
+// Index of the most significant set bit (nMask must be non-zero)
+static inline uint32_t HighBit(uint32_t nMask) {
+#if defined(_MSC_VER)
+    unsigned long nInd;
+    _BitScanReverse(&nInd, nMask);
+    return nInd;
+#else
+    return 31 - __builtin_clz(nMask);
+#endif
+}
+
+// Index of the least significant set bit (nMask must be non-zero)
+static inline uint32_t LowBit(uint32_t nMask) {
+#if defined(_MSC_VER)
+    unsigned long nInd;
+    _BitScanForward(&nInd, nMask);
+    return nInd;
+#else
+    return __builtin_ctz(nMask);
+#endif
+}
+#endif
+
+size_t ScanByteFwd(const uint8_t *pBuf, size_t nLen, uint8_t nVal) {
+    // The C library memchr() is already vectorized on all of our targets
+    const auto pHit = static_cast<const uint8_t *>(memchr(pBuf, nVal, nLen));
+    return pHit ? static_cast<size_t>(pHit - pBuf) : nLen;
+}
+
+size_t ScanByteRev(const uint8_t *pBuf, size_t nLen, uint8_t nVal) {
+    size_t nEnd = nLen;
+
+#ifdef BYTESCAN_SSE2
+    const __m128i vNeedle = _mm_set1_epi8(static_cast<char>(nVal));
+
+    while (nEnd >= 16) {
+        const __m128i vBlk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nEnd - 16));
+        const auto nMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(vBlk, vNeedle)));
+
+        if (nMask) {
+            return nEnd - 16 + HighBit(nMask);
+        }
+
+        nEnd -= 16;
+    }
+#endif
+
+    while (nEnd > 0) {
+        nEnd--;
+
+        if (pBuf[nEnd] == nVal) {
+            return nEnd;
+        }
+    }
+
+    return nLen;
+}
+
+// Classify the 0xFF at pBuf[nPos], whose next byte must be in the buffer
+//
+// RETURN:
+// - true if it starts a marker
+//
+static inline bool EcsMarkerAt(const uint8_t *pBuf, size_t nPos, uint64_t nBase, std::vector<uint64_t> *pRstPos) {
+    const auto nCode = pBuf[nPos + 1];
+
+    if (nCode == 0x00) {
+        // Byte stuffing
+        return false;
+    }
+
+    if ((nCode >= 0xD0) && (nCode <= 0xD7)) {
+        // Restart marker
+        if (pRstPos) {
+            pRstPos->push_back(nBase + nPos);
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+bool ScanMarkerFwd(const uint8_t *pBuf, size_t nLen, size_t &nInd, uint64_t nBase, std::vector<uint64_t> *pRstPos) {
+    // Every 0xFF before nLast has its next byte in the buffer
+    const size_t nLast = nLen > 0 ? nLen - 1 : 0;
+    size_t nPos = 0;
+
+#ifdef BYTESCAN_SSE2
+    const __m128i vFF = _mm_set1_epi8(static_cast<char>(0xFF));
+
+    while (nPos + 16 <= nLast) {
+        const __m128i vBlk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nPos));
+        auto nMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(vBlk, vFF)));
+
+        while (nMask) {
+            const auto nHit = nPos + LowBit(nMask);
+            nMask &= nMask - 1;
+
+            if (EcsMarkerAt(pBuf, nHit, nBase, pRstPos)) {
+                nInd = nHit;
+                return true;
+            }
+        }
+
+        nPos += 16;
+    }
+#endif
+
+    while (nPos < nLast) {
+        nPos += ScanByteFwd(pBuf + nPos, nLast - nPos, 0xFF);
+        if (nPos >= nLast) break;
+
+        if (EcsMarkerAt(pBuf, nPos, nBase, pRstPos)) {
+            nInd = nPos;
+            return true;
+        }
+
+        nPos++;
+    }
+
+    nInd = (nLen > 0 && pBuf[nLast] == 0xFF) ? nLast : nLen;
+    return false;
+}
+
+SearchPattern::SearchPattern(const uint8_t *anVal, uint32_t nLen) :
+    _pattern(anVal, anVal + nLen) {
+
+    if (nLen <= SEARCH_SHORT_MAX) return;
+
+    // Horspool shift tables. Forward alignment is on the last byte,
+    // reverse alignment is on the first byte.
+    _skipFwd.assign(256, nLen);
+    _skipRev.assign(256, nLen);
+
+    for (uint32_t nInd = 0; nInd + 1 < nLen; nInd++) {
+        _skipFwd[anVal[nInd]] = nLen - 1 - nInd;
+    }
+
+    for (uint32_t nInd = nLen - 1; nInd > 0; nInd--) {
+        _skipRev[anVal[nInd]] = nInd;
+    }
+}
+
+size_t SearchPattern::findFwd(const uint8_t *pBuf, size_t nLen) const {
+    if (_pattern.empty() || nLen < _pattern.size()) return nLen;
+
+    if (_pattern.size() == 1) return ScanByteFwd(pBuf, nLen, _pattern[0]);
+
+    return _skipFwd.empty() ? findShortFwd(pBuf, nLen) : findLongFwd(pBuf, nLen);
+}
+
+size_t SearchPattern::findRev(const uint8_t *pBuf, size_t nLen) const {
+    if (_pattern.empty() || nLen < _pattern.size()) return nLen;
+
+    if (_pattern.size() == 1) return ScanByteRev(pBuf, nLen, _pattern[0]);
+
+    return _skipRev.empty() ? findShortRev(pBuf, nLen) : findLongRev(pBuf, nLen);
+}
+
+// Filter candidates on both the first and the last pattern byte, 16
+// positions at a time, and only compare the middle for survivors
+//
+size_t SearchPattern::findShortFwd(const uint8_t *pBuf, size_t nLen) const {
+    const size_t nPatLen = _pattern.size();
+    const size_t nLast = nLen - nPatLen;    // Last valid start index
+    const uint8_t nFirstVal = _pattern[0];
+    const uint8_t nLastVal = _pattern[nPatLen - 1];
+
+    size_t nPos = 0;
+
+#ifdef BYTESCAN_SSE2
+    const __m128i vFirst = _mm_set1_epi8(static_cast<char>(nFirstVal));
+    const __m128i vLast = _mm_set1_epi8(static_cast<char>(nLastVal));
+
+    while (nPos + 16 <= nLast + 1) {
+        const __m128i vBlkFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nPos));
+        const __m128i vBlkLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nPos + nPatLen - 1));
+        auto nMask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(vBlkFirst, vFirst), _mm_cmpeq_epi8(vBlkLast, vLast))));
+
+        while (nMask) {
+            const auto nCand = nPos + LowBit(nMask);
+
+            if (memcmp(pBuf + nCand + 1, _pattern.data() + 1, nPatLen - 2) == 0) {
+                return nCand;
+            }
+
+            nMask &= nMask - 1;
+        }
+
+        nPos += 16;
+    }
+#endif
+
+    while (nPos <= nLast) {
+        // Jump to the next occurrence of the first byte
+        nPos += ScanByteFwd(pBuf + nPos, nLast + 1 - nPos, nFirstVal);
+        if (nPos > nLast) break;
+
+        if (pBuf[nPos + nPatLen - 1] == nLastVal &&
+            memcmp(pBuf + nPos + 1, _pattern.data() + 1, nPatLen - 2) == 0) {
+            return nPos;
+        }
+
+        nPos++;
+    }
+
+    return nLen;
+}
+
+size_t SearchPattern::findShortRev(const uint8_t *pBuf, size_t nLen) const {
+    const size_t nPatLen = _pattern.size();
+    const uint8_t nFirstVal = _pattern[0];
+    const uint8_t nLastVal = _pattern[nPatLen - 1];
+
+    // Candidate start indices still to be examined are [0,nEnd)
+    size_t nEnd = nLen - nPatLen + 1;
+
+#ifdef BYTESCAN_SSE2
+    const __m128i vFirst = _mm_set1_epi8(static_cast<char>(nFirstVal));
+    const __m128i vLast = _mm_set1_epi8(static_cast<char>(nLastVal));
+
+    while (nEnd >= 16) {
+        const auto nBase = nEnd - 16;
+        const __m128i vBlkFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nBase));
+        const __m128i vBlkLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nBase + nPatLen - 1));
+        auto nMask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(vBlkFirst, vFirst), _mm_cmpeq_epi8(vBlkLast, vLast))));
+
+        while (nMask) {
+            const auto nBit = HighBit(nMask);
+            const auto nCand = nBase + nBit;
+
+            if (memcmp(pBuf + nCand + 1, _pattern.data() + 1, nPatLen - 2) == 0) {
+                return nCand;
+            }
+
+            nMask &= ~(1u << nBit);
+        }
+
+        nEnd = nBase;
+    }
+#endif
+
+    while (nEnd > 0) {
+        const auto nCand = ScanByteRev(pBuf, nEnd, nFirstVal);
+        if (nCand >= nEnd) break;
+
+        if (pBuf[nCand + nPatLen - 1] == nLastVal &&
+            memcmp(pBuf + nCand + 1, _pattern.data() + 1, nPatLen - 2) == 0) {
+            return nCand;
+        }
+
+        nEnd = nCand;
+    }
+
+    return nLen;
+}
+
+size_t SearchPattern::findLongFwd(const uint8_t *pBuf, size_t nLen) const {
+    const size_t nPatLen = _pattern.size();
+    const size_t nLast = nLen - nPatLen;
+    const uint8_t nLastVal = _pattern[nPatLen - 1];
+
+    size_t nPos = 0;
+
+    while (nPos <= nLast) {
+        const uint8_t nVal = pBuf[nPos + nPatLen - 1];
+
+        if (nVal == nLastVal && memcmp(pBuf + nPos, _pattern.data(), nPatLen - 1) == 0) {
+            return nPos;
+        }
+
+        nPos += _skipFwd[nVal];
+    }
+
+    return nLen;
+}
+
+size_t SearchPattern::findLongRev(const uint8_t *pBuf, size_t nLen) const {
+    const size_t nPatLen = _pattern.size();
+    const uint8_t nFirstVal = _pattern[0];
+
+    size_t nPos = nLen - nPatLen;
+
+    while (true) {
+        const uint8_t nVal = pBuf[nPos];
+
+        if (nVal == nFirstVal && memcmp(pBuf + nPos + 1, _pattern.data() + 1, nPatLen - 1) == 0) {
+            return nPos;
+        }
+
+        const auto nSkip = _skipRev[nVal];
+        if (nPos < nSkip) break;
+
+        nPos -= nSkip;
+    }
+
+    return nLen;
+}
+
+void MultiPattern::add(const uint8_t *anVal, uint32_t nLen, uint32_t nId) {
+    if (nLen == 0) return;
+
+    _patterns.emplace_back(anVal, anVal + nLen);
+    _ids.push_back(nId);
+    _firstByte[anVal[0]] = true;
+
+    _minLen = (_minLen == 0 || nLen < _minLen) ? nLen : _minLen;
+    _maxLen = nLen > _maxLen ? nLen : _maxLen;
+}
+
+// Compare every pattern at a single candidate position
+//
+void MultiPattern::matchAt(const uint8_t *pBuf, size_t nLen, size_t nPos, uint64_t nBase, std::vector<PatternHit> &hits) const {
+    for (size_t nInd = 0; nInd < _patterns.size(); nInd++) {
+        const auto &pattern = _patterns[nInd];
+
+        if (nPos + pattern.size() <= nLen && memcmp(pBuf + nPos, pattern.data(), pattern.size()) == 0) {
+            hits.push_back({nBase + nPos, _ids[nInd]});
+        }
+    }
+}
+
+void MultiPattern::findAll(const uint8_t *pBuf, size_t nLen, size_t nCandEnd, uint64_t nBase, std::vector<PatternHit> &hits) const {
+    if (_patterns.empty()) return;
+    if (nCandEnd > nLen) nCandEnd = nLen;
+
+    size_t nPos = 0;
+
+#ifdef BYTESCAN_SSE2
+    if (_minLen >= 2) {
+        // Two-byte prefixes of every pattern
+        std::vector<__m128i> vFirst;
+        std::vector<__m128i> vSecond;
+        for (const auto &pattern: _patterns) {
+            vFirst.push_back(_mm_set1_epi8(static_cast<char>(pattern[0])));
+            vSecond.push_back(_mm_set1_epi8(static_cast<char>(pattern[1])));
+        }
+
+        while (nPos + 16 <= nCandEnd && nPos + 17 <= nLen) {
+            const __m128i vBlk0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nPos));
+            const __m128i vBlk1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBuf + nPos + 1));
+
+            __m128i vAny = _mm_setzero_si128();
+            for (size_t nInd = 0; nInd < vFirst.size(); nInd++) {
+                vAny = _mm_or_si128(vAny, _mm_and_si128(_mm_cmpeq_epi8(vBlk0, vFirst[nInd]),
+                                                        _mm_cmpeq_epi8(vBlk1, vSecond[nInd])));
+            }
+
+            auto nMask = static_cast<uint32_t>(_mm_movemask_epi8(vAny));
+            while (nMask) {
+                matchAt(pBuf, nLen, nPos + LowBit(nMask), nBase, hits);
+                nMask &= nMask - 1;
+            }
+
+            nPos += 16;
+        }
+    }
+#endif
+
+    for (; nPos < nCandEnd; nPos++) {
+        if (_firstByte[pBuf[nPos]]) {
+            matchAt(pBuf, nLen, nPos, nBase, hits);
+        }
+    }
+}
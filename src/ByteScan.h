@@ -0,0 +1,146 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// DESCRIPTION:
+// - Low-level scanning primitives over contiguous memory
+// - Used by the buffer search routines to skip quickly over bytes
+//   that cannot start a match
+// - Precompiled byte patterns for repeated multi-byte searches
+// - Multi-pattern matching for single-pass signature scans
+// - Uses SSE2 where available and falls back to portable code
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_BYTESCAN_H
+#define JPEGSNOOP_BYTESCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Patterns longer than this use Boyer-Moore-Horspool skipping,
+// shorter ones use a first/last byte filter
+static constexpr uint32_t SEARCH_SHORT_MAX = 16;
+
+// Find the first occurrence of a byte value
+//
+// RETURN:
+// - Index of the first match in [0,nLen), or nLen if there is none
+//
+size_t ScanByteFwd(const uint8_t *pBuf, size_t nLen, uint8_t nVal);
+
+// Find the last occurrence of a byte value
+//
+// RETURN:
+// - Index of the last match in [0,nLen), or nLen if there is none
+//
+size_t ScanByteRev(const uint8_t *pBuf, size_t nLen, uint8_t nVal);
+
+// Find the first marker in JPEG entropy-coded data
+// - A 0xFF followed by 0x00 (byte stuffing) or by 0xD0..0xD7 (RSTn) is
+//   part of the scan data. Any other 0xFF starts a marker.
+// - Only a 0xFF with its next byte in the buffer can be classified
+//
+// INPUT:
+// - nBase                      File position of pBuf[0]
+//
+// OUTPUT:
+// - nInd                       Index of the marker's 0xFF if found,
+//                              otherwise where to resume the scan (nLen,
+//                              or nLen-1 if the last byte is a 0xFF)
+// - pRstPos                    If not null, file positions of the RSTn
+//                              markers passed are appended
+//
+// RETURN:
+// - Whether a marker was found
+//
+bool ScanMarkerFwd(const uint8_t *pBuf, size_t nLen, size_t &nInd, uint64_t nBase, std::vector<uint64_t> *pRstPos);
+
+// A byte pattern compiled for repeated searching in either direction
+// - Compile once and reuse the object across searches
+//
+class SearchPattern final {
+public:
+    SearchPattern(const uint8_t *anVal, uint32_t nLen);
+
+    uint32_t length() const { return static_cast<uint32_t>(_pattern.size()); }
+    const uint8_t *data() const { return _pattern.data(); }
+
+    // Find the first / last match that lies entirely within [0,nLen)
+    //
+    // RETURN:
+    // - Index of the start of the match, or nLen if there is none
+    //
+    size_t findFwd(const uint8_t *pBuf, size_t nLen) const;
+    size_t findRev(const uint8_t *pBuf, size_t nLen) const;
+
+private:
+    size_t findShortFwd(const uint8_t *pBuf, size_t nLen) const;
+    size_t findShortRev(const uint8_t *pBuf, size_t nLen) const;
+    size_t findLongFwd(const uint8_t *pBuf, size_t nLen) const;
+    size_t findLongRev(const uint8_t *pBuf, size_t nLen) const;
+
+    std::vector<uint8_t> _pattern;
+    std::vector<uint32_t> _skipFwd;     // BMH shift keyed on the byte under the pattern end
+    std::vector<uint32_t> _skipRev;     // BMH shift keyed on the byte under the pattern start
+};
+
+// A match reported by MultiPattern
+struct PatternHit {
+    uint64_t nPos;                // Absolute position of the match start
+    uint32_t nId;                 // Identifier given to MultiPattern::add()
+};
+
+// A set of byte patterns matched together in one pass
+// - Candidates are filtered 16 positions at a time on the first two
+//   bytes of every pattern, and only survivors are compared in full
+//
+class MultiPattern final {
+public:
+    MultiPattern() = default;
+
+    void add(const uint8_t *anVal, uint32_t nLen, uint32_t nId);
+
+    bool isEmpty() const { return _patterns.empty(); }
+    uint32_t minLength() const { return _minLen; }
+    uint32_t maxLength() const { return _maxLen; }
+
+    uint32_t length(uint32_t nInd) const { return static_cast<uint32_t>(_patterns[nInd].size()); }
+    const uint8_t *data(uint32_t nInd) const { return _patterns[nInd].data(); }
+    uint32_t id(uint32_t nInd) const { return _ids[nInd]; }
+    uint32_t count() const { return static_cast<uint32_t>(_patterns.size()); }
+
+    // Report every match that starts in [0,nCandEnd) and lies entirely
+    // within [0,nLen). Hits are appended in position order with nBase
+    // added to each position.
+    void findAll(const uint8_t *pBuf, size_t nLen, size_t nCandEnd, uint64_t nBase, std::vector<PatternHit> &hits) const;
+
+private:
+    void matchAt(const uint8_t *pBuf, size_t nLen, size_t nPos, uint64_t nBase, std::vector<PatternHit> &hits) const;
+
+    std::vector<std::vector<uint8_t>> _patterns;
+    std::vector<uint32_t> _ids;
+    bool _firstByte[256] = {};    // Possible leading bytes
+    uint32_t _minLen = 0;
+    uint32_t _maxLen = 0;
+};
+
+#endif
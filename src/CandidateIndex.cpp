@@ -0,0 +1,268 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "CandidateIndex.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <cstring>
+
+static const char INDEX_MAGIC[8] = {'J', 'S', 'N', 'P', 'C', 'I', 'D', 'X'};
+static const uint32_t INDEX_VERSION = 2;
+
+// Append an unsigned value as a little-endian base-128 varint
+//
+static void PutVarint(std::vector<uint8_t> &buf, uint64_t nVal) {
+    while (nVal >= 0x80) {
+        buf.push_back(static_cast<uint8_t>(nVal | 0x80));
+        nVal >>= 7;
+    }
+
+    buf.push_back(static_cast<uint8_t>(nVal));
+}
+
+// Read a varint written by PutVarint()
+//
+// RETURN:
+// - Success (FALSE if the buffer ends first or the value overflows)
+//
+static bool GetVarint(const uint8_t *&pBuf, const uint8_t *pEnd, uint64_t &nVal) {
+    nVal = 0;
+
+    for (uint32_t nShift = 0; nShift < 64; nShift += 7) {
+        if (pBuf >= pEnd) return false;
+
+        const auto nByte = *pBuf++;
+        nVal |= static_cast<uint64_t>(nByte & 0x7F) << nShift;
+
+        if ((nByte & 0x80) == 0) return true;
+    }
+
+    return false;
+}
+
+// Positions are stored as gaps from the previous one
+//
+static void PutPositions(std::vector<uint8_t> &buf, const std::vector<uint64_t> &positions) {
+    PutVarint(buf, positions.size());
+
+    uint64_t nLast = 0;
+    for (const auto nPos : positions) {
+        PutVarint(buf, nPos - nLast);
+        nLast = nPos;
+    }
+}
+
+static bool GetPositions(const uint8_t *&pBuf, const uint8_t *pEnd, std::vector<uint64_t> &positions) {
+    uint64_t nCount;
+    if (!GetVarint(pBuf, pEnd, nCount)) return false;
+
+    // Every position takes at least one byte
+    if (nCount > static_cast<uint64_t>(pEnd - pBuf)) return false;
+
+    positions.clear();
+    positions.reserve(nCount);
+
+    uint64_t nPos = 0;
+    for (uint64_t nInd = 0; nInd < nCount; nInd++) {
+        uint64_t nGap;
+        if (!GetVarint(pBuf, pEnd, nGap)) return false;
+
+        nPos += nGap;
+        positions.push_back(nPos);
+    }
+
+    return true;
+}
+
+// Container signatures are stored as their positions, then one type
+// byte each
+//
+static void PutContainers(std::vector<uint8_t> &buf, const std::vector<SigCandidate> &containers) {
+    std::vector<uint64_t> positions;
+    positions.reserve(containers.size());
+
+    for (const auto &cand : containers) {
+        positions.push_back(cand.nPos);
+    }
+
+    PutPositions(buf, positions);
+
+    for (const auto &cand : containers) {
+        buf.push_back(static_cast<uint8_t>(cand.eType));
+    }
+}
+
+static bool GetContainers(const uint8_t *&pBuf, const uint8_t *pEnd, std::vector<SigCandidate> &containers) {
+    std::vector<uint64_t> positions;
+    if (!GetPositions(pBuf, pEnd, positions)) return false;
+    if (positions.size() > static_cast<uint64_t>(pEnd - pBuf)) return false;
+
+    containers.clear();
+    containers.reserve(positions.size());
+
+    for (const auto nPos : positions) {
+        const auto nType = *pBuf++;
+        if (nType > SIG_T_JPEG_EOI) return false;
+
+        containers.push_back({nPos, static_cast<teSigType>(nType)});
+    }
+
+    return true;
+}
+
+CandidateIndex::CandidateIndex(const QString &filePath, qint64 fileSize, qint64 fileModified) :
+    _filePath(filePath),
+    _fileSize(fileSize),
+    _fileModified(fileModified) {
+}
+
+// Is there a container signature of a type at a position?
+//
+bool CandidateIndex::hasContainer(teSigType eType, uint64_t nPos) const {
+    const auto it = std::lower_bound(_containers.begin(), _containers.end(), nPos,
+                                     [](const SigCandidate &cand, uint64_t nVal) { return cand.nPos < nVal; });
+
+    for (auto itCur = it; itCur != _containers.end() && itCur->nPos == nPos; ++itCur) {
+        if (itCur->eType == eType) return true;
+    }
+
+    return false;
+}
+
+// Record the candidates that start in a range of the file
+// - Ranges must be scanned in increasing order
+//
+// INPUT:
+// - sigScan                    Scanner of the buffer attached to the indexed file
+// - nStartPos                  First candidate position (inclusive)
+// - nEndPos                    End of the candidate range (exclusive)
+// - bEoi                       Also record EOI markers
+//
+void CandidateIndex::scan(SigScan &sigScan, uint64_t nStartPos, uint64_t nEndPos, bool bEoi) {
+    _eoiIndexed = _eoiIndexed || bEoi;
+
+    for (const auto &cand : sigScan.scan(nStartPos, nEndPos, bEoi)) {
+        switch (cand.eType) {
+            case SIG_T_JPEG:
+                _soi.push_back(cand.nPos);
+                break;
+
+            case SIG_T_JPEG_EOI:
+                _eoi.push_back(cand.nPos);
+                break;
+
+            default:
+                _containers.push_back(cand);
+                break;
+        }
+    }
+}
+
+// Add a candidate that was not found by scan() (eg. the start of the file)
+//
+void CandidateIndex::addSoi(uint64_t nPos) {
+    const auto it = std::lower_bound(_soi.begin(), _soi.end(), nPos);
+    if (it != _soi.end() && *it == nPos) return;
+
+    _soi.insert(it, nPos);
+}
+
+// Append the candidates of a later range of the same file
+//
+void CandidateIndex::append(const CandidateIndex &other) {
+    _soi.insert(_soi.end(), other._soi.begin(), other._soi.end());
+    _eoi.insert(_eoi.end(), other._eoi.begin(), other._eoi.end());
+    _containers.insert(_containers.end(), other._containers.begin(), other._containers.end());
+    _eoiIndexed = _eoiIndexed || other._eoiIndexed;
+}
+
+void CandidateIndex::clear() {
+    _soi.clear();
+    _eoi.clear();
+    _containers.clear();
+}
+
+// Write the index to disk
+//
+// RETURN:
+// - Success in writing the whole index
+//
+bool CandidateIndex::save(const QString &indexPath) const {
+    std::vector<uint8_t> buf(INDEX_MAGIC, INDEX_MAGIC + sizeof(INDEX_MAGIC));
+
+    PutVarint(buf, INDEX_VERSION);
+    PutVarint(buf, static_cast<uint64_t>(_fileSize));
+    PutVarint(buf, static_cast<uint64_t>(_fileModified));
+    PutVarint(buf, _eoiIndexed ? 1 : 0);
+
+    const auto path = _filePath.toUtf8();
+    PutVarint(buf, static_cast<uint64_t>(path.size()));
+    buf.insert(buf.end(), path.constData(), path.constData() + path.size());
+
+    PutPositions(buf, _soi);
+    PutPositions(buf, _eoi);
+    PutContainers(buf, _containers);
+
+    QFile file(indexPath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    const auto nSize = static_cast<qint64>(buf.size());
+    return file.write(reinterpret_cast<const char *>(buf.data()), nSize) == nSize;
+}
+
+// Read an index written by save()
+// - On failure the index is left empty
+//
+// RETURN:
+// - Success in reading a complete index
+//
+bool CandidateIndex::load(const QString &indexPath) {
+    *this = CandidateIndex();
+
+    QFile file(indexPath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    const auto data = file.readAll();
+    auto pBuf = reinterpret_cast<const uint8_t *>(data.constData());
+    const auto pEnd = pBuf + data.size();
+
+    if (data.size() < static_cast<int>(sizeof(INDEX_MAGIC)) || memcmp(pBuf, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) return false;
+    pBuf += sizeof(INDEX_MAGIC);
+
+    uint64_t nVersion, nFileSize, nFileModified, nEoiIndexed, nPathLen;
+    if (!GetVarint(pBuf, pEnd, nVersion) || nVersion != INDEX_VERSION) return false;
+    if (!GetVarint(pBuf, pEnd, nFileSize)) return false;
+    if (!GetVarint(pBuf, pEnd, nFileModified)) return false;
+    if (!GetVarint(pBuf, pEnd, nEoiIndexed)) return false;
+    if (!GetVarint(pBuf, pEnd, nPathLen) || nPathLen > static_cast<uint64_t>(pEnd - pBuf)) return false;
+
+    CandidateIndex index(QString::fromUtf8(reinterpret_cast<const char *>(pBuf), static_cast<int>(nPathLen)),
+                         static_cast<qint64>(nFileSize), static_cast<qint64>(nFileModified));
+    index._eoiIndexed = nEoiIndexed != 0;
+    pBuf += nPathLen;
+
+    if (!GetPositions(pBuf, pEnd, index._soi)) return false;
+    if (!GetPositions(pBuf, pEnd, index._eoi)) return false;
+    if (!GetContainers(pBuf, pEnd, index._containers)) return false;
+
+    *this = std::move(index);
+
+    return true;
+}
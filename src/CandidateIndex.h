@@ -0,0 +1,78 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Records where images may start (SOI signatures) and, optionally,
+//   end (EOI markers) in one file, found in a single sequential pass
+//   by a SigScan
+// - The other container signatures (AVI, PSD, TIFF, PDF) found by the
+//   same pass are kept too
+// - Lets carving validate candidates later, in any order and as often
+//   as needed, without scanning the file again
+// - Saved to disk as delta-encoded varints, which typically take one
+//   or two bytes per position. The file's size and modification time
+//   are saved along, so that a stale index can be told apart.
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_CANDIDATEINDEX_H
+#define JPEGSNOOP_CANDIDATEINDEX_H
+
+#include <QString>
+
+#include <vector>
+
+#include "SigScan.h"
+
+class CandidateIndex {
+public:
+    CandidateIndex() = default;
+    CandidateIndex(const QString &filePath, qint64 fileSize, qint64 fileModified = 0);
+
+    const QString &filePath() const { return _filePath; }
+    qint64 fileSize() const { return _fileSize; }
+    qint64 fileModified() const { return _fileModified; }
+    bool eoiIndexed() const { return _eoiIndexed; }
+
+    const std::vector<uint64_t> &soi() const { return _soi; }
+    const std::vector<uint64_t> &eoi() const { return _eoi; }
+    const std::vector<SigCandidate> &containers() const { return _containers; }
+    bool hasContainer(teSigType eType, uint64_t nPos) const;
+
+    void scan(SigScan &sigScan, uint64_t nStartPos, uint64_t nEndPos, bool bEoi);
+    void addSoi(uint64_t nPos);
+    void append(const CandidateIndex &other);
+    void clear();
+
+    bool save(const QString &indexPath) const;
+    bool load(const QString &indexPath);
+
+private:
+    QString _filePath;
+    qint64 _fileSize = 0;
+    qint64 _fileModified = 0;       // Milliseconds since the epoch
+    bool _eoiIndexed = false;       // scan() recorded EOI markers
+    std::vector<uint64_t> _soi;     // Sorted SOI signature positions
+    std::vector<uint64_t> _eoi;     // Sorted EOI marker positions (if indexed)
+    std::vector<SigCandidate> _containers;  // Sorted non-JPEG signatures
+};
+
+#endif
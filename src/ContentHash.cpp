@@ -0,0 +1,159 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ContentHash.h"
+
+#include <cstring>
+
+static constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t Rotl64(uint64_t nVal, uint32_t nBits) {
+    return (nVal << nBits) | (nVal >> (64 - nBits));
+}
+
+// Unaligned little-endian reads (the hash is only compared within a run,
+// so big-endian hosts merely get different values)
+static inline uint64_t Read64(const uint8_t *pData) {
+    uint64_t nVal;
+    memcpy(&nVal, pData, sizeof(nVal));
+    return nVal;
+}
+
+static inline uint32_t Read32(const uint8_t *pData) {
+    uint32_t nVal;
+    memcpy(&nVal, pData, sizeof(nVal));
+    return nVal;
+}
+
+static inline uint64_t XxhRound(uint64_t nAcc, uint64_t nInput) {
+    nAcc += nInput * XXH_PRIME64_2;
+    nAcc = Rotl64(nAcc, 31);
+    return nAcc * XXH_PRIME64_1;
+}
+
+static inline uint64_t XxhMerge(uint64_t nAcc, uint64_t nVal) {
+    nAcc ^= XxhRound(0, nVal);
+    return nAcc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+ContentHash::ContentHash(uint64_t nSeed) {
+    reset(nSeed);
+}
+
+void ContentHash::reset(uint64_t nSeed) {
+    _seed = nSeed;
+    _acc[0] = nSeed + XXH_PRIME64_1 + XXH_PRIME64_2;
+    _acc[1] = nSeed + XXH_PRIME64_2;
+    _acc[2] = nSeed;
+    _acc[3] = nSeed - XXH_PRIME64_1;
+    _total = 0;
+    _memSize = 0;
+}
+
+// Add the next bytes to the hash
+//
+void ContentHash::update(const uint8_t *pData, size_t nLen) {
+    _total += nLen;
+
+    // Complete a stripe left over from the previous update
+    if (_memSize > 0) {
+        const auto nFill = nLen < 32 - _memSize ? nLen : 32 - _memSize;
+        memcpy(_mem + _memSize, pData, nFill);
+        _memSize += static_cast<uint32_t>(nFill);
+        pData += nFill;
+        nLen -= nFill;
+
+        if (_memSize < 32) return;
+
+        for (uint32_t nLane = 0; nLane < 4; nLane++) {
+            _acc[nLane] = XxhRound(_acc[nLane], Read64(_mem + nLane * 8));
+        }
+
+        _memSize = 0;
+    }
+
+    while (nLen >= 32) {
+        _acc[0] = XxhRound(_acc[0], Read64(pData));
+        _acc[1] = XxhRound(_acc[1], Read64(pData + 8));
+        _acc[2] = XxhRound(_acc[2], Read64(pData + 16));
+        _acc[3] = XxhRound(_acc[3], Read64(pData + 24));
+        pData += 32;
+        nLen -= 32;
+    }
+
+    if (nLen > 0) {
+        memcpy(_mem, pData, nLen);
+        _memSize = static_cast<uint32_t>(nLen);
+    }
+}
+
+// Hash of the bytes added so far
+// - Doesn't end the hash, so more bytes can still be added
+//
+uint64_t ContentHash::digest() const {
+    uint64_t nHash;
+
+    if (_total >= 32) {
+        nHash = Rotl64(_acc[0], 1) + Rotl64(_acc[1], 7) + Rotl64(_acc[2], 12) + Rotl64(_acc[3], 18);
+        for (uint32_t nLane = 0; nLane < 4; nLane++) {
+            nHash = XxhMerge(nHash, _acc[nLane]);
+        }
+    } else {
+        nHash = _seed + XXH_PRIME64_5;
+    }
+
+    nHash += _total;
+
+    auto pData = _mem;
+    auto nLen = _memSize;
+
+    for (; nLen >= 8; pData += 8, nLen -= 8) {
+        nHash ^= XxhRound(0, Read64(pData));
+        nHash = Rotl64(nHash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+
+    if (nLen >= 4) {
+        nHash ^= static_cast<uint64_t>(Read32(pData)) * XXH_PRIME64_1;
+        nHash = Rotl64(nHash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        pData += 4;
+        nLen -= 4;
+    }
+
+    for (; nLen > 0; pData++, nLen--) {
+        nHash ^= *pData * XXH_PRIME64_5;
+        nHash = Rotl64(nHash, 11) * XXH_PRIME64_1;
+    }
+
+    nHash ^= nHash >> 33;
+    nHash *= XXH_PRIME64_2;
+    nHash ^= nHash >> 29;
+    nHash *= XXH_PRIME64_3;
+    nHash ^= nHash >> 32;
+
+    return nHash;
+}
+
+uint64_t ContentHash::hash(const uint8_t *pData, size_t nLen, uint64_t nSeed) {
+    ContentHash hasher(nSeed);
+    hasher.update(pData, nLen);
+    return hasher.digest();
+}
@@ -0,0 +1,68 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Fast non-cryptographic hash of byte ranges, for telling identical
+//   images apart without comparing their bytes
+// - Implements XXH64 (xxHash, 64-bit), fed a span at a time so that it
+//   can run straight over the buffer windows
+// - A ContentKey pairs the hash with the length, which makes chance
+//   collisions between real images negligible for in-run deduplication
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_CONTENTHASH_H
+#define JPEGSNOOP_CONTENTHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct ContentKey {
+    uint64_t hash;              // XXH64 of the bytes
+    uint64_t length;            // Number of bytes
+
+    bool operator==(const ContentKey &other) const {
+        return hash == other.hash && length == other.length;
+    }
+};
+
+class ContentHash {
+public:
+    explicit ContentHash(uint64_t nSeed = 0);
+
+    void reset(uint64_t nSeed = 0);
+    void update(const uint8_t *pData, size_t nLen);
+    uint64_t digest() const;
+    uint64_t length() const { return _total; }
+
+    ContentKey key() const { return {digest(), _total}; }
+
+    static uint64_t hash(const uint8_t *pData, size_t nLen, uint64_t nSeed = 0);
+
+private:
+    uint64_t _acc[4];
+    uint64_t _total = 0;
+    uint8_t _mem[32];           // Bytes waiting for a full 32-byte stripe
+    uint32_t _memSize = 0;
+    uint64_t _seed = 0;
+};
+
+#endif
@@ -293,7 +293,7 @@ DecodePs::~DecodePs(void) = default;
 // RETURN:
 // - Byte from file
 //
-uint8_t DecodePs::Buf(uint32_t offset, bool bClean = false) {
+uint8_t DecodePs::Buf(uint64_t offset, bool bClean = false) {
     return m_pWBuf->getByte(offset, bClean);
 }
 
@@ -388,7 +388,7 @@ bool DecodePs::LookupIptcField(uint32_t nRecord, uint32_t nDataSet, uint32_t &nF
 // NOTE:
 // - The IPTC field type is used to determine how to represent the input values
 //
-QString DecodePs::DecodeIptcValue(teIptcType eIptcType, uint32_t nFldCnt, uint32_t nPos) {
+QString DecodePs::DecodeIptcValue(teIptcType eIptcType, uint32_t nFldCnt, uint64_t nPos) {
     //uint32_t      nFldInd = 0;
     uint32_t nInd;
     uint32_t nVal;
@@ -441,13 +441,13 @@ QString DecodePs::DecodeIptcValue(teIptcType eIptcType, uint32_t nFldCnt, uint32
 // Decode the IPTC metadata segment
 // INPUT:
 //      nLen    : Length of the 8BIM:IPTC resource data
-void DecodePs::DecodeIptc(uint32_t &nPos, uint32_t nLen, uint32_t nIndent) {
+void DecodePs::DecodeIptc(uint64_t &nPos, uint32_t nLen, uint32_t nIndent) {
     QString strIndent;
     QString strTmp;
     QString strIptcField;
     QString strIptcVal;
 
-    uint32_t nPosStart;
+    uint64_t nPosStart;
 
     bool bDone;
 
@@ -483,12 +483,11 @@ void DecodePs::DecodeIptc(uint32_t &nPos, uint32_t nLen, uint32_t nIndent) {
             }
 
             strIptcVal = DecodeIptcValue(eIptcType, nDataFieldCnt, nPos);
-            strTmp = QString("IPTC [%1:%2] %3 = %4").arg(strIndent)
+            LOG_INFO(*m_pLog, QString("IPTC [%1:%2] %3 = %4").arg(strIndent)
                 .arg(nRecordNumber, 3, 10, QChar('0'))
                 .arg(nDataSetNumber, 3, 10, QChar('0'))
                 .arg(strIptcField)
-                .arg(strIptcVal);
-            m_pLog->info(strTmp);
+                .arg(strIptcVal));
             nPos += nDataFieldCnt;
         } else {
             // Unknown Tag Marker
@@ -498,7 +497,7 @@ void DecodePs::DecodeIptc(uint32_t &nPos, uint32_t nLen, uint32_t nIndent) {
             strTmp = QString("ERROR: Unknown IPTC TagMarker [0x%1] @ 0x%2. Skipping parsing.")
                 .arg(nTagMarker, 2, 16, QChar('0'))
                 .arg(nPos - 5, 8, 16, QChar('0'));
-            m_pLog->error(strTmp);
+            LOG_ERROR(*m_pLog, strTmp);
 
 #ifdef DEBUG_LOG
             QString strDebug;
@@ -539,7 +538,7 @@ QString DecodePs::PhotoshopParseIndent(uint32_t nIndent) {
 // - String length prefix
 // - If length is 0 then fixed 4-character string
 // - Otherwise it is defined length string (no terminator required)
-QString DecodePs::PhotoshopParseGetLStrAsc(uint32_t &nPos) {
+QString DecodePs::PhotoshopParseGetLStrAsc(uint64_t &nPos) {
     uint32_t nStrLen;
 
     QString strVal = "";
@@ -569,7 +568,7 @@ QString DecodePs::PhotoshopParseGetLStrAsc(uint32_t &nPos) {
 // - The byte offset to advance the file pointer
 // RETURN:
 // - Unicode string
-QString DecodePs::PhotoshopParseGetBimLStrUni(uint32_t nPos, uint32_t &nPosOffset) {
+QString DecodePs::PhotoshopParseGetBimLStrUni(uint64_t nPos, uint32_t &nPosOffset) {
     QString strVal;
 
     uint32_t nStrLenActual, nStrLenTrunc;
@@ -627,10 +626,9 @@ void DecodePs::PhotoshopParseReportNote(uint32_t nIndent, QString strNote) {
     QString strLine;
 
     strIndent = PhotoshopParseIndent(nIndent);
-    strLine = QString("%1%2")
+    LOG_INFO(*m_pLog, QString("%1%2")
         .arg(strIndent)
-        .arg(strNote, -50);
-    m_pLog->info(strLine);
+        .arg(strNote, -50));
 }
 
 // Display a formatted numeric field with optional units string
@@ -642,11 +640,10 @@ void DecodePs::PhotoshopParseReportFldNum(uint32_t nIndent, QString strField, ui
 
     strIndent = PhotoshopParseIndent(nIndent);
     strVal = QString("%1").arg(nVal);
-    strLine = QString("%1%2 = %3 %4")
+    LOG_INFO(*m_pLog, QString("%1%2 = %3 %4")
         .arg(strIndent)
         .arg(strField, -50)
-        .arg(strVal).arg(strUnits);
-    m_pLog->info(strLine);
+        .arg(strVal).arg(strUnits));
 }
 
 // Display a formatted boolean field
@@ -658,11 +655,10 @@ void DecodePs::PhotoshopParseReportFldBool(uint32_t nIndent, QString strField, u
 
     strIndent = PhotoshopParseIndent(nIndent);
     strVal = (nVal != 0) ? "true" : "false";
-    strLine = QString("%1%2 = %3")
+    LOG_INFO(*m_pLog, QString("%1%2 = %3")
         .arg(strIndent)
         .arg(strField, -50)
-        .arg(strVal);
-    m_pLog->info(strLine);
+        .arg(strVal));
 }
 
 //
@@ -678,7 +674,7 @@ void DecodePs::PhotoshopParseReportFldBool(uint32_t nIndent, QString strField, u
 // - nPosStart          = Field byte array file position start
 // - nLen                       = Field byte array length
 //
-void DecodePs::PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, uint32_t nPosStart, uint32_t nLen) {
+void DecodePs::PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, uint64_t nPosStart, uint32_t nLen) {
     QString strIndent;
     QString strPrefix;
     QString strByteHex;
@@ -693,8 +689,7 @@ void DecodePs::PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, ui
 
     if (nLen == 0) {
         // Print out the header row, but no data will be shown
-        strLine = QString("%1%2 = ").arg(strIndent).arg(strField, -50);
-        m_pLog->info(strLine);
+        LOG_INFO(*m_pLog, QString("%1%2 = ").arg(strIndent).arg(strField, -50));
         // Nothing to report, exit now
         return;
     } else if (nLen <= PS_HEX_MAX_INLINE) {
@@ -702,8 +697,7 @@ void DecodePs::PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, ui
         strPrefix = QString("%1%2 = ").arg(strIndent).arg(strField, -50);
     } else {
         // Print out header row
-        strLine = QString("%1%2s =").arg(strIndent).arg(strField, -50);
-        m_pLog->info(strLine);
+        LOG_INFO(*m_pLog, QString("%1%2s =").arg(strIndent).arg(strField, -50));
         // Define prefix for next row
         strPrefix = QString("%1").arg(strIndent);
     }
@@ -753,8 +747,7 @@ void DecodePs::PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, ui
             }
 
             // Generate the line with Hex and ASCII representations
-            strLine = QString("%1 | 0x%2 | %3").arg(strPrefix).arg(strValHex).arg(strValAsc);
-            m_pLog->info(strLine);
+            LOG_INFO(*m_pLog, QString("%1 | 0x%2 | %3").arg(strPrefix).arg(strValHex).arg(strValAsc));
 
             // Now increment file offset
             nRowOffset += PS_HEX_MAX_ROW;
@@ -763,8 +756,7 @@ void DecodePs::PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, ui
 
     // If we had to clip the display length, then show ellipsis now
     if (nLenClip < nLen) {
-        strLine = QString("%1 | ...").arg(strPrefix);
-        m_pLog->info(strLine);
+        LOG_INFO(*m_pLog, QString("%1 | ...").arg(strPrefix));
     }
 
 }
@@ -857,8 +849,7 @@ DecodePs::PhotoshopParseReportFldEnum(uint32_t nIndent, QString strField, teBimE
 
     strIndent = PhotoshopParseIndent(nIndent);
     strVal = PhotoshopParseLookupEnum(eEnumField, nVal);
-    strLine = QString("%1%2 = %3").arg(strIndent).arg(strField, -50).arg(strVal);
-    m_pLog->info(strLine);
+    LOG_INFO(*m_pLog, QString("%1%2 = %3").arg(strIndent).arg(strField, -50).arg(strVal));
 }
 
 // Display a formatted fixed-point field
@@ -875,12 +866,11 @@ void DecodePs::PhotoshopParseReportFldFixPt(uint32_t nIndent, QString strField,
     fVal = (static_cast<double>(nVal) / 65536.0);
     strIndent = PhotoshopParseIndent(nIndent);
     strVal = QString("%1").arg(fVal);
-    strLine = QString("%1%2 = %3 %4")
+    LOG_INFO(*m_pLog, QString("%1%2 = %3 %4")
         .arg(strIndent)
         .arg(strField, -50)
         .arg(strVal)
-        .arg(strUnits);
-    m_pLog->info(strLine);
+        .arg(strUnits));
 }
 
 // Display a formatted fixed-point field
@@ -912,11 +902,10 @@ void DecodePs::PhotoshopParseReportFldFloatPt(uint32_t nIndent, QString strField
 
     strIndent = PhotoshopParseIndent(nIndent);
     strVal = QString("%1").arg(fVal, 0, 'f', 5);
-    strLine = QString("%1%2 = %3 %4")
+    LOG_INFO(*m_pLog, QString("%1%2 = %3 %4")
         .arg(strIndent)
         .arg(strField, -50)
-        .arg(strVal).arg(strUnits);
-    m_pLog->info(strLine);
+        .arg(strVal).arg(strUnits));
 }
 
 // Display a formatted double-precision floating-point field
@@ -953,12 +942,11 @@ void DecodePs::PhotoshopParseReportFldDoublePt(uint32_t nIndent, QString strFiel
 
     strIndent = PhotoshopParseIndent(nIndent);
     strVal = QString("%1").arg(dVal, 0, 'f', 5);
-    strLine = QString("%1%2 = %3 %4")
+    LOG_INFO(*m_pLog, QString("%1%2 = %3 %4")
         .arg(strIndent)
         .arg(strField, -50)
         .arg(strVal)
-        .arg(strUnits);
-    m_pLog->info(strLine);
+        .arg(strUnits));
 }
 
 // Display a formatted string field
@@ -968,24 +956,22 @@ void DecodePs::PhotoshopParseReportFldStr(uint32_t nIndent, QString strField, QS
     QString strLine;
 
     strIndent = PhotoshopParseIndent(nIndent);
-    strLine = QString("%1%2 = \"%3\"").arg(strIndent).arg(strField, -50).arg(strVal);
-    m_pLog->info(strLine);
+    LOG_INFO(*m_pLog, QString("%1%2 = \"%3\"").arg(strIndent).arg(strField, -50).arg(strVal));
 }
 
 // Display a formatted file offset field
 // - Report the offset with the field name (strField) and current indent level (nIndent)
-void DecodePs::PhotoshopParseReportFldOffset(uint32_t nIndent, QString strField, uint32_t nOffset) {
+void DecodePs::PhotoshopParseReportFldOffset(uint32_t nIndent, QString strField, uint64_t nOffset) {
     QString strIndent;
     QString strLine;
 
     strIndent = PhotoshopParseIndent(nIndent);
-    strLine = QString("%1%2 @ 0x%3").arg(strIndent).arg(strField, -50).arg(nOffset, 8, 16, QChar('0'));
-    m_pLog->info(strLine);
+    LOG_INFO(*m_pLog, QString("%1%2 @ 0x%3").arg(strIndent).arg(strField, -50).arg(nOffset, 8, 16, QChar('0')));
 }
 
 // Parse the Photoshop IRB Thumbnail Resource
 // - NOTE: Returned nPos doesn't take into account JFIF data
-void DecodePs::PhotoshopParseThumbnailResource(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseThumbnailResource(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData4(nPos, PS_BSWAP);
@@ -1017,7 +1003,7 @@ void DecodePs::PhotoshopParseThumbnailResource(uint32_t &nPos, uint32_t nIndent)
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseVersionInfo(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseVersionInfo(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     QString strVal;
@@ -1045,7 +1031,7 @@ void DecodePs::PhotoshopParseVersionInfo(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParsePrintScale(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParsePrintScale(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData2(nPos, PS_BSWAP);
@@ -1065,7 +1051,7 @@ void DecodePs::PhotoshopParsePrintScale(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseGlobalAngle(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseGlobalAngle(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData4(nPos, PS_BSWAP);
@@ -1079,7 +1065,7 @@ void DecodePs::PhotoshopParseGlobalAngle(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseGlobalAltitude(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseGlobalAltitude(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData4(nPos, PS_BSWAP);
@@ -1093,7 +1079,7 @@ void DecodePs::PhotoshopParseGlobalAltitude(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParsePrintFlags(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParsePrintFlags(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData1(nPos, PS_BSWAP);
@@ -1123,7 +1109,7 @@ void DecodePs::PhotoshopParsePrintFlags(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParsePrintFlagsInfo(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParsePrintFlagsInfo(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData2(nPos, PS_BSWAP);
@@ -1145,7 +1131,7 @@ void DecodePs::PhotoshopParsePrintFlagsInfo(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseCopyrightFlag(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseCopyrightFlag(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData1(nPos, PS_BSWAP);
@@ -1159,7 +1145,7 @@ void DecodePs::PhotoshopParseCopyrightFlag(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParsePixelAspectRatio(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParsePixelAspectRatio(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal, nVal1, nVal2;
 
     nVal = m_pWBuf->getData4(nPos, PS_BSWAP);
@@ -1176,7 +1162,7 @@ void DecodePs::PhotoshopParsePixelAspectRatio(uint32_t &nPos, uint32_t nIndent)
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseDocSpecificSeed(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseDocSpecificSeed(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData4(nPos, PS_BSWAP);
@@ -1190,7 +1176,7 @@ void DecodePs::PhotoshopParseDocSpecificSeed(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseGridGuides(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseGridGuides(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     QString strVal;
@@ -1229,7 +1215,7 @@ void DecodePs::PhotoshopParseGridGuides(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseResolutionInfo(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseResolutionInfo(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal, nUnit;
 
     QString strUnit;
@@ -1255,7 +1241,7 @@ void DecodePs::PhotoshopParseResolutionInfo(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseLayerStateInfo(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseLayerStateInfo(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     nVal = m_pWBuf->getData2(nPos, PS_BSWAP);
@@ -1270,7 +1256,7 @@ void DecodePs::PhotoshopParseLayerStateInfo(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseLayerGroupInfo(uint32_t &nPos, uint32_t nIndent, uint32_t nLen) {
+void DecodePs::PhotoshopParseLayerGroupInfo(uint64_t &nPos, uint32_t nIndent, uint32_t nLen) {
     uint32_t nVal;
 
     QString strVal;
@@ -1301,7 +1287,7 @@ void DecodePs::PhotoshopParseLayerGroupInfo(uint32_t &nPos, uint32_t nIndent, ui
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseLayerGroupEnabled(uint32_t &nPos, uint32_t nIndent, uint32_t nLen) {
+void DecodePs::PhotoshopParseLayerGroupEnabled(uint64_t &nPos, uint32_t nIndent, uint32_t nLen) {
     uint32_t nVal;
 
     QString strVal;
@@ -1330,7 +1316,7 @@ void DecodePs::PhotoshopParseLayerGroupEnabled(uint32_t &nPos, uint32_t nIndent,
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseLayerSelectId(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseLayerSelectId(uint64_t &nPos, uint32_t nIndent) {
     uint32_t nVal;
 
     uint32_t nNumLayer = m_pWBuf->getData2(nPos, PS_BSWAP);
@@ -1350,7 +1336,7 @@ void DecodePs::PhotoshopParseLayerSelectId(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseFileHeader(uint32_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo) {
+void DecodePs::PhotoshopParseFileHeader(uint64_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo) {
     Q_ASSERT(psImageInfo);
 
     uint32_t nVal;
@@ -1393,7 +1379,7 @@ void DecodePs::PhotoshopParseFileHeader(uint32_t &nPos, uint32_t nIndent, tsImag
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseColorModeSection(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseColorModeSection(uint64_t &nPos, uint32_t nIndent) {
     PhotoshopParseReportNote(nIndent, "Color Mode Data Section:");
     nIndent++;
 
@@ -1419,15 +1405,15 @@ void DecodePs::PhotoshopParseColorModeSection(uint32_t &nPos, uint32_t nIndent)
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseLayerMaskInfo(uint32_t &nPos, uint32_t nIndent, QImage *pDibTemp) {
+bool DecodePs::PhotoshopParseLayerMaskInfo(uint64_t &nPos, uint32_t nIndent, QImage *pDibTemp) {
     bool bDecOk = true;
 
     PhotoshopParseReportNote(nIndent, "Layer and Mask Information Section:");
     nIndent++;
 
     uint32_t nLayerMaskLen = m_pWBuf->getData4(nPos, PS_BSWAP);
-    uint32_t nPosStart = nPos;
-    uint32_t nPosEnd = nPosStart + nLayerMaskLen;
+    uint64_t nPosStart = nPos;
+    uint64_t nPosEnd = nPosStart + nLayerMaskLen;
 
     PhotoshopParseReportFldNum(nIndent, "Length", nLayerMaskLen, "");
 
@@ -1465,7 +1451,7 @@ bool DecodePs::PhotoshopParseLayerMaskInfo(uint32_t &nPos, uint32_t nIndent, QIm
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseLayerInfo(uint32_t &nPos, uint32_t nIndent, QImage *pDibTemp) {
+bool DecodePs::PhotoshopParseLayerInfo(uint64_t &nPos, uint32_t nIndent, QImage *pDibTemp) {
     bool bDecOk = true;
 
     PhotoshopParseReportNote(nIndent, "Layer Info:");
@@ -1485,7 +1471,7 @@ bool DecodePs::PhotoshopParseLayerInfo(uint32_t &nPos, uint32_t nIndent, QImage
     }
 
     // Save file position
-    uint32_t nPosStart = nPos;
+    uint64_t nPosStart = nPos;
 
     // According to Adobe, "Layer count" is defined as follows:
     // - If it is a negative number, its absolute value is the number of layers and the
@@ -1526,8 +1512,8 @@ bool DecodePs::PhotoshopParseLayerInfo(uint32_t &nPos, uint32_t nIndent, QImage
     uint32_t nNumChans;
     uint32_t nWidth;
     uint32_t nHeight;
-    uint32_t nPosLastLayer = 0;
-    uint32_t nPosLastChan = 0;
+    uint64_t nPosLastLayer = 0;
+    uint64_t nPosLastChan = 0;
 
     for (uint32_t nLayerInd = 0; (bDecOk) && (nLayerInd < nLayerCount); nLayerInd++) {
         nNumChans = sLayerAllInfo.psLayers[nLayerInd].nNumChans;
@@ -1607,7 +1593,7 @@ bool DecodePs::PhotoshopParseLayerInfo(uint32_t &nPos, uint32_t nIndent, QImage
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseLayerRecord(uint32_t &nPos, uint32_t nIndent, tsLayerInfo *pLayerInfo) {
+bool DecodePs::PhotoshopParseLayerRecord(uint64_t &nPos, uint32_t nIndent, tsLayerInfo *pLayerInfo) {
     QString strVal;
 
     bool bDecOk = true;
@@ -1676,7 +1662,7 @@ bool DecodePs::PhotoshopParseLayerRecord(uint32_t &nPos, uint32_t nIndent, tsLay
     m_pWBuf->getData1(nPos, PS_BSWAP);   // unsigned nFiller
     uint32_t nExtraDataLen = m_pWBuf->getData4(nPos, PS_BSWAP);
 
-    uint32_t nPosExtra = nPos;
+    uint64_t nPosExtra = nPos;
 
     if (bDecOk)
         bDecOk &= PhotoshopParseLayerMask(nPos, nIndent);
@@ -1713,7 +1699,7 @@ bool DecodePs::PhotoshopParseLayerRecord(uint32_t &nPos, uint32_t nIndent, tsLay
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseLayerMask(uint32_t &nPos, uint32_t nIndent) {
+bool DecodePs::PhotoshopParseLayerMask(uint64_t &nPos, uint32_t nIndent) {
     bool bDecOk = true;
 
     PhotoshopParseReportNote(nIndent, "Layer Mask / Adjustment layer data:");
@@ -1787,7 +1773,7 @@ bool DecodePs::PhotoshopParseLayerMask(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseLayerBlendingRanges(uint32_t &nPos, uint32_t nIndent) {
+bool DecodePs::PhotoshopParseLayerBlendingRanges(uint64_t &nPos, uint32_t nIndent) {
     bool bDecOk = true;
 
     PhotoshopParseReportNote(nIndent, "Layer blending ranges data:");
@@ -1822,7 +1808,7 @@ bool DecodePs::PhotoshopParseLayerBlendingRanges(uint32_t &nPos, uint32_t nInden
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseChannelImageData(uint32_t &nPos, uint32_t nIndent, uint32_t nWidth, uint32_t nHeight,
+bool DecodePs::PhotoshopParseChannelImageData(uint64_t &nPos, uint32_t nIndent, uint32_t nWidth, uint32_t nHeight,
                                               uint32_t nChan, unsigned char *pDibBits) {
     bool bDecOk = true;
 
@@ -1871,7 +1857,7 @@ bool DecodePs::PhotoshopParseChannelImageData(uint32_t &nPos, uint32_t nIndent,
             bDecOk = PhotoshopDecodeRowUncomp(nPos, nWidth, nHeight, nRow, nChan, pDibBits);
         }
     } else {
-        m_pLog->warn("Unsupported compression method. Stopping.");
+        LOG_WARN(*m_pLog, "Unsupported compression method. Stopping.");
         bDecOk = false;
         return bDecOk;
     }
@@ -1879,7 +1865,7 @@ bool DecodePs::PhotoshopParseChannelImageData(uint32_t &nPos, uint32_t nIndent,
     return bDecOk;
 }
 
-bool DecodePs::PhotoshopDecodeRowUncomp(uint32_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nChanID,
+bool DecodePs::PhotoshopDecodeRowUncomp(uint64_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nChanID,
                                         unsigned char *pDibBits) {
     bool bDecOk = true;
 
@@ -1893,7 +1879,7 @@ bool DecodePs::PhotoshopDecodeRowUncomp(uint32_t &nPos, uint32_t nWidth, uint32_
     return bDecOk;
 }
 
-bool DecodePs::PhotoshopDecodeRowRle(uint32_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nRowLen,
+bool DecodePs::PhotoshopDecodeRowRle(uint64_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nRowLen,
                                      uint32_t nChanID, unsigned char *pDibBits) {
     bool bDecOk = true;
 
@@ -1959,7 +1945,7 @@ bool DecodePs::PhotoshopDecodeRowRle(uint32_t &nPos, uint32_t nWidth, uint32_t n
 // NOTE:
 // - Image decoding (into DIB) is enabled if pDibBits is not NULL
 //
-bool DecodePs::PhotoshopParseImageData(uint32_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo,
+bool DecodePs::PhotoshopParseImageData(uint64_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo,
                                        unsigned char *pDibBits) {
     Q_ASSERT(psImageInfo);
 
@@ -2034,7 +2020,7 @@ bool DecodePs::PhotoshopParseImageData(uint32_t &nPos, uint32_t nIndent, tsImage
             }                         //nRow
         }                           //nChan
     } else {
-        m_pLog->warn("Unsupported compression method. Stopping.");
+        LOG_WARN(*m_pLog, "Unsupported compression method. Stopping.");
         bDecOk = false;
         return bDecOk;
     }
@@ -2049,7 +2035,7 @@ bool DecodePs::PhotoshopParseImageData(uint32_t &nPos, uint32_t nIndent, tsImage
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseGlobalLayerMaskInfo(uint32_t &nPos, uint32_t nIndent) {
+bool DecodePs::PhotoshopParseGlobalLayerMaskInfo(uint64_t &nPos, uint32_t nIndent) {
     bool bDecOk = true;
 
     PhotoshopParseReportNote(nIndent, "Global layer mask info:");
@@ -2060,7 +2046,7 @@ bool DecodePs::PhotoshopParseGlobalLayerMaskInfo(uint32_t &nPos, uint32_t nInden
     if (nInfoLen == 0) {
         return bDecOk;
     }
-    uint32_t nPosStart = nPos;
+    uint64_t nPosStart = nPos;
 
     m_pWBuf->getData4(nPos, PS_BSWAP);   // unsigned nOverlayColorSpace
     m_pWBuf->getData2(nPos, PS_BSWAP);   // unsigned nColComp1
@@ -2084,10 +2070,10 @@ bool DecodePs::PhotoshopParseGlobalLayerMaskInfo(uint32_t &nPos, uint32_t nInden
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseAddtlLayerInfo(uint32_t &nPos, uint32_t nIndent) {
+bool DecodePs::PhotoshopParseAddtlLayerInfo(uint64_t &nPos, uint32_t nIndent) {
     bool bDecOk = true;
 
-    uint32_t nPosStart;
+    uint64_t nPosStart;
 
     PhotoshopParseReportNote(nIndent, "Additional layer info:");
     nIndent++;
@@ -2217,15 +2203,15 @@ bool DecodePs::PhotoshopParseAddtlLayerInfo(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseImageResourcesSection(uint32_t &nPos, uint32_t nIndent) {
+bool DecodePs::PhotoshopParseImageResourcesSection(uint64_t &nPos, uint32_t nIndent) {
     bool bDecOk = true;
 
     PhotoshopParseReportNote(nIndent, "Image Resources Section:");
     nIndent++;
 
-    uint32_t nPosSectionStart = 0;
+    uint64_t nPosSectionStart = 0;
 
-    uint32_t nPosSectionEnd = 0;
+    uint64_t nPosSectionEnd = 0;
 
     uint32_t nImgResLen = m_pWBuf->getData4(nPos, PS_BSWAP);
 
@@ -2252,7 +2238,7 @@ bool DecodePs::PhotoshopParseImageResourcesSection(uint32_t &nPos, uint32_t nInd
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-bool DecodePs::PhotoshopParseImageResourceBlock(uint32_t &nPos, uint32_t nIndent) {
+bool DecodePs::PhotoshopParseImageResourceBlock(uint64_t &nPos, uint32_t nIndent) {
     QString strVal;
 
     //bool          bDecOk = true;
@@ -2339,14 +2325,14 @@ bool DecodePs::PhotoshopParseImageResourceBlock(uint32_t &nPos, uint32_t nIndent
         PhotoshopParseReportNote(nIndent, "Length is zero. Skipping.");
     } else if (bBimKnown) {
         // Save the file pointer
-        uint32_t nPosSaved;
+        uint64_t nPosSaved;
 
         nPosSaved = nPos;
 
         // Calculate the end of the record
         // - This is used for parsing records that have a conditional parsing
         //   of additional fields "if length permits".
-        uint32_t nPosEnd;
+        uint64_t nPosEnd;
 
         nPosEnd = nPos + nBimLen - 1;
 
@@ -2458,7 +2444,7 @@ bool DecodePs::PhotoshopParseImageResourceBlock(uint32_t &nPos, uint32_t nIndent
                 .arg(nPos, 8, 16, QChar('0'))
                 .arg(nPosEnd + 1, 8, 16, QChar('0'))
                 .arg(nBimLen);
-            m_pLog->error(strTmp);
+            LOG_ERROR(*m_pLog, strTmp);
 #ifdef DEBUG_LOG
             QString strDebug;
 
@@ -2486,7 +2472,7 @@ bool DecodePs::PhotoshopParseImageResourceBlock(uint32_t &nPos, uint32_t nIndent
                 .arg(nPos, 8, 16, QChar('0'))
                 .arg(nPosEnd + 1, 8, 16, QChar('0'))
                 .arg(nBimLen);
-            m_pLog->warn(strTmp);
+            LOG_WARN(*m_pLog, strTmp);
 #ifdef DEBUG_LOG
             QString strDebug;
 
@@ -2521,7 +2507,7 @@ bool DecodePs::PhotoshopParseImageResourceBlock(uint32_t &nPos, uint32_t nIndent
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseSliceHeader(uint32_t &nPos, uint32_t nIndent, uint32_t nPosEnd) {
+void DecodePs::PhotoshopParseSliceHeader(uint64_t &nPos, uint32_t nIndent, uint64_t nPosEnd) {
     uint32_t nVal;
 
     QString strVal;
@@ -2581,7 +2567,7 @@ void DecodePs::PhotoshopParseSliceHeader(uint32_t &nPos, uint32_t nIndent, uint3
 // - The nPosEnd is supplied as this resource block depends on some
 //   conditional field parsing that is "as length allows"
 //
-void DecodePs::PhotoshopParseSliceResource(uint32_t &nPos, uint32_t nIndent, uint32_t nPosEnd) {
+void DecodePs::PhotoshopParseSliceResource(uint64_t &nPos, uint32_t nIndent, uint64_t nPosEnd) {
     uint32_t nVal;
 
     QString strVal;
@@ -2674,7 +2660,7 @@ void DecodePs::PhotoshopParseSliceResource(uint32_t &nPos, uint32_t nIndent, uin
 // NOTE:
 // - This IRB is private, so reverse-engineered and may not be per spec
 //
-void DecodePs::PhotoshopParseJpegQuality(uint32_t &nPos, uint32_t nIndent, uint32_t) {
+void DecodePs::PhotoshopParseJpegQuality(uint64_t &nPos, uint32_t nIndent, uint64_t) {
     uint32_t nVal;
 
     QString strVal;
@@ -2789,7 +2775,7 @@ void DecodePs::PhotoshopParseJpegQuality(uint32_t &nPos, uint32_t nIndent, uint3
 // OUTPUT:
 // - nPos               = File position after reading the block
 //
-void DecodePs::PhotoshopParseHandleOsType(QString strOsType, uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseHandleOsType(QString strOsType, uint64_t &nPos, uint32_t nIndent) {
     if (strOsType == "obj ") {
         //PhotoshopParseReference(nPos,nIndent);
     } else if (strOsType == "Objc") {
@@ -2842,7 +2828,7 @@ void DecodePs::PhotoshopParseHandleOsType(QString strOsType, uint32_t &nPos, uin
 // OUTPUT:
 // - nPos               = File position after reading the entry
 //
-void DecodePs::PhotoshopParseDescriptor(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseDescriptor(uint64_t &nPos, uint32_t nIndent) {
     QString strVal;
 
     uint32_t nPosOffset;
@@ -2897,7 +2883,7 @@ void DecodePs::PhotoshopParseDescriptor(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the entry
 //
-void DecodePs::PhotoshopParseList(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseList(uint64_t &nPos, uint32_t nIndent) {
     QString strVal;
 
     const auto nNumItems = m_pWBuf->getData4(nPos, PS_BSWAP);
@@ -2937,7 +2923,7 @@ void DecodePs::PhotoshopParseList(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the entry
 //
-void DecodePs::PhotoshopParseInteger(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseInteger(uint64_t &nPos, uint32_t nIndent) {
     const auto nVal = m_pWBuf->getData4(nPos, PS_BSWAP);
     PhotoshopParseReportFldNum(nIndent, "Value", nVal, "");
 }
@@ -2949,7 +2935,7 @@ void DecodePs::PhotoshopParseInteger(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the entry
 //
-void DecodePs::PhotoshopParseBool(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseBool(uint64_t &nPos, uint32_t nIndent) {
     const auto nVal = m_pWBuf->getData1(nPos, PS_BSWAP);
     PhotoshopParseReportFldBool(nIndent, "Value", nVal);
 }
@@ -2961,7 +2947,7 @@ void DecodePs::PhotoshopParseBool(uint32_t &nPos, uint32_t nIndent) {
 // OUTPUT:
 // - nPos               = File position after reading the entry
 //
-void DecodePs::PhotoshopParseEnum(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseEnum(uint64_t &nPos, uint32_t nIndent) {
     QString strVal;
 
     strVal = PhotoshopParseGetLStrAsc(nPos);
@@ -2980,7 +2966,7 @@ void DecodePs::PhotoshopParseEnum(uint32_t &nPos, uint32_t nIndent) {
 // NOTE:
 // - The string is in Photoshop Unicode format (length first)
 //
-void DecodePs::PhotoshopParseStringUni(uint32_t &nPos, uint32_t nIndent) {
+void DecodePs::PhotoshopParseStringUni(uint64_t &nPos, uint32_t nIndent) {
     QString strVal;
 
     uint32_t nPosOffset;
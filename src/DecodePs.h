@@ -149,8 +149,8 @@ public:
 
     void Reset();
 
-    bool DecodePsd(uint32_t nPos, QImage *pDibTemp, int32_t &nWidth, int32_t &nHeight);
-    bool PhotoshopParseImageResourceBlock(uint32_t &nPos, uint32_t nIndent);
+    bool DecodePsd(uint64_t nPos, QImage *pDibTemp, int32_t &nWidth, int32_t &nHeight);
+    bool PhotoshopParseImageResourceBlock(uint64_t &nPos, uint32_t nIndent);
 
     bool m_bPsd;
     uint32_t m_nQualitySaveAs;
@@ -163,7 +163,7 @@ private:
     DecodePs &operator=(const DecodePs &);
     DecodePs(DecodePs &);
 
-    QString PhotoshopParseGetLStrAsc(uint32_t &nPos);
+    QString PhotoshopParseGetLStrAsc(uint64_t &nPos);
     QString PhotoshopParseIndent(uint32_t nIndent);
     void PhotoshopParseReportNote(uint32_t nIndent, QString strNote);
     QString PhotoshopParseLookupEnum(teBimEnumField eEnumField, uint32_t nVal);
@@ -175,67 +175,67 @@ private:
     void PhotoshopParseReportFldDoublePt(uint32_t nIndent, QString strField, uint32_t nVal1, uint32_t nVal2,
                                          QString strUnits);
     void PhotoshopParseReportFldStr(uint32_t nIndent, QString strField, QString strVal);
-    void PhotoshopParseReportFldOffset(uint32_t nIndent, QString strField, uint32_t nOffset);
-    void PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, uint32_t nPosStart, uint32_t nLen);
-    void PhotoshopParseThumbnailResource(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseSliceHeader(uint32_t &nPos, uint32_t nIndent, uint32_t nPosEnd);
-    void PhotoshopParseSliceResource(uint32_t &nPos, uint32_t nIndent, uint32_t nPosEnd);
-    void PhotoshopParseDescriptor(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseList(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseInteger(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseBool(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseEnum(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseStringUni(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseHandleOsType(QString strOsType, uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseFileHeader(uint32_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo);
-    void PhotoshopParseColorModeSection(uint32_t &nPos, uint32_t nIndent);
-    bool PhotoshopParseImageResourcesSection(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseVersionInfo(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseResolutionInfo(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParsePrintScale(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParsePixelAspectRatio(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseDocSpecificSeed(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseGridGuides(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseGlobalAngle(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseGlobalAltitude(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParsePrintFlags(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParsePrintFlagsInfo(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseCopyrightFlag(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseLayerStateInfo(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseLayerGroupInfo(uint32_t &nPos, uint32_t nIndent, uint32_t nLen);
-    void PhotoshopParseLayerGroupEnabled(uint32_t &nPos, uint32_t nIndent, uint32_t nLen);
-    void PhotoshopParseLayerSelectId(uint32_t &nPos, uint32_t nIndent);
-    void PhotoshopParseJpegQuality(uint32_t &nPos, uint32_t nIndent, uint32_t nPosEnd);
-
-    bool PhotoshopParseLayerMaskInfo(uint32_t &nPos, uint32_t nIndent, QImage *pDibTemp);
-    bool PhotoshopParseLayerInfo(uint32_t &nPos, uint32_t nIndent, QImage *pDibTemp);
-    bool PhotoshopParseLayerRecord(uint32_t &nPos, uint32_t nIndent, tsLayerInfo *psLayerInfo);
-    bool PhotoshopParseLayerMask(uint32_t &nPos, uint32_t nIndent);
-    bool PhotoshopParseLayerBlendingRanges(uint32_t &nPos, uint32_t nIndent);
+    void PhotoshopParseReportFldOffset(uint32_t nIndent, QString strField, uint64_t nOffset);
+    void PhotoshopParseReportFldHex(uint32_t nIndent, QString strField, uint64_t nPosStart, uint32_t nLen);
+    void PhotoshopParseThumbnailResource(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseSliceHeader(uint64_t &nPos, uint32_t nIndent, uint64_t nPosEnd);
+    void PhotoshopParseSliceResource(uint64_t &nPos, uint32_t nIndent, uint64_t nPosEnd);
+    void PhotoshopParseDescriptor(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseList(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseInteger(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseBool(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseEnum(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseStringUni(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseHandleOsType(QString strOsType, uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseFileHeader(uint64_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo);
+    void PhotoshopParseColorModeSection(uint64_t &nPos, uint32_t nIndent);
+    bool PhotoshopParseImageResourcesSection(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseVersionInfo(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseResolutionInfo(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParsePrintScale(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParsePixelAspectRatio(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseDocSpecificSeed(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseGridGuides(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseGlobalAngle(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseGlobalAltitude(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParsePrintFlags(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParsePrintFlagsInfo(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseCopyrightFlag(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseLayerStateInfo(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseLayerGroupInfo(uint64_t &nPos, uint32_t nIndent, uint32_t nLen);
+    void PhotoshopParseLayerGroupEnabled(uint64_t &nPos, uint32_t nIndent, uint32_t nLen);
+    void PhotoshopParseLayerSelectId(uint64_t &nPos, uint32_t nIndent);
+    void PhotoshopParseJpegQuality(uint64_t &nPos, uint32_t nIndent, uint64_t nPosEnd);
+
+    bool PhotoshopParseLayerMaskInfo(uint64_t &nPos, uint32_t nIndent, QImage *pDibTemp);
+    bool PhotoshopParseLayerInfo(uint64_t &nPos, uint32_t nIndent, QImage *pDibTemp);
+    bool PhotoshopParseLayerRecord(uint64_t &nPos, uint32_t nIndent, tsLayerInfo *psLayerInfo);
+    bool PhotoshopParseLayerMask(uint64_t &nPos, uint32_t nIndent);
+    bool PhotoshopParseLayerBlendingRanges(uint64_t &nPos, uint32_t nIndent);
     bool
-    PhotoshopParseChannelImageData(uint32_t &nPos, uint32_t nIndent, uint32_t nWidth, uint32_t nHeight, uint32_t nChan,
+    PhotoshopParseChannelImageData(uint64_t &nPos, uint32_t nIndent, uint32_t nWidth, uint32_t nHeight, uint32_t nChan,
                                    unsigned char *pDibBits);
-    bool PhotoshopParseGlobalLayerMaskInfo(uint32_t &nPos, uint32_t nIndent);
-    bool PhotoshopParseAddtlLayerInfo(uint32_t &nPos, uint32_t nIndent);
-    bool PhotoshopParseImageData(uint32_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo, unsigned char *pDibBits);
+    bool PhotoshopParseGlobalLayerMaskInfo(uint64_t &nPos, uint32_t nIndent);
+    bool PhotoshopParseAddtlLayerInfo(uint64_t &nPos, uint32_t nIndent);
+    bool PhotoshopParseImageData(uint64_t &nPos, uint32_t nIndent, tsImageInfo *psImageInfo, unsigned char *pDibBits);
 
-    bool PhotoshopDecodeRowUncomp(uint32_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nChanID,
+    bool PhotoshopDecodeRowUncomp(uint64_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nChanID,
                                   unsigned char *pDibBits);
-    bool PhotoshopDecodeRowRle(uint32_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nRowLen,
+    bool PhotoshopDecodeRowRle(uint64_t &nPos, uint32_t nWidth, uint32_t nHeight, uint32_t nRow, uint32_t nRowLen,
                                uint32_t nChanID, unsigned char *pDibBits);
 
     QString PhotoshopDispHexWord(uint32_t nVal);
 
     // 8BIM
-    QString PhotoshopParseGetBimLStrUni(uint32_t nPos, uint32_t &nPosOffset);
+    QString PhotoshopParseGetBimLStrUni(uint64_t nPos, uint32_t &nPosOffset);
     bool FindBimRecord(uint32_t nBimId, uint32_t &nFldInd);
 
     // IPTC
-    void DecodeIptc(uint32_t &nPos, uint32_t nLen, uint32_t nIndent);
+    void DecodeIptc(uint64_t &nPos, uint32_t nLen, uint32_t nIndent);
     bool LookupIptcField(uint32_t nRecord, uint32_t nDataSet, uint32_t &nFldInd);
-    QString DecodeIptcValue(teIptcType eIptcType, uint32_t nFldCnt, uint32_t nPos);
+    QString DecodeIptcValue(teIptcType eIptcType, uint32_t nFldCnt, uint64_t nPos);
 
-    quint8 Buf(uint32_t offset, bool bClean);
+    quint8 Buf(uint64_t offset, bool bClean);
 
     // General classes required for decoding
     WindowBuf *m_pWBuf;
@@ -0,0 +1,91 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "DedupSet.h"
+
+DedupSet::DedupSet() :
+    _shards(new Shard[DEDUP_SHARDS]) {
+}
+
+// Check whether a copy earlier than this one has been exported
+// - A copy that has one need not be exported. Any other copy has to be,
+//   as it may turn out to be the earliest.
+//
+// INPUT:
+// - key                        Content of the image
+// - srcPath, srcOffset         Where this copy was found
+//
+// OUTPUT:
+// - origin                     Where the earlier copy was found
+//
+// RETURN:
+// - true if an earlier copy has been exported
+//
+bool DedupSet::findEarlier(const ContentKey &key, const QString &srcPath, uint64_t srcOffset, DedupOrigin &origin) {
+    auto &target = shard(key);
+    std::lock_guard<std::mutex> lock(target.lock);
+
+    const auto it = target.origins.find(key);
+    if (it == target.origins.end() || !it->second.isBefore(srcPath, srcOffset)) return false;
+
+    origin = it->second;
+    return true;
+}
+
+// Record that a copy has been exported
+// - It becomes the content's origin unless an earlier copy already is
+//
+void DedupSet::claim(const ContentKey &key, const QString &srcPath, uint64_t srcOffset) {
+    auto &target = shard(key);
+    std::lock_guard<std::mutex> lock(target.lock);
+
+    const auto result = target.origins.emplace(key, DedupOrigin{srcPath, srcOffset});
+    if (!result.second && !result.first->second.isBefore(srcPath, srcOffset)) {
+        result.first->second = DedupOrigin{srcPath, srcOffset};
+    }
+}
+
+// The earliest exported copy of a content
+//
+// RETURN:
+// - false if no copy has been exported
+//
+bool DedupSet::find(const ContentKey &key, DedupOrigin &origin) {
+    auto &target = shard(key);
+    std::lock_guard<std::mutex> lock(target.lock);
+
+    const auto it = target.origins.find(key);
+    if (it == target.origins.end()) return false;
+
+    origin = it->second;
+    return true;
+}
+
+void DedupSet::clear() {
+    for (uint32_t nShard = 0; nShard < DEDUP_SHARDS; nShard++) {
+        std::lock_guard<std::mutex> lock(_shards[nShard].lock);
+        _shards[nShard].origins.clear();
+    }
+}
+
+// The high half of the hash picks the shard, leaving the low bits to
+// the shard's own table
+//
+DedupSet::Shard &DedupSet::shard(const ContentKey &key) {
+    return _shards[(key.hash >> 32) & (DEDUP_SHARDS - 1)];
+}
@@ -0,0 +1,84 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Remembers the content of every image exported in a run, so that
+//   copies of an image already exported are not exported again
+// - Keyed by ContentKey, and maps each key to the earliest exported
+//   copy, in file path and then offset order. Which copy that is does
+//   not depend on the order in which workers export them.
+// - Split into shards with a lock each, so that workers rarely wait
+//   for one another
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_DEDUPSET_H
+#define JPEGSNOOP_DEDUPSET_H
+
+#include <QString>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "ContentHash.h"
+
+// Number of independently locked shards (a power of two)
+static constexpr uint32_t DEDUP_SHARDS = 64;
+
+// Where a copy of an image was found
+struct DedupOrigin {
+    QString srcPath;
+    uint64_t srcOffset;
+
+    bool isBefore(const QString &path, uint64_t offset) const {
+        return srcPath < path || (srcPath == path && srcOffset < offset);
+    }
+};
+
+class DedupSet {
+    Q_DISABLE_COPY(DedupSet)
+public:
+    DedupSet();
+
+    bool findEarlier(const ContentKey &key, const QString &srcPath, uint64_t srcOffset, DedupOrigin &origin);
+    void claim(const ContentKey &key, const QString &srcPath, uint64_t srcOffset);
+    bool find(const ContentKey &key, DedupOrigin &origin);
+    void clear();
+
+private:
+    struct KeyHash {
+        size_t operator()(const ContentKey &key) const {
+            return static_cast<size_t>(key.hash ^ (key.length * 0x9E3779B97F4A7C15ULL));
+        }
+    };
+
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<ContentKey, DedupOrigin, KeyHash> origins;
+    };
+
+    Shard &shard(const ContentKey &key);
+
+    std::unique_ptr<Shard[]> _shards;
+};
+
+#endif
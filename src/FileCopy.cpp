@@ -0,0 +1,117 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "FileCopy.h"
+
+#if defined(__linux__)
+#define FILECOPY_LINUX
+#include <cerrno>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Bytes handed to the kernel per call
+// - Keeps each call short enough to stay responsive to signals
+static constexpr uint64_t FILE_COPY_CHUNK = 16 * 1024 * 1024;
+
+#if defined(FILECOPY_LINUX)
+
+// Copy with copy_file_range(), which can't be assumed to exist in the C
+// library, so it is called through syscall()
+//
+// INPUT / OUTPUT:
+// - nInPos, nOutPos            Advanced past the bytes copied
+//
+// RETURN:
+// - Number of bytes copied
+//
+static uint64_t CopyRangeSyscall(int nInFd, uint64_t &nInPos, int nOutFd, uint64_t &nOutPos, uint64_t nLen) {
+#if defined(SYS_copy_file_range)
+    uint64_t nDone = 0;
+
+    while (nDone < nLen) {
+        loff_t nIn = static_cast<loff_t>(nInPos);
+        loff_t nOut = static_cast<loff_t>(nOutPos);
+        const auto nChunk = static_cast<size_t>(nLen - nDone < FILE_COPY_CHUNK ? nLen - nDone : FILE_COPY_CHUNK);
+
+        const auto nRet = syscall(SYS_copy_file_range, nInFd, &nIn, nOutFd, &nOut, nChunk, 0u);
+        if (nRet < 0 && errno == EINTR) continue;
+        if (nRet <= 0) break;
+
+        nInPos += nRet;
+        nOutPos += nRet;
+        nDone += nRet;
+    }
+
+    return nDone;
+#else
+    (void) nInFd; (void) nInPos; (void) nOutFd; (void) nOutPos; (void) nLen;
+    return 0;
+#endif
+}
+
+// Copy with sendfile(), which writes at the output's file position
+//
+// INPUT / OUTPUT:
+// - nInPos, nOutPos            Advanced past the bytes copied
+//
+// RETURN:
+// - Number of bytes copied
+//
+static uint64_t CopyRangeSendfile(int nInFd, uint64_t &nInPos, int nOutFd, uint64_t &nOutPos, uint64_t nLen) {
+    if (lseek(nOutFd, static_cast<off_t>(nOutPos), SEEK_SET) < 0) return 0;
+
+    uint64_t nDone = 0;
+
+    while (nDone < nLen) {
+        off_t nIn = static_cast<off_t>(nInPos);
+        const auto nChunk = static_cast<size_t>(nLen - nDone < FILE_COPY_CHUNK ? nLen - nDone : FILE_COPY_CHUNK);
+
+        const auto nRet = sendfile(nOutFd, nInFd, &nIn, nChunk);
+        if (nRet < 0 && errno == EINTR) continue;
+        if (nRet <= 0) break;
+
+        nInPos += nRet;
+        nOutPos += nRet;
+        nDone += nRet;
+    }
+
+    return nDone;
+}
+
+#endif
+
+uint64_t CopyFileRange(int nInFd, uint64_t nInPos, int nOutFd, uint64_t nOutPos, uint64_t nLen) {
+    if (nInFd < 0 || nOutFd < 0 || nLen == 0) return 0;
+
+#if defined(FILECOPY_LINUX)
+    // Whatever copy_file_range() leaves (eg. it isn't supported for this
+    // pair of files) is tried again with sendfile()
+    auto nDone = CopyRangeSyscall(nInFd, nInPos, nOutFd, nOutPos, nLen);
+
+    if (nDone < nLen) {
+        nDone += CopyRangeSendfile(nInFd, nInPos, nOutFd, nOutPos, nLen - nDone);
+    }
+
+    return nDone;
+#else
+    (void) nInPos; (void) nOutPos;
+    return 0;
+#endif
+}
@@ -0,0 +1,56 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+// ==========================================================================
+// DESCRIPTION:
+// - Copies byte ranges between open files inside the kernel, so that
+//   exported data never passes through user space
+// - Uses copy_file_range() where available (which may also share the
+//   blocks on filesystems with reflinks), then sendfile()
+// - Platforms without either copy nothing, and callers copy the range
+//   through the buffer themselves
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_FILECOPY_H
+#define JPEGSNOOP_FILECOPY_H
+
+#include <cstdint>
+
+// Copy a range of bytes from one file descriptor to another
+// - The input descriptor's file position is neither used nor changed.
+//   The output descriptor's position is left undefined.
+//
+// INPUT:
+// - nInFd                      Descriptor to read from
+// - nInPos                     File position of the first byte to copy
+// - nOutFd                     Descriptor to write to
+// - nOutPos                    File position to write the first byte at
+// - nLen                       Number of bytes to copy
+//
+// RETURN:
+// - Number of bytes copied. Less than nLen if the input ends first or
+//   the kernel can't copy the rest (eg. across filesystems on older
+//   kernels), in which case the caller copies the remainder.
+//
+uint64_t CopyFileRange(int nInFd, uint64_t nInPos, int nOutFd, uint64_t nOutPos, uint64_t nLen);
+
+#endif
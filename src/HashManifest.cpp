@@ -0,0 +1,77 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "HashManifest.h"
+
+#include <cstdio>
+
+HashManifest::HashManifest(const QString &filePath) :
+    _out(filePath) {
+}
+
+bool HashManifest::isOpen() const {
+    return _out.isOpen();
+}
+
+// Add the line of one exported file
+// - As md5sum does, a path holding a backslash or newline is escaped
+//   and its line starts with a backslash
+//
+// INPUT:
+// - anMd5                  MD5 of the file's contents
+// - filePath               Where the file was exported to
+//
+void HashManifest::add(const uint8_t anMd5[16], const QString &filePath) {
+    const auto path = filePath.toUtf8();
+
+    QByteArray line;
+    line.reserve(path.size() + 40);
+
+    const auto bEscape = path.contains('\\') || path.contains('\n');
+    if (bEscape) {
+        line += '\\';
+    }
+
+    for (uint32_t nByte = 0; nByte < 16; nByte++) {
+        char acHex[3];
+        snprintf(acHex, sizeof(acHex), "%02x", anMd5[nByte]);
+        line += acHex;
+    }
+
+    line += "  ";
+
+    for (const char ch : path) {
+        if (bEscape && ch == '\\') {
+            line += "\\\\";
+        } else if (bEscape && ch == '\n') {
+            line += "\\n";
+        } else {
+            line += ch;
+        }
+    }
+
+    line += '\n';
+
+    _out.append(line);
+}
+
+// Write out the buffered lines
+//
+void HashManifest::flush() {
+    _out.flush();
+}
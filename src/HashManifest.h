@@ -0,0 +1,55 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Writes the MD5 of every exported file as a manifest in md5sum
+//   format, so the exports can later be checked with "md5sum -c"
+// - Images stored in packs are listed under their pack location
+//   instead, which only the pack tools can check
+// - Lines are written through a LineWriter. add() may be called from
+//   several threads; each line is written whole.
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_HASHMANIFEST_H
+#define JPEGSNOOP_HASHMANIFEST_H
+
+#include <QString>
+
+#include "LineWriter.h"
+
+class HashManifest {
+    Q_DISABLE_COPY(HashManifest)
+public:
+    // Opened as by LineWriter
+    explicit HashManifest(const QString &filePath);
+    ~HashManifest() = default;
+
+    bool isOpen() const;
+
+    void add(const uint8_t anMd5[16], const QString &filePath);
+    void flush();
+
+private:
+    LineWriter _out;
+};
+
+#endif
@@ -0,0 +1,279 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "HeaderCheck.h"
+
+#include "ImgDecode.h"
+#include "JfifDecode.h"
+
+HeaderCheck::HeaderCheck(WindowBuf &wbuf) :
+    _wbuf(wbuf) {
+}
+
+// Check the marker structure of the image starting at a file position
+// - A position that doesn't hold an SOI always passes, as JfifDecode
+//   may still find an image there (eg. in an AVI)
+//
+// INPUT:
+// - nPos                       File position of the candidate
+// - bRelaxed                   Mirror the decoder's relaxed parsing
+//
+// RETURN:
+// - HDR_PASS if the full decoder should be run
+//
+teHdrCheck HeaderCheck::check(uint64_t nPos, bool bRelaxed) {
+    const auto eResult = walk(nPos, bRelaxed);
+    _counts[eResult]++;
+
+    return eResult;
+}
+
+uint64_t HeaderCheck::count(teHdrCheck eResult) const {
+    return _counts[eResult];
+}
+
+void HeaderCheck::resetCounts() {
+    for (auto &count : _counts) {
+        count = 0;
+    }
+}
+
+QString HeaderCheck::resultName(teHdrCheck eResult) {
+    switch (eResult) {
+        case HDR_PASS:
+            return "Passed";
+        case HDR_REJ_MARKER:
+            return "Missing marker";
+        case HDR_REJ_LENGTH:
+            return "Bad segment length";
+        case HDR_REJ_TRUNCATED:
+            return "Truncated";
+        case HDR_REJ_TABLE:
+            return "Bad table field";
+        case HDR_REJ_UNKNOWN:
+            return "Unexpected marker";
+        case HDR_REJ_NO_FRAME:
+            return "No SOF before EOI/SOS";
+        case HDR_NUM_RESULTS:
+            break;
+    }
+
+    return "???";
+}
+
+// Step from marker to marker in the same way as JfifDecode::decodeMarker()
+//
+teHdrCheck HeaderCheck::walk(uint64_t nPos, bool bRelaxed) {
+    _fileSize = static_cast<uint64_t>(qMax<qint64>(_wbuf.fileSize(), 0));
+
+    if (nPos + 2 > _fileSize || _wbuf.getByte(nPos) != 0xFF || _wbuf.getByte(nPos + 1) != JFIF_SOI) {
+        return HDR_PASS;
+    }
+
+    nPos += 2;
+
+    while (true) {
+        if (nPos >= _fileSize) return HDR_REJ_TRUNCATED;
+        if (_wbuf.getByte(nPos++) != 0xFF) return HDR_REJ_MARKER;
+
+        // Skip any fill bytes
+        uint32_t nCode;
+        do {
+            if (nPos >= _fileSize) return HDR_REJ_TRUNCATED;
+            nCode = _wbuf.getByte(nPos++);
+        } while (nCode == 0xFF);
+
+        // Standalone markers
+        if (nCode == JFIF_SOI) continue;
+        if ((nCode == JFIF_EOI) || (nCode == JFIF_SOS)) return HDR_REJ_NO_FRAME;
+
+        if ((nCode >= JFIF_RST0) && (nCode <= JFIF_RST0 + 7)) {
+            if (!bRelaxed) return HDR_REJ_UNKNOWN;
+
+            // The decoder treats it as standalone if that lands on a marker
+            if (nPos + 2 < _fileSize && _wbuf.getByte(nPos + 2) == 0xFF) {
+                nPos += 2;
+                continue;
+            }
+        }
+
+        if (nPos + 2 > _fileSize) return HDR_REJ_TRUNCATED;
+
+        const auto nLength = getLength(nPos);
+        const auto nPosEnd = nPos + nLength;
+
+        switch (nCode) {
+            case JFIF_SOF0:
+            case JFIF_SOF1:
+            case JFIF_SOF2:
+            case JFIF_SOF3:
+            case JFIF_SOF5:
+            case JFIF_SOF6:
+            case JFIF_SOF7:
+            case JFIF_SOF9:
+            case JFIF_SOF10:
+            case JFIF_SOF11:
+            case JFIF_SOF13:
+            case JFIF_SOF14:
+            case JFIF_SOF15:
+                if (!bRelaxed && !checkSof(nPos + 2)) return HDR_REJ_TABLE;
+                return HDR_PASS;
+
+            case JFIF_DQT:
+                if (nLength < 2) return HDR_REJ_LENGTH;
+                if (!bRelaxed && !checkDqt(nPos + 2, nPosEnd)) return HDR_REJ_TABLE;
+                break;
+
+            case JFIF_DHT:
+                if (nLength < 2) return HDR_REJ_LENGTH;
+                if (!skipDht(nPos + 2, nPosEnd, nPos)) return HDR_REJ_TRUNCATED;
+                continue;
+
+            case JFIF_DAC:
+            case JFIF_DNL:
+            case JFIF_DRI:
+            case JFIF_EXP:
+            case JFIF_COM:
+                if (nLength < 2) return HDR_REJ_LENGTH;
+                break;
+
+            case JFIF_DHP:
+            case JFIF_JPG:
+            case JFIF_TEM:
+                // Skipped by length without further checks
+                break;
+
+            default:
+                if ((nCode >= JFIF_APP0) && (nCode <= JFIF_APP15)) {
+                    if (nLength < 2) return HDR_REJ_LENGTH;
+                } else if ((nCode < JFIF_JPG0) || (nCode > JFIF_JPG13)) {
+                    // Unknown marker (or RST with a length), skipped by
+                    // length in relaxed parsing
+                    if (!bRelaxed) return HDR_REJ_UNKNOWN;
+                }
+                break;
+        }
+
+        nPos = nPosEnd;
+    }
+}
+
+// Check the tables of a DQT segment for strict parsing
+//
+// INPUT:
+// - nPos                       First byte after the length field
+// - nPosEnd                    End of the segment
+//
+bool HeaderCheck::checkDqt(uint64_t nPos, uint64_t nPosEnd) {
+    while (nPos < nPosEnd) {
+        if (nPos >= _fileSize) return true;
+
+        const uint32_t nTmpVal = _wbuf.getByte(nPos++);
+        const auto nDqtPrecision_Pq = (nTmpVal & 0xF0) >> 4;
+        const auto nDqtQuantDestId_Tq = nTmpVal & 0x0F;
+
+        if ((nDqtPrecision_Pq > 1) || (nDqtQuantDestId_Tq >= MAX_DQT_DEST_ID)) return false;
+
+        nPos += (nDqtPrecision_Pq + 1) * MAX_DQT_COEFF;
+    }
+
+    return true;
+}
+
+// Find where the decoder continues after a DHT segment
+// - JfifDecode::decodeDht() steps over each table by its code counts and
+//   never checks the result against the segment length, except that a
+//   table with a bad class or destination ends the segment
+//
+// INPUT:
+// - nPos                       First byte after the length field
+// - nPosEnd                    End of the segment
+//
+// OUTPUT:
+// - nPosNext                   Position of the next marker
+//
+// RETURN:
+// - False if the tables run past the end of file
+//
+bool HeaderCheck::skipDht(uint64_t nPos, uint64_t nPosEnd, uint64_t &nPosNext) {
+    while (nPos < nPosEnd) {
+        if (nPos + 1 + MAX_DHT_CODELEN > _fileSize) return false;
+
+        const uint32_t nTmpVal = _wbuf.getByte(nPos++);
+        const auto nDhtClass_Tc = (nTmpVal & 0xF0) >> 4;
+        const auto nDhtHuffTblId_Th = nTmpVal & 0x0F;
+
+        if ((nDhtClass_Tc >= MAX_DHT_CLASS) || (nDhtHuffTblId_Th >= MAX_DHT_DEST_ID)) {
+            nPos = nPosEnd;
+            break;
+        }
+
+        uint32_t nDhtCodesTotal = 0;
+
+        for (uint32_t nIndLen = 1; nIndLen <= MAX_DHT_CODELEN; nIndLen++) {
+            nDhtCodesTotal += _wbuf.getByte(nPos++);
+        }
+
+        nPos += nDhtCodesTotal;
+    }
+
+    nPosNext = nPos;
+
+    return true;
+}
+
+// Check the frame header of an SOF segment for strict parsing
+//
+// INPUT:
+// - nPos                       First byte after the length field
+//
+bool HeaderCheck::checkSof(uint64_t nPos) {
+    // Leave a frame header cut short by the end of file to the decoder
+    if (nPos + 6 > _fileSize) return true;
+
+    const uint32_t nPrecision_P = _wbuf.getByte(nPos);
+    const auto nSampsPerLine_X = getLength(nPos + 3);
+    const uint32_t nNumComps_Nf = _wbuf.getByte(nPos + 5);
+
+    if ((nPrecision_P < 2) || (nPrecision_P > 16)) return false;
+    if (nSampsPerLine_X < 1) return false;
+    if (nNumComps_Nf < 1) return false;
+
+    nPos += 6;
+
+    for (uint32_t nCompInd = 1; nCompInd <= nNumComps_Nf; nCompInd++, nPos += 3) {
+        if (nPos + 3 > _fileSize) return true;
+
+        const uint32_t nSampFact = _wbuf.getByte(nPos + 1);
+        const auto nHorzSampFact_Hi = (nSampFact & 0xF0) >> 4;
+        const auto nVertSampFact_Vi = nSampFact & 0x0F;
+        const uint32_t nQuantTblSel_Tqi = _wbuf.getByte(nPos + 2);
+
+        if ((nHorzSampFact_Hi < 1) || (nHorzSampFact_Hi > 4)) return false;
+        if ((nVertSampFact_Vi < 1) || (nVertSampFact_Vi > 4)) return false;
+        if (nQuantTblSel_Tqi > 3) return false;
+    }
+
+    return true;
+}
+
+// Read a big-endian 16-bit length field
+//
+uint32_t HeaderCheck::getLength(uint64_t nPos) {
+    return _wbuf.getByte(nPos) * 256 + _wbuf.getByte(nPos + 1);
+}
@@ -0,0 +1,85 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Quick check of the JFIF marker structure at an SOI candidate, run
+//   before the full JfifDecode pass
+// - Walks the marker segments from the SOI up to the first SOF using
+//   only the length fields, without building any report strings or
+//   allocating
+// - A candidate is rejected only where JfifDecode would stop before the
+//   SOF (and so never mark the image as OK). Field ranges are checked
+//   for strict parsing only, as relaxed parsing overrides bad values
+//   and carries on.
+// - DHT segments are walked by their code counts rather than their
+//   length, as the decoder does, so tables whose counts overrun the
+//   segment land off a marker and are rejected
+// - A segment whose length doesn't chain to another marker is rejected,
+//   even though relaxed parsing can occasionally resync on such a file.
+//   SnoopConfig::quickReject() turns the check off for such inputs.
+// - Results are counted per outcome for reporting
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_HEADERCHECK_H
+#define JPEGSNOOP_HEADERCHECK_H
+
+#include <QString>
+
+#include "WindowBuf.h"
+
+enum teHdrCheck {
+    HDR_PASS,               // Reached an SOF: worth a full decode
+    HDR_REJ_MARKER,         // No 0xFF where the next marker should start
+    HDR_REJ_LENGTH,         // Segment length shorter than its length field
+    HDR_REJ_TRUNCATED,      // Marker or segment runs past the end of file
+    HDR_REJ_TABLE,          // DQT or SOF field out of range
+    HDR_REJ_UNKNOWN,        // Unknown marker, or RST outside a scan
+    HDR_REJ_NO_FRAME,       // EOI or SOS reached before any SOF
+    HDR_NUM_RESULTS
+};
+
+class HeaderCheck {
+    Q_DISABLE_COPY(HeaderCheck)
+public:
+    explicit HeaderCheck(WindowBuf &wbuf);
+
+    teHdrCheck check(uint64_t nPos, bool bRelaxed);
+
+    uint64_t count(teHdrCheck eResult) const;
+    void resetCounts();
+
+    static QString resultName(teHdrCheck eResult);
+
+private:
+    teHdrCheck walk(uint64_t nPos, bool bRelaxed);
+    bool checkDqt(uint64_t nPos, uint64_t nPosEnd);
+    bool skipDht(uint64_t nPos, uint64_t nPosEnd, uint64_t &nPosNext);
+    bool checkSof(uint64_t nPos);
+    uint32_t getLength(uint64_t nPos);
+
+    WindowBuf &_wbuf;
+    uint64_t _fileSize = 0;
+
+    uint64_t _counts[HDR_NUM_RESULTS] = {};
+};
+
+#endif
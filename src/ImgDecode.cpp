@@ -20,6 +20,7 @@
 
 #include <cmath>
 
+#include "PerceptualHash.h"
 #include "SnoopConfig.h"
 
 // ------------------------------------------------------
@@ -98,7 +99,7 @@ ImgDecode::~ImgDecode() {
 // those are set at different times versus reset (sometimes
 // before Reset() ).
 void ImgDecode::reset() {
-    _log.debug("ImgDecode::reset() Start");
+    LOG_DEBUG(_log, "ImgDecode::reset() Start");
 
     DecodeRestartScanBuf(0, false);
     DecodeRestartDcState();
@@ -324,6 +325,9 @@ void ImgDecode::setStatusText(const QString &text) {
     // if (m_pStatBar) {
     //     m_pStatBar->showMessage(str);
     // }
+
+    // Without a status bar, progress goes to the trace log
+    LOG_TRACE(_log, text);
 }
 
 // Clears the DQT entries
@@ -436,7 +440,7 @@ bool ImgDecode::setDqtEntry(uint32_t nTblDestId, uint32_t nCoeffInd, uint32_t nC
         Q_ASSERT(false);
 #endif
 
-        _log.error(strTmp);
+        LOG_ERROR(_log, strTmp);
 
         // if (m_pAppConfig->isInteractive()) {
         //     msgBox.setText(strTmp);
@@ -467,7 +471,7 @@ uint32_t ImgDecode::GetDqtEntry(uint32_t nTblDestId, uint32_t nCoeffInd) {
         QString strTmp;
 
         strTmp = QString("ERROR: GetDqtEntry(nTblDestId = %1, nCoeffInd = %2").arg(nTblDestId).arg(nCoeffInd);
-        _log.error(strTmp);
+        LOG_ERROR(_log, strTmp);
 
         // if (m_pAppConfig->isInteractive()) {
         //     msgBox.setText(strTmp);
@@ -475,7 +479,7 @@ uint32_t ImgDecode::GetDqtEntry(uint32_t nTblDestId, uint32_t nCoeffInd) {
         // }
 
 #ifdef DEBUG_LOG
-        _log.debug(QString("## File = %1 Block = %2 Error = %3").arg(_appConfig.curFileName).arg("ImgDecode").arg(strTmp));
+        LOG_DEBUG(_log, QString("## File = %1 Block = %2 Error = %3").arg(_appConfig.curFileName).arg("ImgDecode").arg(strTmp));
 #else
         Q_ASSERT(false);
 #endif
@@ -497,16 +501,13 @@ uint32_t ImgDecode::GetDqtEntry(uint32_t nTblDestId, uint32_t nCoeffInd) {
 // - Asynchronously called by JFIF Decoder
 //
 bool ImgDecode::SetDqtTables(uint32_t nCompId, uint32_t nTbl) {
-    QString strTmp;
-
     if ((nCompId < MAX_SOF_COMP_NF) && (nTbl < MAX_DQT_DEST_ID)) {
         m_anDqtTblSel[nCompId] = static_cast<int32_t>(nTbl);
     } else {
         // Should never get here unless the JFIF SOF table has a bad entry!
-        strTmp = QString("ERROR: SetDqtTables(Comp ID = %1, Table = %2")
+        LOG_ERROR(_log, QString("ERROR: SetDqtTables(Comp ID = %1, Table = %2")
             .arg(nCompId)
-            .arg(nTbl);
-        _log.error(strTmp);
+            .arg(nTbl));
 
         // if (m_pAppConfig->isInteractive()) {
         //     msgBox.setText(strTmp);
@@ -534,8 +535,6 @@ bool ImgDecode::SetDqtTables(uint32_t nCompId, uint32_t nTbl) {
 // - Success if indices are in range
 //
 bool ImgDecode::SetDhtTables(uint32_t nCompInd, uint32_t nTblDc, uint32_t nTblAc) {
-    QString strTmp;
-
     // Note use of (nCompInd < MAX_SOS_COMP_NS+1) as nCompInd is 1-based notation
     if ((nCompInd >= 1) && (nCompInd < MAX_SOS_COMP_NS + 1) && (nTblDc < MAX_DHT_DEST_ID) &&
         (nTblAc < MAX_DHT_DEST_ID)) {
@@ -543,11 +542,10 @@ bool ImgDecode::SetDhtTables(uint32_t nCompInd, uint32_t nTblDc, uint32_t nTblAc
         m_anDhtTblSel[DHT_CLASS_AC][nCompInd] = static_cast<int32_t>(nTblAc);
     } else {
         // Should never get here!
-        strTmp = QString("ERROR: SetDhtTables(comp = %1, TblDC = %2 TblAC = %3) out of indexed range")
+        LOG_ERROR(_log, QString("ERROR: SetDhtTables(comp = %1, TblDC = %2 TblAC = %3) out of indexed range")
             .arg(nCompInd)
             .arg(nTblDc)
-            .arg(nTblAc);
-        _log.error(strTmp);
+            .arg(nTblAc));
 
         // if (m_pAppConfig->isInteractive()) {
         //     msgBox.setText(strTmp);
@@ -647,14 +645,14 @@ bool ImgDecode::SetDhtEntry(uint32_t nDestId, uint32_t nClass, uint32_t nInd, ui
                             uint32_t nBits, uint32_t nMask, uint32_t nCode) {
     if ((nDestId >= MAX_DHT_DEST_ID) || (nClass >= MAX_DHT_CLASS) || (nInd >= MAX_DHT_CODES)) {
         QString strTmp = "Attempt to set DHT entry out of range";
-        _log.error(strTmp);
+        LOG_ERROR(_log, strTmp);
 
         // if (m_pAppConfig->isInteractive()) {
         //     msgBox.setText(strTmp);
         //     msgBox.exec();
         // }
         // #ifdef DEBUG_LOG
-        _log.debug(QString("## Block = %1 Error = %2").arg("ImgDecode", strTmp));
+        LOG_DEBUG(_log, QString("## Block = %1 Error = %2").arg("ImgDecode", strTmp));
         // #else
         //         Q_ASSERT(false);
         // #endif
@@ -730,9 +728,7 @@ bool ImgDecode::SetDhtEntry(uint32_t nDestId, uint32_t nClass, uint32_t nInd, ui
 //
 bool ImgDecode::SetDhtSize(uint32_t nDestId, uint32_t nClass, uint32_t nSize) {
     if ((nDestId >= MAX_DHT_DEST_ID) || (nClass >= MAX_DHT_CLASS) || (nSize >= MAX_DHT_CODES)) {
-        QString strTmp = "ERROR: Attempt to set DHT table size out of range";
-
-        _log.error(strTmp);
+        LOG_ERROR(_log, "ERROR: Attempt to set DHT table size out of range");
 
         // if (m_pAppConfig->isInteractive()) {
         //     msgBox.setText(strTmp);
@@ -864,7 +860,7 @@ inline void ImgDecode::ScanBuffConsume(uint32_t nNumBits) {
 // - m_anScanBuffPtr_err[]
 // - m_anScanBuffPtr_pos[]
 //
-inline void ImgDecode::ScanBuffAdd(uint32_t nNewByte, uint32_t nPtr) {
+inline void ImgDecode::ScanBuffAdd(uint32_t nNewByte, uint64_t nPtr) {
     // Add the new byte to the buffer
     // Assume that m_nScanBuff has already been shifted to be
     // aligned to bit 31 as first bit.
@@ -892,7 +888,7 @@ inline void ImgDecode::ScanBuffAdd(uint32_t nNewByte, uint32_t nPtr) {
 // POST:
 // - m_anScanBuffPtr_err[]
 //
-inline void ImgDecode::ScanBuffAddErr(uint32_t nNewByte, uint32_t nPtr, uint32_t nErr) {
+inline void ImgDecode::ScanBuffAddErr(uint32_t nNewByte, uint64_t nPtr, uint32_t nErr) {
     ScanBuffAdd(nNewByte, nPtr);
     m_anScanBuffPtr_err[m_nScanBuffPtr_num - 1] = nErr;
 }
@@ -990,16 +986,12 @@ teRsvRet ImgDecode::ReadScanVal(uint32_t nClass, uint32_t nTbl, uint32_t &rZrl,
         // Trying to overread end of scan segment
 
         if (m_nWarnBadScanNum < _scanErrMax) {
-            QString strTmp;
-
-            strTmp = QString("*** ERROR: Overread scan segment (before nCode)! @ Offset: %1").arg(getScanBufPos());
-            _log.error(strTmp);
+            LOG_ERROR(_log, QString("*** ERROR: Overread scan segment (before nCode)! @ Offset: %1").arg(getScanBufPos()));
 
             m_nWarnBadScanNum++;
 
             if (m_nWarnBadScanNum >= _scanErrMax) {
-                strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
             }
         }
 
@@ -1097,10 +1089,7 @@ teRsvRet ImgDecode::ReadScanVal(uint32_t nClass, uint32_t nTbl, uint32_t &rZrl,
     // Did we overread the scan buffer?
     if (m_nScanBuff_vacant > 32) {
         // The nCode consumed more bits than we had!
-        QString strTmp;
-
-        strTmp = QString("*** ERROR: Overread scan segment (after nCode)! @ Offset: %1").arg(getScanBufPos());
-        _log.error(strTmp);
+        LOG_ERROR(_log, QString("*** ERROR: Overread scan segment (after nCode)! @ Offset: %1").arg(getScanBufPos()));
         m_bScanEnd = true;
         m_bScanBad = true;
         return RSV_UNDERFLOW;
@@ -1144,10 +1133,7 @@ teRsvRet ImgDecode::ReadScanVal(uint32_t nClass, uint32_t nTbl, uint32_t &rZrl,
             // Did we overread the scan buffer?
             if (m_nScanBuff_vacant > 32) {
                 // The nCode consumed more bits than we had!
-                QString strTmp;
-
-                strTmp = QString("*** ERROR: Overread scan segment (after bitstring)! @ Offset: %1").arg(getScanBufPos());
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("*** ERROR: Overread scan segment (after bitstring)! @ Offset: %1").arg(getScanBufPos()));
                 m_bScanEnd = true;
                 m_bScanBad = true;
                 return RSV_UNDERFLOW;
@@ -1166,19 +1152,15 @@ teRsvRet ImgDecode::ReadScanVal(uint32_t nClass, uint32_t nTbl, uint32_t &rZrl,
         // again.
 
         if (m_nWarnBadScanNum < _scanErrMax) {
-            QString strTmp;
-
-            strTmp =
-                QString("*** ERROR: Can't find huffman bitstring @ %1, table %2, value 0x%3").arg(getScanBufPos()).arg(
-                    nTbl).
-                    arg(m_nScanBuff, 8, 16, QChar('0'));
-            _log.error(strTmp);
+            LOG_ERROR(_log, QString("*** ERROR: Can't find huffman bitstring @ %1, table %2, value 0x%3")
+                .arg(getScanBufPos())
+                .arg(nTbl)
+                .arg(m_nScanBuff, 8, 16, QChar('0')));
 
             m_nWarnBadScanNum++;
 
             if (m_nWarnBadScanNum >= _scanErrMax) {
-                strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
             }
         }
 
@@ -1248,13 +1230,9 @@ bool ImgDecode::ExpectRestart() {
         // FIXME: Later, check that we are on the right marker!
         if ((nMarker >= JFIF_RST0) && (nMarker <= JFIF_RST7)) {
             if (_verbose) {
-                QString strTmp;
-
-                strTmp =
-                    QString("  RESTART marker: @ 0x%1.0 : RST%2")
-                        .arg(m_nScanBuffPtr, 8, 16, QChar('0'))
-                        .arg(nMarker - JFIF_RST0, 2, 10, QChar('0'));
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("  RESTART marker: @ 0x%1.0 : RST%2")
+                    .arg(m_nScanBuffPtr, 8, 16, QChar('0'))
+                    .arg(nMarker - JFIF_RST0, 2, 10, QChar('0')));
             }
 
             m_nRestartRead++;
@@ -1306,13 +1284,9 @@ uint32_t ImgDecode::BuffAddByte() {
 
         if ((nMarker >= JFIF_RST0) && (nMarker <= JFIF_RST7)) {
             if (_verbose) {
-                QString strTmp;
-
-                strTmp =
-                    QString("  RESTART marker: @ 0x%1.0 : RST%2")
-                        .arg(m_nScanBuffPtr, 8, 16, QChar('0'))
-                        .arg(nMarker - JFIF_RST0, 2, 10, QChar('0'));
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("  RESTART marker: @ 0x%1.0 : RST%2")
+                    .arg(m_nScanBuffPtr, 8, 16, QChar('0'))
+                    .arg(nMarker - JFIF_RST0, 2, 10, QChar('0')));
             }
 
             m_nRestartRead++;
@@ -1320,14 +1294,10 @@ uint32_t ImgDecode::BuffAddByte() {
 
             if (m_nRestartLastInd != m_nRestartExpectInd) {
                 if (!m_bScanErrorsDisable) {
-                    QString strTmp;
-
-                    strTmp =
-                        QString("  ERROR: Expected RST marker index RST%1 got RST%2 @ 0x%3.0")
-                            .arg(m_nRestartExpectInd)
-                            .arg(m_nRestartLastInd)
-                            .arg(m_nScanBuffPtr, 8, 16, QChar('0'));
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("  ERROR: Expected RST marker index RST%1 got RST%2 @ 0x%3.0")
+                        .arg(m_nRestartExpectInd)
+                        .arg(m_nRestartLastInd)
+                        .arg(m_nScanBuffPtr, 8, 16, QChar('0')));
                 }
             }
 
@@ -1436,20 +1406,18 @@ uint32_t ImgDecode::BuffAddByte() {
         if (m_nWarnBadScanNum < _scanErrMax) {
             QString strTmp;
 
-            strTmp = QString("  Scan Data encountered marker   0xFF%1 @ 0x%2.0")
+            LOG_INFO(_log, QString("  Scan Data encountered marker   0xFF%1 @ 0x%2.0")
                 .arg(nMarker, 2, 16, QChar('0'))
-                .arg(m_nScanBuffPtr, 8, 16, QChar('0'));
-            _log.info(strTmp);
+                .arg(m_nScanBuffPtr, 8, 16, QChar('0')));
 
             if (nMarker != JFIF_EOI) {
-                _log.error("  NOTE: Marker wasn't EOI (0xFFD9)");
+                LOG_ERROR(_log, "  NOTE: Marker wasn't EOI (0xFFD9)");
             }
 
             m_nWarnBadScanNum++;
 
             if (m_nWarnBadScanNum >= _scanErrMax) {
-                strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
             }
         }
 
@@ -1514,7 +1482,7 @@ bool ImgDecode::DecodeScanComp(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint32_t
     uint32_t nNumCoeffs = 0;
 
     //uint32_t nDctMax = 0;                 // Maximum DCT coefficient to use for IDCT
-    uint32_t nSavedBufPos = 0;
+    uint64_t nSavedBufPos = 0;
 
     uint32_t nSavedBufErr = SCANBUF_OK;
 
@@ -1590,16 +1558,12 @@ bool ImgDecode::DecodeScanComp(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint32_t
             if (m_nWarnBadScanNum < _scanErrMax) {
                 QString strPos = getScanBufPos(nSavedBufPos, nSavedBufAlign);
 
-                QString strTmp;
-
-                strTmp = QString("*** ERROR: Bad marker @ %1").arg(strPos);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("*** ERROR: Bad marker @ %1").arg(strPos));
 
                 m_nWarnBadScanNum++;
 
                 if (m_nWarnBadScanNum >= _scanErrMax) {
-                    strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
                 }
             }
 
@@ -1641,16 +1605,12 @@ bool ImgDecode::DecodeScanComp(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint32_t
             if (m_nWarnBadScanNum < _scanErrMax) {
                 QString strPos = getScanBufPos(nSavedBufPos, nSavedBufAlign);
 
-                QString strTmp;
-
-                strTmp = QString("*** ERROR: Bad huffman code @ %1").arg(strPos);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("*** ERROR: Bad huffman code @ %1").arg(strPos));
 
                 m_nWarnBadScanNum++;
 
                 if (m_nWarnBadScanNum >= _scanErrMax) {
-                    strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
                 }
             }
 
@@ -1685,14 +1645,12 @@ bool ImgDecode::DecodeScanComp(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint32_t
 
                 QString strPos = getScanBufPos(nSavedBufPos, nSavedBufAlign);
 
-                strTmp = QString("*** ERROR: @ %1, nNumCoeffs>64 [%2]").arg(strPos).arg(nNumCoeffs);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("*** ERROR: @ %1, nNumCoeffs>64 [%2]").arg(strPos).arg(nNumCoeffs));
 
                 m_nWarnBadScanNum++;
 
                 if (m_nWarnBadScanNum >= _scanErrMax) {
-                    strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
                 }
             }
 
@@ -1794,12 +1752,11 @@ bool ImgDecode::DecodeScanCompPrint(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint
                 break;
         }
 
-        strTmp = QString("    %1 (Tbl #%2), MCU=[%3,%4]").arg(strTbl).arg(nTblDqt).arg(nMcuX).arg(nMcuY);
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("    %1 (Tbl #%2), MCU=[%3,%4]").arg(strTbl).arg(nTblDqt).arg(nMcuX).arg(nMcuY));
     }
 
     uint32_t nNumCoeffs = 0;
-    uint32_t nSavedBufPos = 0;
+    uint64_t nSavedBufPos = 0;
     uint32_t nSavedBufErr = SCANBUF_OK;
     uint32_t nSavedBufAlign = 0;
 
@@ -1870,14 +1827,12 @@ bool ImgDecode::DecodeScanCompPrint(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint
 
             if (m_nWarnBadScanNum < _scanErrMax) {
                 strPos = getScanBufPos(nSavedBufPos, nSavedBufAlign);
-                strTmp = QString("*** ERROR: Bad marker @ %1").arg(strPos);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("*** ERROR: Bad marker @ %1").arg(strPos));
 
                 m_nWarnBadScanNum++;
 
                 if (m_nWarnBadScanNum >= _scanErrMax) {
-                    strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
                 }
             }
 
@@ -1919,14 +1874,12 @@ bool ImgDecode::DecodeScanCompPrint(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint
                 strSpecial = "ERROR";
                 strPos = getScanBufPos(nSavedBufPos, nSavedBufAlign);
 
-                strTmp = QString("*** ERROR: Bad huffman code @ %1").arg(strPos);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("*** ERROR: Bad huffman code @ %1").arg(strPos));
 
                 m_nWarnBadScanNum++;
 
                 if (m_nWarnBadScanNum >= _scanErrMax) {
-                    strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
                 }
             }
 
@@ -1955,14 +1908,12 @@ bool ImgDecode::DecodeScanCompPrint(uint32_t nTblDhtDc, uint32_t nTblDhtAc, uint
 
             if (m_nWarnBadScanNum < _scanErrMax) {
                 strPos = getScanBufPos(nSavedBufPos, nSavedBufAlign);
-                strTmp = QString("*** ERROR: @ %1, nNumCoeffs>64 [%2]").arg(strPos).arg(nNumCoeffs);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("*** ERROR: @ %1, nNumCoeffs>64 [%2]").arg(strPos).arg(nNumCoeffs));
 
                 m_nWarnBadScanNum++;
 
                 if (m_nWarnBadScanNum >= _scanErrMax) {
-                    strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
                 }
             }
 
@@ -2026,10 +1977,10 @@ void ImgDecode::reportDctMatrix() {
         }
 
         strLine.append("]");
-        _log.info(strLine);
+        LOG_INFO(_log, strLine);
     }
 
-    _log.info("");
+    LOG_INFO(_log, "");
 }
 
 // Report out the variable length codes (VLC)
@@ -2050,12 +2001,15 @@ void ImgDecode::reportDctMatrix() {
 // - nCoeffEnd                          =
 // - specialStr                         =
 //
-void ImgDecode::reportVlc(uint32_t nVlcPos, uint32_t nVlcAlign, uint32_t nZrl, int32_t nVal, uint32_t nCoeffStart, uint32_t nCoeffEnd, const QString &specialStr) {
+void ImgDecode::reportVlc(uint64_t nVlcPos, uint32_t nVlcAlign, uint32_t nZrl, int32_t nVal, uint32_t nCoeffStart, uint32_t nCoeffEnd, const QString &specialStr) {
+    // Only ever produces the one info line
+    if (!LOG_INFO_ON(_log)) return;
+
     QString strPos;
     QString strTmp;
 
     uint32_t nBufByte[4];
-    uint32_t nBufPosInd = nVlcPos;
+    uint64_t nBufPosInd = nVlcPos;
 
     QString strData = "";
     QString strByte1 = "";
@@ -2146,7 +2100,7 @@ void ImgDecode::reportVlc(uint32_t nVlcPos, uint32_t nVlcAlign, uint32_t nZrl, i
             .arg(specialStr);
     }
 
-    _log.info(strTmp);
+    LOG_INFO(_log, strTmp);
 }
 
 // Clear input and output matrix
@@ -2399,11 +2353,10 @@ void ImgDecode::SetFullRes(int32_t nMcuX, int32_t nMcuY, int32_t nComp, uint32_t
         QString strDebug;
 
         strTmp = QString("SetFullRes() with nComp <= 0 [%1]").arg(nComp);
-        strDebug = QString("## File=[%1] Block=[%2] Error=[%3]\n")
+        LOG_DEBUG(_log, QString("## File=[%1] Block=[%2] Error=[%3]\n")
             .arg(_appConfig.curFileName, -100)
             .arg("ImgDecode", -10)
-            .arg(strTmp);
-        _log.debug(strDebug);
+            .arg(strTmp));
 #else
         Q_ASSERT(false);
 #endif
@@ -2499,7 +2452,7 @@ QString ImgDecode::getScanBufPos() {
 // RETURN:
 // - Formatted string
 //
-QString ImgDecode::getScanBufPos(uint32_t pos, uint32_t align) {
+QString ImgDecode::getScanBufPos(uint64_t pos, uint32_t align) {
     return QString("0x%1.%2")
         .arg(pos, 8, 16, QChar('0'))
         .arg(align);;
@@ -2555,16 +2508,15 @@ void ImgDecode::CheckScanErrors(uint32_t nMcuX, uint32_t nMcuY, uint32_t nCssInd
         }
 
         if (m_nWarnBadScanNum < _scanErrMax) {
-            errStr = QString("*** ERROR: Bad scan data in MCU(%1,%2): %3 @ Offset %4")
+            LOG_ERROR(_log, QString("*** ERROR: Bad scan data in MCU(%1,%2): %3 @ Offset %4")
                 .arg(nMcuX)
                 .arg(nMcuY)
                 .arg(strTmp)
-                .arg(getScanBufPos());
-            _log.error(errStr);
+                .arg(getScanBufPos()));
             errStr = QString("           MCU located at pixel=(%1, %2)")
                 .arg(err_pos_x)
                 .arg(err_pos_y);
-            _log.error(errStr);
+            LOG_ERROR(_log, errStr);
 
             //errStr = QString("*** Resetting Error state to continue ***");
             //m_pLog->AddLineErr(errStr);
@@ -2572,8 +2524,7 @@ void ImgDecode::CheckScanErrors(uint32_t nMcuX, uint32_t nMcuY, uint32_t nCssInd
             m_nWarnBadScanNum++;
 
             if (m_nWarnBadScanNum >= _scanErrMax) {
-                strTmp = QString("    Only reported first %1 instances of this message...").arg(_scanErrMax);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("    Only reported first %1 instances of this message...").arg(_scanErrMax));
             }
         }
 
@@ -2619,8 +2570,8 @@ void ImgDecode::DecodeRestartDcState() {
 // - display                                   = Generate a preview image?
 // - quiet                                     = Disable output of certain messages during decode?
 //
-void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet) {
-    _log.debug("ImgDecode::decodeScanImg Start");
+void ImgDecode::decodeScanImg(uint64_t startPosition, bool display, bool quiet) {
+    LOG_DEBUG(_log, "ImgDecode::decodeScanImg Start");
 
     QString strTmp;
 
@@ -2638,14 +2589,13 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     // Detect the scenario where the image component details haven't been set yet
     // The image details are set via SetImageDetails()
     if (!m_bImgDetailsSet) {
-        _log.error("*** ERROR: Decoding image before Image components defined ***");
+        LOG_ERROR(_log, "*** ERROR: Decoding image before Image components defined ***");
         return;
     }
 
     // Even though we support decoding of MAX_SOS_COMP_NS we limit the component flexibility further
     if ((m_nNumSosComps != NUM_CHAN_GRAYSCALE) && (m_nNumSosComps != NUM_CHAN_YCC)) {
-        strTmp = QString("  NOTE: Number of SOS components not supported [%1]").arg(m_nNumSosComps);
-        _log.warn(strTmp);
+        LOG_WARN(_log, QString("  NOTE: Number of SOS components not supported [%1]").arg(m_nNumSosComps));
 #ifndef DEBUG_YCCK
         return;
 #endif
@@ -2687,7 +2637,7 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
         // TODO: Need to confirm if component index needs to be looked up
         // in the case of multiple SOS or if [1] is the correct index
         if ((m_anSofSampFactH[1] != 1) || (m_anSofSampFactV[1] != 1)) {
-            _log.warn("    Altering sampling factor for single component scan to 0x11");
+            LOG_WARN(_log, "    Altering sampling factor for single component scan to 0x11");
         }
 
         m_anSofSampFactH[1] = 1;
@@ -2701,10 +2651,9 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     // Perform additional range checks
     if ((m_nSosSampFactHMax == 0) || (m_nSosSampFactVMax == 0) || (m_nSosSampFactHMax > MAX_SAMP_FACT_H)
         || (m_nSosSampFactVMax > MAX_SAMP_FACT_V)) {
-        strTmp = QString("  NOTE: Degree of subsampling factor not supported [HMax=%1, VMax=%2]")
+        LOG_WARN(_log, QString("  NOTE: Degree of subsampling factor not supported [HMax=%1, VMax=%2]")
             .arg(m_nSosSampFactHMax)
-            .arg(m_nSosSampFactVMax);
-        _log.warn(strTmp);
+            .arg(m_nSosSampFactVMax));
         return;
     }
 
@@ -2752,7 +2701,7 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     // Set the decoded size and before scaling
     m_nImgSizeX = m_nMcuXMax * m_nMcuWidth;
     m_nImgSizeY = m_nMcuYMax * m_nMcuHeight;
-    _log.debug(QString("ImgDecode::decodeScanImg ImgSizeX=%1 ImgSizeY=%2").arg(m_nImgSizeX).arg(m_nImgSizeY));
+    LOG_DEBUG(_log, QString("ImgDecode::decodeScanImg ImgSizeX=%1 ImgSizeY=%2").arg(m_nImgSizeX).arg(m_nImgSizeY));
 
     // Determine decoding range
     int32_t nDecMcuRowStart;
@@ -2769,8 +2718,8 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
 
     // Allocate the MCU File Map
     Q_ASSERT(m_pMcuFileMap == 0);
-    m_pMcuFileMap = new uint32_t[m_nMcuYMax * m_nMcuXMax];
-    memset(m_pMcuFileMap, 0, (m_nMcuYMax * m_nMcuXMax * sizeof(int32_t)));
+    m_pMcuFileMap = new uint64_t[m_nMcuYMax * m_nMcuXMax];
+    memset(m_pMcuFileMap, 0, (m_nMcuYMax * m_nMcuXMax * sizeof(uint64_t)));
 
     // Allocate the 8x8 Block DC Map
     m_pBlkDcValY = new int16_t[m_nBlkYMax * m_nBlkXMax];
@@ -2797,15 +2746,17 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     }
 
     // Allocate image (YCC)
-    m_pPixValY = new int16_t[nPixMapW * nPixMapH];
+    // - Only the preview writes to it, so a decode for the block DC
+    //   values alone (eg. dcPerceptualHash()) goes without
+    if (display) {
+        m_pPixValY = new int16_t[nPixMapW * nPixMapH];
 
-    if (m_nNumSosComps == NUM_CHAN_YCC) {
-        m_pPixValCb = new int16_t[nPixMapW * nPixMapH];
-        m_pPixValCr = new int16_t[nPixMapW * nPixMapH];
-    }
+        if (m_nNumSosComps == NUM_CHAN_YCC) {
+            m_pPixValCb = new int16_t[nPixMapW * nPixMapH];
+            m_pPixValCr = new int16_t[nPixMapW * nPixMapH];
+        }
 
-    // Reset pixel map
-    if (display) {
+        // Reset pixel map
         ClrFullRes(nPixMapW, nPixMapH);
     }
 
@@ -2828,13 +2779,13 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     BuffTopup();
 
     if (!quiet) {
-        _log.info("*** Decoding SCAN Data ***");
-        _log.info(QString("  OFFSET: 0x%1").arg(startPosition, 8, 16, QChar('0')));
+        LOG_INFO(_log, "*** Decoding SCAN Data ***");
+        LOG_INFO(_log, QString("  OFFSET: 0x%1").arg(startPosition, 8, 16, QChar('0')));
     }
 
     // TODO: Might be more appropriate to check against m_nNumSosComps instead?
     if ((m_nNumSofComps != NUM_CHAN_GRAYSCALE) && (m_nNumSofComps != NUM_CHAN_YCC)) {
-        _log.warn(QString("  Number of Image Components not supported [%1]").arg(m_nNumSofComps));
+        LOG_WARN(_log, QString("  Number of Image Components not supported [%1]").arg(m_nNumSofComps));
 #ifndef DEBUG_YCCK
         return;
 #endif
@@ -2859,7 +2810,7 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     }
 
     if (!bDqtReady) {
-        _log.error("*** ERROR: Decoding image before DQT Table Selection via JFIF_SOF ***");
+        LOG_ERROR(_log, "*** ERROR: Decoding image before DQT Table Selection via JFIF_SOF ***");
         // TODO: Is more error handling required?
         return;
     } else {
@@ -2913,7 +2864,7 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     }
 
     if (!bDhtReady) {
-        _log.error("*** ERROR: Decoding image before DHT Table Selection via JFIF_SOS ***");
+        LOG_ERROR(_log, "*** ERROR: Decoding image before DHT Table Selection via JFIF_SOS ***");
         // TODO: Is more error handling required here?
         return;
     } else {
@@ -2942,13 +2893,13 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     // Inform if they are in AC+DC/DC mode
     if (!quiet) {
         if (_decodeScanAc) {
-            _log.info("  Scan Decode Mode: Full IDCT (AC + DC)");
+            LOG_INFO(_log, "  Scan Decode Mode: Full IDCT (AC + DC)");
         } else {
-            _log.info("  Scan Decode Mode: No IDCT (DC only)");
-            _log.warn("Low-resolution DC component shown. Can decode full-res with [Options->Scan Segment->Full IDCT]");
+            LOG_INFO(_log, "  Scan Decode Mode: No IDCT (DC only)");
+            LOG_WARN(_log, "Low-resolution DC component shown. Can decode full-res with [Options->Scan Segment->Full IDCT]");
         }
 
-        _log.info("");
+        LOG_INFO(_log, "");
     }
 
     // Report any Buffer overlays
@@ -2962,11 +2913,14 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
 
     for (uint32_t nMcuY = nDecMcuRowStart; nMcuY < nDecMcuRowEndFinal; nMcuY++) {
         // Set the statusbar text to Processing...
-        strTmp = QString("Decoding Scan Data... Row %1 of %2 (%3%%)")
-            .arg(nMcuY, 4, 10, QChar('0'))
-            .arg(m_nMcuYMax, 4, 10, QChar('0'))
-            .arg(nMcuY * 100.0 / m_nMcuYMax, 3, 'f', 0);
-        setStatusText(strTmp);
+        // - Only formatted when there is somewhere to show it
+        if (LOG_TRACE_ON(_log)) {
+            strTmp = QString("Decoding Scan Data... Row %1 of %2 (%3%%)")
+                .arg(nMcuY, 4, 10, QChar('0'))
+                .arg(m_nMcuYMax, 4, 10, QChar('0'))
+                .arg(nMcuY * 100.0 / m_nMcuYMax, 3, 'f', 0);
+            setStatusText(strTmp);
+        }
 
         // TODO: Trap escape keypress here (or run as thread)
 
@@ -2994,10 +2948,8 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
              }
            */
                 } else {
-                    strTmp = QString("  Expect Restart interval elapsed @ %1").arg(getScanBufPos());
-                    _log.info(strTmp);
-                    strTmp = QString("    ERROR: Restart marker not detected");
-                    _log.error(strTmp);
+                    LOG_INFO(_log, QString("  Expect Restart interval elapsed @ %1").arg(getScanBufPos()));
+                    LOG_ERROR(_log, QString("    ERROR: Restart marker not detected"));
                 }
                 /*
            if (ExpectRestart()) {
@@ -3048,7 +3000,7 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
 
             // Give separator line between MCUs
             if (bVlcDump) {
-                _log.info("");
+                LOG_INFO(_log, "");
             }
 
             // CSS array indices
@@ -3403,17 +3355,15 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
                     // FIXME: Temporarily catch any range issue
                     if (nBlkXY >= m_nBlkXMax * m_nBlkYMax) {
 #ifdef DEBUG_LOG
-                        QString strDebug;
-
                         strTmp = QString(
                             "decodeScanImg() with nBlkXY out of range. nBlkXY=[%1] m_nBlkXMax=[%2] m_nBlkYMax=[%3]")
                             .arg(nBlkXY)
                             .arg(m_nBlkXMax)
                             .arg(m_nBlkYMax);
-                        strDebug = QString("## File=[%1] Block=[%2] Error=[%3]\n")
+                        LOG_DEBUG(_log, QString("## File=[%1] Block=[%2] Error=[%3]\n")
                             .arg(_appConfig.curFileName, -100)
-                            .arg("ImgDecode", -10).arg(strTmp);
-                        _log.debug(strDebug);
+                            .arg("ImgDecode", -10)
+                            .arg(strTmp));
 #else
                         Q_ASSERT(false);
 #endif
@@ -3437,15 +3387,12 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
                         // FIXME: Temporarily catch any range issue
                         if (nBlkXY >= m_nBlkXMax * m_nBlkYMax) {
 #ifdef DEBUG_LOG
-                            QString strDebug;
-
                             strTmp = QString(
                                 "decodeScanImg() with nBlkXY out of range. nBlkXY=[%1] m_nBlkXMax=[%2] m_nBlkYMax=[%3]").arg(
                                 nBlkXY).arg(m_nBlkXMax).arg(m_nBlkYMax);
-                            strDebug = QString("## File=[%1] Block=[%2] Error=[%3]\n").arg(_appConfig.curFileName,
+                            LOG_DEBUG(_log, QString("## File=[%1] Block=[%2] Error=[%3]\n").arg(_appConfig.curFileName,
                                                                                            -100).arg("ImgDecode",
-                                                                                                     -10).arg(strTmp);
-                            _log.debug(strDebug);
+                                                                                                     -10).arg(strTmp));
 #else
                             Q_ASSERT(false);
 #endif
@@ -3467,15 +3414,12 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
                         // FIXME: Temporarily catch any range issue
                         if (nBlkXY >= m_nBlkXMax * m_nBlkYMax) {
 #ifdef DEBUG_LOG
-                            QString strDebug;
-
                             strTmp = QString(
                                 "decodeScanImg() with nBlkXY out of range. nBlkXY=[%1] m_nBlkXMax=[%2] m_nBlkYMax=[%3]").arg(
                                 nBlkXY).arg(m_nBlkXMax).arg(m_nBlkYMax);
-                            strDebug = QString("## File=[%1] Block=[%2] Error=[%3]\n").arg(_appConfig.curFileName,
+                            LOG_DEBUG(_log, QString("## File=[%1] Block=[%2] Error=[%3]\n").arg(_appConfig.curFileName,
                                                                                            -100).arg("ImgDecode",
-                                                                                                     -10).arg(strTmp);
-                            _log.debug(strDebug);
+                                                                                                     -10).arg(strTmp));
 #else
                             Q_ASSERT(false);
 #endif
@@ -3503,7 +3447,7 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     }                             // nMcuY
 
     if (!quiet) {
-        _log.info("");
+        LOG_INFO(_log, "");
     }
 
     // ------------------------------------
@@ -3512,25 +3456,21 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
     if (!quiet) {
         // Report Compression stats
         // TODO: Should we use m_nNumSofComps?
-        strTmp = QString("  Compression stats:");
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("  Compression stats:"));
         double nCompressionRatio =
             static_cast<double>(m_nDimX * m_nDimY * m_nNumSosComps * 8) /
             static_cast<double>((m_anScanBuffPtr_pos[0] - m_nScanBuffPtr_first) * 8);
-        strTmp = QString("    Compression Ratio: %1:1").arg(nCompressionRatio, 5, 'f', 2);
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("    Compression Ratio: %1:1").arg(nCompressionRatio, 5, 'f', 2));
 
         double nBitsPerPixel =
             static_cast<double>((m_anScanBuffPtr_pos[0] - m_nScanBuffPtr_first) * 8) /
             static_cast<double>(m_nDimX * m_nDimY);
 
-        strTmp = QString("    Bits per pixel:    %1:1").arg(nBitsPerPixel, 5, 'f', 2);
-        _log.info(strTmp);
-        _log.info("");
+        LOG_INFO(_log, QString("    Bits per pixel:    %1:1").arg(nBitsPerPixel, 5, 'f', 2));
+        LOG_INFO(_log, "");
 
         // Report Huffman stats
-        strTmp = QString("  Huffman code histogram stats:");
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("  Huffman code histogram stats:"));
 
         uint32_t nDhtHistoTotal;
 
@@ -3542,33 +3482,48 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
                     nDhtHistoTotal += m_anDhtHisto[nClass][nDhtDestId][nBitLen];
                 }
 
-                strTmp = QString("    Huffman Table: (Dest ID: %1, Class: %2)").arg(nDhtDestId).arg(nClass ? "AC"
-                                                                                                           : "DC");
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("    Huffman Table: (Dest ID: %1, Class: %2)").arg(nDhtDestId).arg(nClass ? "AC"
+                                                                                                           : "DC"));
 
                 for (uint32_t nBitLen = 1; nBitLen <= MAX_DHT_CODELEN; nBitLen++) {
-                    strTmp = QString("      # codes of length %1 bits: %2 (%3%)")
+                    LOG_INFO(_log, QString("      # codes of length %1 bits: %2 (%3%)")
                         .arg(nBitLen, 2, 10, QChar('0'))
                         .arg(m_anDhtHisto[nClass][nDhtDestId][nBitLen], 8)
-                        .arg((m_anDhtHisto[nClass][nDhtDestId][nBitLen] * 100.0) / nDhtHistoTotal, 3, 'f', 0);
-                    _log.info(strTmp);
+                        .arg((m_anDhtHisto[nClass][nDhtDestId][nBitLen] * 100.0) / nDhtHistoTotal, 3, 'f', 0));
                 }
 
-                _log.info("");
+                LOG_INFO(_log, "");
             }
         }
     }
 
     if (!quiet) {
-        _log.info("  Finished Decoding SCAN Data");
-        strTmp = QString("    Number of RESTART markers decoded: %1").arg(m_nRestartRead);
-        _log.info(strTmp);
-        strTmp = QString("    Next position in scan buffer: Offset %1").arg(getScanBufPos());
-        _log.info(strTmp);
-        _log.info("");
+        LOG_INFO(_log, "  Finished Decoding SCAN Data");
+        LOG_INFO(_log, QString("    Number of RESTART markers decoded: %1").arg(m_nRestartRead));
+        LOG_INFO(_log, QString("    Next position in scan buffer: Offset %1").arg(getScanBufPos()));
+        LOG_INFO(_log, "");
     }
 }
 
+// Perceptual hash of the image from the luminance block DC values of
+// the last scan decode (see PerceptualHash.h)
+// - Only the blocks that cover the image are used, not the MCU padding
+//
+// OUTPUT:
+// - nHash                                     = The hash
+//
+// RETURN:
+// - false if there is no decoded DC map (or it is too small)
+//
+bool ImgDecode::dcPerceptualHash(uint64_t &nHash) const {
+    if (!m_pBlkDcValY || m_nDimX <= 0 || m_nDimY <= 0) return false;
+
+    const auto nWidth = qMin<uint32_t>((m_nDimX + BLK_SZ_X - 1) / BLK_SZ_X, m_nBlkXMax);
+    const auto nHeight = qMin<uint32_t>((m_nDimY + BLK_SZ_Y - 1) / BLK_SZ_Y, m_nBlkYMax);
+
+    return PerceptualHashFromDc(m_pBlkDcValY, m_nBlkXMax, nWidth, nHeight, nHash);
+}
+
 // Reset the decoder Scan Buff (at start of scan and
 // after any restart markers)
 //
@@ -3593,7 +3548,7 @@ void ImgDecode::decodeScanImg(uint32_t startPosition, bool display, bool quiet)
 // - m_bRestartRead
 // - m_nRestartMcusLeft
 //
-void ImgDecode::DecodeRestartScanBuf(uint32_t nFilePos, bool bRestart) {
+void ImgDecode::DecodeRestartScanBuf(uint64_t nFilePos, bool bRestart) {
     // Reset the state
     m_bScanEnd = false;
     m_bScanBad = false;
@@ -3639,15 +3594,15 @@ void ImgDecode::DecodeRestartScanBuf(uint32_t nFilePos, bool bRestart) {
 // - nByte                            = File byte position
 // - nBit                               = File bit position
 // RETURN:
-// - Fixed-point file offset (29b for bytes, 3b for bits)
+// - Fixed-point file offset (60b for bytes, 4b for bits)
 //
-uint32_t ImgDecode::packFileOffset(uint32_t nByte, uint32_t nBit) {
-    uint32_t nTmp;
+uint64_t ImgDecode::packFileOffset(uint64_t nByte, uint32_t nBit) {
+    uint64_t nTmp;
 
     // Note that we only really need 3 bits, but I'll keep 4
-    // so that the file offset is human readable. We will only
-    // handle files up to 2^28 bytes (256MB), so this is probably
-    // fine!
+    // so that the file offset is human readable. This leaves
+    // 60 bits for the byte position (1 EB), which covers any
+    // input we could be asked to carve.
     nTmp = (nByte << 4) + nBit;
     return nTmp;
 }
@@ -3655,12 +3610,12 @@ uint32_t ImgDecode::packFileOffset(uint32_t nByte, uint32_t nBit) {
 // Convert from file offset notation to bytes and bits
 //
 // INPUT:
-// - nPacked                    = Fixed-point file offset (29b for bytes, 3b for bits)
+// - nPacked                    = Fixed-point file offset (60b for bytes, 4b for bits)
 // OUTPUT:
 // - nByte                            = File byte position
 // - nBit                               = File bit position
 //
-void ImgDecode::unpackFileOffset(uint32_t nPacked, uint32_t &nByte, uint32_t &nBit) {
+void ImgDecode::unpackFileOffset(uint64_t nPacked, uint64_t &nByte, uint32_t &nBit) {
     nBit = nPacked & 0x7;
     nByte = nPacked >> 4;
 }
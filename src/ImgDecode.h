@@ -249,7 +249,8 @@ public:
     void reset();                 // Called during start of SOS decode
     void resetState();            // Called at start of new JFIF Decode
 
-    void decodeScanImg(uint32_t startPosition, bool display, bool quiet);
+    void decodeScanImg(uint64_t startPosition, bool display, bool quiet);
+    bool dcPerceptualHash(uint64_t &nHash) const;
 
     // Config
     void setImageDetails(uint32_t nDimX, uint32_t nDimY, uint32_t nCompsSOF, uint32_t nCompsSOS, bool bRstEn,
@@ -270,8 +271,8 @@ public:
     void ScanErrorsDisable();
     void ScanErrorsEnable();
 
-    uint32_t packFileOffset(uint32_t nByte, uint32_t nBit);
-    void unpackFileOffset(uint32_t nPacked, uint32_t &nByte, uint32_t &nBit);
+    uint64_t packFileOffset(uint64_t nByte, uint32_t nBit);
+    void unpackFileOffset(uint64_t nPacked, uint64_t &nByte, uint32_t &nBit);
 
     // Miscellaneous
     void setStatusText(const QString &text);
@@ -280,7 +281,7 @@ public:
     const QString &getStatusFilePosText() const;
 
     void reportDctMatrix();
-    void reportVlc(uint32_t nVlcPos, uint32_t nVlcAlign, uint32_t nZrl, int32_t nVal, uint32_t nCoeffStart, uint32_t nCoeffEnd, const QString &specialStr);
+    void reportVlc(uint64_t nVlcPos, uint32_t nVlcAlign, uint32_t nZrl, int32_t nVal, uint32_t nCoeffStart, uint32_t nCoeffEnd, const QString &specialStr);
 
 private:
     // DQT Table
@@ -300,7 +301,7 @@ private:
     void resetDhtLookup();
 
     QString getScanBufPos();
-    QString getScanBufPos(uint32_t pos, uint32_t align);
+    QString getScanBufPos(uint64_t pos, uint32_t align);
 
     void GenLookupHuffMask();
     uint32_t ExtractBits(uint32_t nWord, uint32_t nBits);
@@ -312,12 +313,12 @@ private:
 
     bool ExpectRestart();
     void DecodeRestartDcState();
-    void DecodeRestartScanBuf(uint32_t nFilePos, bool bRestart);
+    void DecodeRestartScanBuf(uint64_t nFilePos, bool bRestart);
     uint32_t BuffAddByte();
     void BuffTopup();
     void ScanBuffConsume(uint32_t nNumBits);
-    void ScanBuffAdd(uint32_t nNewByte, uint32_t nPtr);
-    void ScanBuffAddErr(uint32_t nNewByte, uint32_t nPtr, uint32_t nErr);
+    void ScanBuffAdd(uint32_t nNewByte, uint64_t nPtr);
+    void ScanBuffAddErr(uint32_t nNewByte, uint64_t nPtr, uint32_t nErr);
 
     // IDCT calcs
     void PrecalcIdct();
@@ -336,7 +337,7 @@ private:
     WindowBuf &_wbuf;
     SnoopConfig &_appConfig;        // Pointer to application config
 
-    uint32_t *m_pMcuFileMap;
+    uint64_t *m_pMcuFileMap;
     int32_t m_nMcuWidth;         // Width (pix) of MCU (e.g. 8,16)
     int32_t m_nMcuHeight;        // Height (pix) of MCU (e.g. 8,16)
     int32_t m_nMcuXMax;          // Number of MCUs across
@@ -435,12 +436,12 @@ private:
     uint32_t m_nScanBuff;         // 32 bits of scan data after removing stuffs
 
     uint32_t m_nScanBuff_vacant;    // Bits unused in LSB after shifting (add if >= 8)
-    uint32_t m_nScanBuffPtr;        // Next uint8_t position to load
-    uint32_t m_nScanBuffPtr_start;  // Saved first position of scan data (reset by RSTn markers)
-    uint32_t m_nScanBuffPtr_first;  // Saved first position of scan data in file (not reset by RSTn markers). For comp ratio.
+    uint64_t m_nScanBuffPtr;        // Next uint8_t position to load
+    uint64_t m_nScanBuffPtr_start;  // Saved first position of scan data (reset by RSTn markers)
+    uint64_t m_nScanBuffPtr_first;  // Saved first position of scan data in file (not reset by RSTn markers). For comp ratio.
 
     bool m_nScanCurErr;                 // Mark as soon as error occurs
-    uint32_t m_anScanBuffPtr_pos[4];    // File posn for each uint8_t in buffer
+    uint64_t m_anScanBuffPtr_pos[4];    // File posn for each uint8_t in buffer
     uint32_t m_anScanBuffPtr_err[4];    // Does this uint8_t have an error?
     uint32_t m_nScanBuffLatchErr;
     uint32_t m_nScanBuffPtr_num;        // Number of uint8_ts in buffer
@@ -48,7 +48,7 @@ static constexpr uint32_t MAX_SEGMENT_SIZE = 20 * 1014 * 1024;
 //
 // INPUT:
 // - pLog                       Ptr to log file class
-// - _writeBuf                      Ptr to Window Buf class
+// - buf                            Ptr to Window Buf class
 // - pImgDec            Ptr to Image Decoder class
 //
 // PRE:
@@ -68,6 +68,8 @@ JfifDecode::JfifDecode(ILog &log, WindowBuf &buf, ImgDecode &imgDec, SnoopConfig
 
     _imgSrcDirty = true;
 
+    _aviCheck = true;
+
     // Generate lookup tables for Huffman codes
     genLookupHuffMask();
 
@@ -93,6 +95,16 @@ void JfifDecode::reset() {
     _posEmbedEnd = 0;
     _posFileEnd = 0;
 
+    _scanLength = 0;
+    _scanRstPos.clear();
+    _identity.reset();
+    _content.reset();
+    _contentPos = 0;
+    _contentOk = true;
+    _perceptualHashTried = false;
+    _perceptualHashSet = false;
+    _perceptualHash = 0;
+
     // SOS / SOF handling
     m_nSofNumLines_Y = 0;
     m_nSofSampsPerLine_X = 0;
@@ -183,6 +195,15 @@ void JfifDecode::setAviMode(bool isAvi, bool isMjpeg) {
     _aviMjpeg = isMjpeg;
 }
 
+//-----------------------------------------------------------------------------
+// Set whether processFile() looks for an AVI header at the start of the
+// file. Callers that already know there is none can skip the extra read
+// of file offset 0 on every decode.
+//
+void JfifDecode::setAviCheck(bool check) {
+    _aviCheck = check;
+}
+
 //-----------------------------------------------------------------------------
 // Fetch the AVI mode flag for this file
 //
@@ -208,7 +229,7 @@ void JfifDecode::getAviMode(bool &isAvi, bool &isMjpeg) const {
 // RETURN:
 // - File position
 //
-uint32_t JfifDecode::getPosEmbedStart() const {
+uint64_t JfifDecode::getPosEmbedStart() const {
     return _posEmbedStart;
 }
 
@@ -221,10 +242,130 @@ uint32_t JfifDecode::getPosEmbedStart() const {
 // RETURN:
 // - File position
 //
-uint32_t JfifDecode::getPosEmbedEnd() const {
+uint64_t JfifDecode::getPosEmbedEnd() const {
     return _posEmbedEnd;
 }
 
+//-----------------------------------------------------------------------------
+// Determine if the last analysis reached an EOI marker
+// - Without one, m_nPosEmbedEnd doesn't mark the end of the image
+//
+// RETURN:
+// - true if an EOI was decoded
+//
+bool JfifDecode::getEoiFound() const {
+    return _stateEoi;
+}
+
+//-----------------------------------------------------------------------------
+// Fetch the location of the JPEG thumbnail declared in the EXIF IFD1
+//
+// OUTPUT:
+// - nOffset = File position of the thumbnail
+// - nLength = Length of the thumbnail in bytes
+//
+// RETURN:
+// - true if the last analysis found a JPEG thumbnail
+//
+bool JfifDecode::getExifThumb(uint64_t &nOffset, uint32_t &nLength) const {
+    if ((m_nImgExifThumbComp != 6) || (m_nImgExifThumbLen == 0)) {
+        return false;
+    }
+
+    nOffset = m_nImgExifThumbOffset;
+    nLength = m_nImgExifThumbLen;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Fetch the length of the entropy-coded scan data found by the last
+// analysis, including any RSTn markers (summed over all scans)
+//
+// RETURN:
+// - Length in bytes
+//
+uint64_t JfifDecode::getScanLength() const {
+    return _scanLength;
+}
+
+//-----------------------------------------------------------------------------
+// Fetch the identity of the image found by the last analysis
+// - XXH64 over the frame-defining marker segments (DQT, DHT, DAC, SOFn,
+//   DRI and SOS) and the scan data with its byte stuffing removed, in
+//   file order. APPn and COM segments are left out, so copies that only
+//   differ in their metadata share an identity.
+//
+// RETURN:
+// - The hash, and the number of bytes hashed (0 if no scan was found)
+//
+ContentKey JfifDecode::getIdentity() const {
+    if (!_stateSos) return {0, 0};
+
+    return _identity.key();
+}
+
+// XXH64 of every byte of the image, from its start up to nPosEnd
+// - The scan data is hashed during the pass 1 skip, while it is in the
+//   buffer window, and only the marker segments around it are read
+//   again here. With the scan dump on, the skip is byte-wise and the
+//   whole image is read again.
+// - Can be called again with the same nPosEnd
+//
+// INPUT:
+// - nPosEnd                    End of the image (exclusive)
+//
+// OUTPUT:
+// - key                        The hash and the number of bytes hashed
+//
+// RETURN:
+// - false if the image couldn't be read up to nPosEnd
+//
+bool JfifDecode::getContentKey(uint64_t nPosEnd, ContentKey &key) {
+    if (nPosEnd < _contentPos) {
+        _contentOk = false;
+    }
+
+    // Start over from the image start if the running hash fell behind
+    if (!_contentOk) {
+        _content.reset();
+        _contentPos = _posEmbedStart;
+        _contentOk = true;
+    }
+
+    hashContentTo(nPosEnd);
+    if (!_contentOk) return false;
+
+    key = _content.key();
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Fetch the perceptual hash of the image found by the last analysis
+// - Taken from the DC values of the first scan when
+//   SnoopConfig::perceptualHash() is set (see PerceptualHash.h)
+//
+// OUTPUT:
+// - nHash                      The hash
+//
+// RETURN:
+// - false if no hash was taken (eg. progressive or CMYK images)
+//
+bool JfifDecode::getPerceptualHash(uint64_t &nHash) const {
+    nHash = _perceptualHash;
+    return _perceptualHashSet;
+}
+
+//-----------------------------------------------------------------------------
+// Fetch the positions of the RSTn markers found in the scan data by the
+// last analysis
+//
+// RETURN:
+// - File positions of the 0xFF of each marker, in file order
+//
+const std::vector<uint64_t> &JfifDecode::getScanRstPos() const {
+    return _scanRstPos;
+}
+
 //-----------------------------------------------------------------------------
 // Determine if the last analysis revealed a JFIF with known markers
 //
@@ -267,6 +408,51 @@ void JfifDecode::getDecodeSummary(QString &strHash, QString &strHashRot, QString
     eDbReqSuggest = m_eDbReqSuggest;
 }
 
+//-----------------------------------------------------------------------------
+// Fetch the summary of the last analysis
+// - Filled from the decoder state, so it is complete even when the
+//   text log is disabled
+//
+// OUTPUT:
+// - sInfo                  = Image position, frame, quality and EXIF details
+//
+void JfifDecode::getImageInfo(ImageInfo &sInfo) const {
+    sInfo.nPosStart = _posEmbedStart;
+    sInfo.nPosEnd = _posEmbedEnd;
+    sInfo.bEoiFound = _stateEoi;
+
+    sInfo.bProgressive = m_bImgProgressive;
+    sInfo.nPrecision = _stateSof ? m_nSofPrecision_P : 0;
+    sInfo.nWidth = m_nSofSampsPerLine_X;
+    sInfo.nHeight = m_nSofNumLines_Y;
+    sInfo.nNumComps = m_nSofNumComps_Nf;
+    sInfo.strSubsampling = (m_strImgQuantCss == "?x?") ? QString() : m_strImgQuantCss;
+
+    sInfo.dQualLum = m_abImgDqtSet[0] ? m_adImgDqtQual[0] : -1.0;
+    sInfo.dQualChr = m_abImgDqtSet[1] ? m_adImgDqtQual[1] : -1.0;
+    sInfo.nQualPhotoshopSa = m_nImgQualPhotoshopSa;
+    sInfo.nQualPhotoshopSfw = m_nImgQualPhotoshopSfw;
+
+    sInfo.strExifMake = (m_strImgExifMake == "???") ? QString() : m_strImgExifMake;
+    sInfo.strExifModel = (m_strImgExifModel == "???") ? QString() : m_strImgExifModel;
+    sInfo.strExifQual = m_strImgQualExif;
+    sInfo.strSoftware = m_strSoftware;
+    sInfo.strHash = (m_strHash == "NONE") ? QString() : m_strHash;
+    sInfo.strHashRot = (m_strHashRot == "NONE") ? QString() : m_strHashRot;
+
+    sInfo.nThumbOffset = 0;
+    sInfo.nThumbLength = 0;
+    getExifThumb(sInfo.nThumbOffset, sInfo.nThumbLength);
+
+    sInfo.nScanLength = _scanLength;
+
+    const auto identity = getIdentity();
+    sInfo.nIdentityHash = identity.hash;
+    sInfo.nIdentityLength = identity.length;
+
+    sInfo.bPerceptualHash = getPerceptualHash(sInfo.nPerceptualHash);
+}
+
 //-----------------------------------------------------------------------------
 // Fetch an element from the "standard" luminance quantization table
 //
@@ -400,7 +586,7 @@ void JfifDecode::genLookupHuffMask() {
 // RETURN:
 // - Byte from file (or local table)
 //
-uint8_t JfifDecode::getByte(uint32_t nOffset, bool bClean = false) {
+uint8_t JfifDecode::getByte(uint64_t nOffset, bool bClean = false) {
     // Buffer can be redirected to internal array for AVI DHT
     // tables, so check for it here.
     if (_bufFakeDht) return _motionJpegDhtSeg[nOffset];
@@ -428,7 +614,7 @@ uint8_t JfifDecode::getByte(uint32_t nOffset, bool bClean = false) {
 //
 void JfifDecode::dbgAddLine(const QString &strLine) {
     if (_verbose) {
-        _log.info(strLine);
+        LOG_INFO(_log, strLine);
     }
 }
 
@@ -1947,23 +2133,22 @@ bool JfifDecode::decodeMakerSubType() {
         if (strTmp == "Nikon") {
             if (getByte(_pos + 6) == 1) {
                 // Type 1
-                _log.info("    Nikon Makernote Type 1 detected");
+                LOG_INFO(_log, "    Nikon Makernote Type 1 detected");
                 m_nImgExifMakeSubtype = 1;
                 _pos += 8;
             } else if (getByte(_pos + 6) == 2) {
                 // Type 3
-                _log.info("    Nikon Makernote Type 3 detected");
+                LOG_INFO(_log, "    Nikon Makernote Type 3 detected");
                 m_nImgExifMakeSubtype = 3;
                 _pos += 18;
             } else {
-                strTmp = "Unknown Nikon Makernote Type";
-                _log.error(strTmp);
+                LOG_ERROR(_log, "Unknown Nikon Makernote Type");
 
                 return false;
             }
         } else {
             // Type 2
-            _log.info("    Nikon Makernote Type 2 detected");
+            LOG_INFO(_log, "    Nikon Makernote Type 2 detected");
             //m_nImgExifMakeSubtype = 2;
             // tests on D1 seem to indicate that it uses Type 1 headers
             m_nImgExifMakeSubtype = 1;
@@ -1981,8 +2166,7 @@ bool JfifDecode::decodeMakerSubType() {
             // Now skip over the 8-chars and 2 unknown chars
             _pos += 10;
         } else {
-            strTmp = "Unknown SIGMA Makernote identifier";
-            _log.error(strTmp);
+            LOG_ERROR(_log, "Unknown SIGMA Makernote identifier");
 
             return false;
         }
@@ -2002,8 +2186,7 @@ bool JfifDecode::decodeMakerSubType() {
             // FIXME: Do I need to dereference this pointer?
             _pos += 12;
         } else {
-            strTmp = "Unknown FUJIFILM Makernote identifier";
-            _log.error(strTmp);
+            LOG_ERROR(_log, "Unknown FUJIFILM Makernote identifier");
 
             return false;
         }
@@ -2022,8 +2205,7 @@ bool JfifDecode::decodeMakerSubType() {
             // Now skip over the 9-chars and 3 null chars
             _pos += 12;
         } else {
-            strTmp = "Unknown SONY Makernote identifier";
-            _log.error(strTmp);
+            LOG_ERROR(_log, "Unknown SONY Makernote identifier");
 
             return false;
         }
@@ -2044,7 +2226,7 @@ bool JfifDecode::decodeMakerSubType() {
 // RETURN:
 // - Was the conversion successful?
 //
-bool JfifDecode::decodeValRational(uint32_t nPos, double &nVal) {
+bool JfifDecode::decodeValRational(uint64_t nPos, double &nVal) {
     int nValNumer;
 
     int nValDenom;
@@ -2073,7 +2255,7 @@ bool JfifDecode::decodeValRational(uint32_t nPos, double &nVal) {
 // RETURN:
 // - Formatted string
 //
-QString JfifDecode::decodeValFraction(uint32_t nPos) {
+QString JfifDecode::decodeValFraction(uint64_t nPos) {
     QString strTmp;
 
     int nValNumer = readSwap4(nPos + 0);
@@ -2142,7 +2324,7 @@ bool JfifDecode::printValGps(uint32_t nCount, double fCoord1, double fCoord2, do
 // RETURN:
 // - Was the conversion successful?
 //
-bool JfifDecode::decodeValGps(uint32_t nPos, QString &strCoord) {
+bool JfifDecode::decodeValGps(uint64_t nPos, QString &strCoord) {
     double fCoord1 = 0;
     double fCoord2 = 0;
     double fCoord3 = 0;
@@ -2182,7 +2364,7 @@ bool JfifDecode::decodeValGps(uint32_t nPos, QString &strCoord) {
 // RETURN:
 // - UINT16 from buffer
 //
-uint32_t JfifDecode::readSwap2(uint32_t nPos) {
+uint32_t JfifDecode::readSwap2(uint64_t nPos) {
     return byteSwap2(getByte(nPos + 0), getByte(nPos + 1));
 }
 
@@ -2195,7 +2377,7 @@ uint32_t JfifDecode::readSwap2(uint32_t nPos) {
 // RETURN:
 // - UINT32 from buffer
 //
-uint32_t JfifDecode::readSwap4(uint32_t nPos) {
+uint32_t JfifDecode::readSwap4(uint64_t nPos) {
     return byteSwap4(getByte(nPos), getByte(nPos + 1), getByte(nPos + 2), getByte(nPos + 3));
 }
 
@@ -2208,7 +2390,7 @@ uint32_t JfifDecode::readSwap4(uint32_t nPos) {
 // RETURN:
 // - UINT32 from buffer
 //
-uint32_t JfifDecode::readBe4(uint32_t nPos) {
+uint32_t JfifDecode::readBe4(uint64_t nPos) {
     // Big endian, no swap required
     return (getByte(nPos) << 24) + (getByte(nPos + 1) << 16) + (getByte(nPos + 2) << 8) + getByte(nPos + 3);
 }
@@ -2399,7 +2581,7 @@ QString JfifDecode::printAsHex32(uint32_t *anWords, uint32_t nCount) {
 // NOTE:
 // - IFD1 typically contains the thumbnail
 //
-uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart, uint32_t nStartIfdPtr) {
+uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint64_t nPosExifStart, uint32_t nStartIfdPtr) {
     // Temp variables
     bool bRet;
 
@@ -2457,8 +2639,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
     // Move the file pointer to the start of the IFD
     _pos = nPosExifStart + nStartIfdPtr;
 
-    strTmp = QString("  EXIF %1 @ Absolute 0x%2").arg(strIfd).arg(_pos, 8, 16, QChar('0'));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("  EXIF %1 @ Absolute 0x%2").arg(strIfd).arg(_pos, 8, 16, QChar('0')));
 
     ////////////
 
@@ -2479,8 +2660,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
         m_bImgExifMakernotes = true;
 
         if (!_appConfig.decodeMaker()) {
-            strTmp = QString("    Makernote decode option not enabled.");
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("    Makernote decode option not enabled."));
 
             // If user didn't enable makernote decode, don't exit, just
             // hide output. We still want to get at some info (such as Quality setting).
@@ -2489,8 +2669,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
 
         // If this Make is not supported, we'll need to exit
         if (!m_bImgExifMakeSupported) {
-            strTmp = QString("    Makernotes not yet supported for [%1]").arg(m_strImgExifMake);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("    Makernotes not yet supported for [%1]").arg(m_strImgExifMake));
             return 2;
         }
 
@@ -2517,8 +2696,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
 
     nIfdDirLen = readSwap2(_pos);
     _pos += 2;
-    strTmp = QString("    Dir Length = 0x%1").arg(nIfdDirLen, 4, 16, QChar('0'));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("    Dir Length = 0x%1").arg(nIfdDirLen, 4, 16, QChar('0')));
 
     // =========== EXIF IFD Header (End) ===========
 
@@ -2576,8 +2754,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
             // didn't handle the large dataset elsewhere.
             // For now, only report this warning if we are not processing MakerNote
             if (strIfdTag != "MakerNote") {
-                strTmp = QString("      Excessive # components (%1). Limiting to first 4000.").arg(nIfdNumComps);
-                _log.warn(strTmp);
+                LOG_WARN(_log, QString("      Excessive # components (%1). Limiting to first 4000.").arg(nIfdNumComps));
             }
             nIfdNumComps = 4000;
         }
@@ -3520,8 +3697,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
 
             if ((nHorzRepeat < 16) && (nVertRepeat < 16)) {
                 bExtraDecode = true;
-                strTmp = QString("    [%1] =").arg(strIfdTag, -36);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("    [%1] =").arg(strIfdTag, -36));
 
                 for (uint32_t nY = 0; nY < nVertRepeat; nY++) {
                     strLine = QString("     %1  = [ ").arg("", -36);
@@ -3563,7 +3739,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
                     }
 
                     strLine.append("]");
-                    _log.info(strLine);
+                    LOG_INFO(_log, strLine);
                 }
             }
         }
@@ -3591,8 +3767,7 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
                 bExtraDecode = true;
 
                 if ((!_appConfig.hideUnknownExif()) || (!nIfdTagUnknown)) {
-                    strTmp = QString("    [%1]").arg(strIfdTag, -36);
-                    _log.info(strTmp);
+                    LOG_INFO(_log, QString("    [%1]").arg(strIfdTag, -36));
 
                     // Assume it is a maker field with subentries!
 
@@ -3606,10 +3781,10 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
                             strValTmp = QString("      [%1] = %2").arg(strMaker, -34).arg(strRetVal.strVal);
 
                             if ((!_appConfig.hideUnknownExif()) || (!strRetVal.bUnknown)) {
-                                _log.info(strValTmp);
+                                LOG_INFO(_log, strValTmp);
                             }
                         } else if (ind == MAX_anValues) {
-                            _log.info("      [... etc ...]");
+                            LOG_INFO(_log, "      [... etc ...]");
                         } else {
                             // Don't print!
                         }
@@ -3754,12 +3929,10 @@ uint32_t JfifDecode::decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart
             if ((!_appConfig.hideUnknownExif()) || (!nIfdTagUnknown)) {
                 // If the tag is an ASCII string, we want to wrap with quote marks
                 if (nIfdFormat == 2) {
-                    strTmp = QString("    [%1] = \"%2\"").arg(strIfdTag, -36).arg(strValOut);
+                    LOG_INFO(_log, QString("    [%1] = \"%2\"").arg(strIfdTag, -36).arg(strValOut));
                 } else {
-                    strTmp = QString("    [%1] = %2").arg(strIfdTag, -36).arg(strValOut);
+                    LOG_INFO(_log, QString("    [%1] = %2").arg(strIfdTag, -36).arg(strValOut));
                 }
-
-                _log.info(strTmp);
             }
         }
 
@@ -3827,7 +4000,7 @@ uint32_t JfifDecode::decodeApp13Ps() {
 
 //-----------------------------------------------------------------------------
 // Start decoding a single ICC header segment @ nPos
-uint32_t JfifDecode::decodeIccHeader(uint32_t nPos) {
+uint32_t JfifDecode::decodeIccHeader(uint64_t nPos) {
     QString strTmp, strTmp1;
 
     // Profile header
@@ -3917,21 +4090,17 @@ uint32_t JfifDecode::decodeIccHeader(uint32_t nPos) {
     nPos += 4;
 
     // Now output the formatted version of the above data structures
-    strTmp = QString("        %1 : %2 bytes").arg("Profile Size", -33).arg(nProfSz);
-    _log.info(strTmp);
-
-    strTmp = QString("        %1 : %2").arg("Preferred CMM Type", -33).arg(Uint2Chars(nPrefCmmType));
-    _log.info(strTmp);
-
-    strTmp =
-        QString("        %1 : %2.%3.%4.%5 (0x%6)")
-            .arg("Profile Version", -33)
-            .arg((nProfVer & 0xF0000000) >> 28)
-            .arg((nProfVer & 0x0F000000) >> 24)
-            .arg((nProfVer & 0x00F00000) >> 20)
-            .arg((nProfVer & 0x000F0000) >> 16)
-            .arg(nProfVer, 8, 16, QChar('0'));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2 bytes").arg("Profile Size", -33).arg(nProfSz));
+
+    LOG_INFO(_log, QString("        %1 : %2").arg("Preferred CMM Type", -33).arg(Uint2Chars(nPrefCmmType)));
+
+    LOG_INFO(_log, QString("        %1 : %2.%3.%4.%5 (0x%6)")
+        .arg("Profile Version", -33)
+        .arg((nProfVer & 0xF0000000) >> 28)
+        .arg((nProfVer & 0x0F000000) >> 24)
+        .arg((nProfVer & 0x00F00000) >> 20)
+        .arg((nProfVer & 0x000F0000) >> 16)
+        .arg(nProfVer, 8, 16, QChar('0')));
 
     switch (nProfDevClass) {
         //CAL! case 'scnr':
@@ -3960,9 +4129,7 @@ uint32_t JfifDecode::decodeIccHeader(uint32_t nPos) {
             strTmp1 = QString("? (0x%1)").arg(nProfDevClass, 8, 16, QChar('0'));
             break;
     }
-    strTmp = QString("        %1 : %2 (%3)").arg("Profile Device/Class",
-                                                 -33).arg(strTmp1).arg(Uint2Chars(nProfDevClass));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2 (%3)").arg("Profile Device/Class", -33).arg(strTmp1).arg(Uint2Chars(nProfDevClass)));
 
     switch (nDataColorSpace) {
         case FOURC_INT('X', 'Y', 'Z', ' '):
@@ -4044,18 +4211,13 @@ uint32_t JfifDecode::decodeIccHeader(uint32_t nPos) {
             strTmp1 = QString("? (0x%1)").arg(nDataColorSpace, 8, 16, QChar('0'));
             break;
     }
-    strTmp = QString("        %1 : %2 (%3)").arg("Data Colour Space",
-                                                 -33).arg(strTmp1).arg(Uint2Chars(nDataColorSpace));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2 (%3)").arg("Data Colour Space", -33).arg(strTmp1).arg(Uint2Chars(nDataColorSpace)));
 
-    strTmp = QString("        %1 : %2").arg("Profile connection space (PCS)", -33).arg(Uint2Chars(nPcs));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2").arg("Profile connection space (PCS)", -33).arg(Uint2Chars(nPcs)));
 
-    strTmp = QString("        %1 : %2").arg("Profile creation date", -33).arg(decodeIccDateTime(anDateTimeCreated));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2").arg("Profile creation date", -33).arg(decodeIccDateTime(anDateTimeCreated)));
 
-    strTmp = QString("        %1 : %2").arg("Profile file signature", -33).arg(Uint2Chars(nProfFileSig));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2").arg("Profile file signature", -33).arg(Uint2Chars(nProfFileSig)));
 
     switch (nPrimPlatSig) {
         case FOURC_INT('A', 'P', 'P', 'L'):
@@ -4075,51 +4237,40 @@ uint32_t JfifDecode::decodeIccHeader(uint32_t nPos) {
             break;
     }
 
-    strTmp = QString("        %1 : %2 (%3)").arg("Primary platform", -33).arg(strTmp1).arg(Uint2Chars(nPrimPlatSig));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2 (%3)").arg("Primary platform", -33).arg(strTmp1).arg(Uint2Chars(nPrimPlatSig)));
 
-    strTmp = QString("        %1 : 0x%2").arg("Profile flags", -33).arg(nProfFlags, 8, 16, QChar('0'));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : 0x%2").arg("Profile flags", -33).arg(nProfFlags, 8, 16, QChar('0')));
     strTmp1 = (TestBit(nProfFlags, 0)) ? "Embedded profile" : "Profile not embedded";
-    strTmp = QString("        %1 > %2").arg("Profile flags", -35).arg(strTmp1);
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 > %2").arg("Profile flags", -35).arg(strTmp1));
     strTmp1 =
         (TestBit(nProfFlags, 1)) ? "Profile can be used independently of embedded" :
         "Profile can't be used independently of embedded";
-    strTmp = QString("        %1 > %2").arg("Profile flags", -35).arg(strTmp1);
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 > %2").arg("Profile flags", -35).arg(strTmp1));
 
-    strTmp = QString("        %1 : %2").arg("Device Manufacturer", -33).arg(Uint2Chars(nDevManuf));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2").arg("Device Manufacturer", -33).arg(Uint2Chars(nDevManuf)));
 
-    strTmp = QString("        %1 : %2").arg("Device Model", -33).arg(Uint2Chars(nDevModel));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2").arg("Device Model", -33).arg(Uint2Chars(nDevModel)));
 
-    strTmp = QString("        %1 : 0x%2_%3")
+    LOG_INFO(_log, QString("        %1 : 0x%2_%3")
         .arg("Device attributes", -33)
         .arg(anDevAttrib[1], 8, 16, QChar('0'))
-        .arg(anDevAttrib[0], 8, 16, QChar('0'));
-    _log.info(strTmp);
+        .arg(anDevAttrib[0], 8, 16, QChar('0')));
     strTmp1 = (TestBit(anDevAttrib[0], 0)) ? "Transparency" : "Reflective";
-    strTmp = QString("        %1 > %2")
+    LOG_INFO(_log, QString("        %1 > %2")
         .arg("Device attributes", -35)
-        .arg(strTmp1);
-    _log.info(strTmp);
+        .arg(strTmp1));
     strTmp1 = (TestBit(anDevAttrib[0], 1)) ? "Matte" : "Glossy";
-    strTmp = QString("        %1 > %2")
+    LOG_INFO(_log, QString("        %1 > %2")
         .arg("Device attributes", -35)
-        .arg(strTmp1);
-    _log.info(strTmp);
+        .arg(strTmp1));
     strTmp1 = (TestBit(anDevAttrib[0], 2)) ? "Media polarity = positive" : "Media polarity = negative";
-    strTmp = QString("        %1 > %2")
+    LOG_INFO(_log, QString("        %1 > %2")
         .arg("Device attributes", -35)
-        .arg(strTmp1);
-    _log.info(strTmp);
+        .arg(strTmp1));
     strTmp1 = (TestBit(anDevAttrib[0], 3)) ? "Colour media" : "Black & white media";
-    strTmp = QString("        %1 > %2")
+    LOG_INFO(_log, QString("        %1 > %2")
         .arg("Device attributes", -35)
-        .arg(strTmp1);
-    _log.info(strTmp);
+        .arg(strTmp1));
 
     switch (nRenderIntent) {
         case 0x00000000:
@@ -4139,22 +4290,18 @@ uint32_t JfifDecode::decodeIccHeader(uint32_t nPos) {
             break;
     }
 
-    strTmp = QString("        %1 : %2").arg("Rendering intent", -33).arg(strTmp1);
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2").arg("Rendering intent", -33).arg(strTmp1));
 
     // PCS illuminant
 
-    strTmp = QString("        %1 : %2").arg("Profile creator", -33).arg(Uint2Chars(nProfCreatorSig));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : %2").arg("Profile creator", -33).arg(Uint2Chars(nProfCreatorSig)));
 
-    strTmp =
-        QString("        %1 : 0x%2_%3_%4_%5")
-            .arg("Profile ID", -33)
-            .arg(anProfId[3], 8, 16, QChar('0'))
-            .arg(anProfId[2], 8, 16, QChar('0'))
-            .arg(anProfId[1], 8, 16, QChar('0'))
-            .arg(anProfId[0], 8, 16, QChar('0'));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("        %1 : 0x%2_%3_%4_%5")
+        .arg("Profile ID", -33)
+        .arg(anProfId[3], 8, 16, QChar('0'))
+        .arg(anProfId[2], 8, 16, QChar('0'))
+        .arg(anProfId[1], 8, 16, QChar('0'))
+        .arg(anProfId[0], 8, 16, QChar('0')));
 
     return 0;
 }
@@ -4196,20 +4343,19 @@ uint32_t JfifDecode::decodeApp2IccProfile(uint32_t nLen) {
 
     uint32_t nPayloadLen;         // Len of this ICC marker payload
 
-    uint32_t nMarkerPosStart;
+    uint64_t nMarkerPosStart;
 
     nMarkerSeqNum = getByte(_pos++);
     nNumMarkers = getByte(_pos++);
     nPayloadLen = nLen - 2 - 12 - 2;      // TODO: check?
 
-    strTmp = QString("      Marker Number = %1 of %2").arg(nMarkerSeqNum).arg(nNumMarkers);
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("      Marker Number = %1 of %2").arg(nMarkerSeqNum).arg(nNumMarkers));
 
     if (nMarkerSeqNum == 1) {
         nMarkerPosStart = _pos;
         decodeIccHeader(nMarkerPosStart);
     } else {
-        _log.warn("      Only support decode of 1st ICC Marker");
+        LOG_WARN(_log, "      Only support decode of 1st ICC Marker");
     }
 
     return 0;
@@ -4249,16 +4395,13 @@ uint32_t JfifDecode::decodeApp2FlashPix() {
 
     if (nFpxSegType == 1) {
         // Contents List
-        strTmp = QString("    Segment: CONTENTS LIST");
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("    Segment: CONTENTS LIST"));
 
         nFpxInteropCnt = (getByte(_pos++) << 8) + getByte(_pos++);
-        strTmp = QString("      Interoperability Count = %1").arg(nFpxInteropCnt);
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      Interoperability Count = %1").arg(nFpxInteropCnt));
 
         for (uint32_t ind = 0; ind < nFpxInteropCnt; ind++) {
-            strTmp = QString("      Entity Index #%1").arg(ind);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("      Entity Index #%1").arg(ind));
             nFpxEntitySz = (getByte(_pos++) << 24) + (getByte(_pos++) << 16) + (getByte(_pos++) << 8) + getByte(_pos++);
 
             // If the "entity size" field is 0xFFFFFFFF, then it should be treated as
@@ -4271,11 +4414,9 @@ uint32_t JfifDecode::decodeApp2FlashPix() {
             }
 
             if (!bFpxStorage) {
-                strTmp = QString("        Entity Size = %1").arg(nFpxEntitySz);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("        Entity Size = %1").arg(nFpxEntitySz));
             } else {
-                strTmp = "        Entity is Storage";
-                _log.info(strTmp);
+                LOG_INFO(_log, "        Entity is Storage");
             }
 
             nFpxDefault = getByte(_pos++);
@@ -4285,8 +4426,7 @@ uint32_t JfifDecode::decodeApp2FlashPix() {
             streamStr = _wbuf.readUniStr2(_pos, MAX_BUF_READ_STR);
             _pos += 2 * (static_cast<uint32_t>(streamStr.length()) + 1);        // 2x because unicode
 
-            strTmp = QString("        Stream Name = [%1]").arg(streamStr);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("        Stream Name = [%1]").arg(streamStr));
 
             // In the case of "storage", we decode the next 16 bytes as the class
             if (bFpxStorage) {
@@ -4312,24 +4452,20 @@ uint32_t JfifDecode::decodeApp2FlashPix() {
                     .arg(getByte(_pos + 14), 2, 16, QChar('0'))
                     .arg(getByte(_pos + 15), 2, 16, QChar('0'));
                 _pos += 16;
-                strTmp = QString("        Storage Class = [%1]").arg(strFpxStorageClsStr);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("        Storage Class = [%1]").arg(strFpxStorageClsStr));
             }
         }
 
         return 0;
     } else if (nFpxSegType == 2) {
         // Stream Data
-        strTmp = "    Segment: STREAM DATA";
-        _log.info(strTmp);
+        LOG_INFO(_log, "    Segment: STREAM DATA");
 
         nFpxStIndexCont = (getByte(_pos++) << 8) + getByte(_pos++);
-        strTmp = QString("      Index in Contents List = %1").arg(nFpxStIndexCont);
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      Index in Contents List = %1").arg(nFpxStIndexCont));
 
         nFpxStOffset = (getByte(_pos++) << 24) + (getByte(_pos++) << 16) + (getByte(_pos++) << 8) + getByte(_pos++);
-        strTmp = QString("      Offset in stream = %1 (0x%2)").arg(nFpxStOffset).arg(nFpxStOffset, 8, 16, QChar('0'));
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      Offset in stream = %1 (0x%2)").arg(nFpxStOffset).arg(nFpxStOffset, 8, 16, QChar('0')));
 
         // Now decode the Property Set Header
 
@@ -4364,27 +4500,22 @@ uint32_t JfifDecode::decodeApp2FlashPix() {
         _pos += 16;
         nFpxStRsvd = (getByte(_pos++) << 8) + getByte(_pos++);
 
-        strTmp = QString("      ByteOrder = 0x%1").arg(nFpxStWByteOrder, 4, 16, QChar('0'));
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      ByteOrder = 0x%1").arg(nFpxStWByteOrder, 4, 16, QChar('0')));
 
-        strTmp = QString("      Format = 0x%1").arg(nFpxStWFormat, 4, 16, QChar('0'));
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      Format = 0x%1").arg(nFpxStWFormat, 4, 16, QChar('0')));
 
-        strTmp = QString("      OSVer = 0x%1").arg(nFpxStDwOsVer, 8, 16, QChar('0'));
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      OSVer = 0x%1").arg(nFpxStDwOsVer, 8, 16, QChar('0')));
 
-        strTmp = QString("      clsid = %1").arg(strFpxStClsidStr);
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      clsid = %1").arg(strFpxStClsidStr));
 
-        strTmp = QString("      reserved = 0x%1").arg(nFpxStRsvd, 8, 16, QChar('0'));
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("      reserved = 0x%1").arg(nFpxStRsvd, 8, 16, QChar('0')));
 
         // ....
 
         return 2;
 
     } else {
-        _log.error("      Reserved Segment. Stopping.");
+        LOG_ERROR(_log, "      Reserved Segment. Stopping.");
         return 1;
     }
 }
@@ -4405,8 +4536,8 @@ void JfifDecode::decodeDht(bool bInject) {
 
     QString strTmp, strFull;
 
-    uint32_t nPosEnd;
-    uint32_t nPosSaved = 0;
+    uint64_t nPosEnd;
+    uint64_t nPosSaved = 0;
 
     bool bRet;
 
@@ -4424,8 +4555,7 @@ void JfifDecode::decodeDht(bool bInject) {
     nLength = getByte(_pos) * 256 + getByte(_pos + 1);
     nPosEnd = _pos + nLength;
     _pos += 2;
-    strTmp = QString("  Huffman table length = %1").arg(nLength);
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("  Huffman table length = %1").arg(nLength));
 
     uint32_t nDhtClass_Tc;        // Range 0..1
     uint32_t nDhtHuffTblId_Th;    // Range 0..3
@@ -4435,28 +4565,24 @@ void JfifDecode::decodeDht(bool bInject) {
     // See BUG FIX #1003
 
     while ((!_stateAbort) && (nPosEnd > _pos)) {
-        _log.info("  ----");
+        LOG_INFO(_log, "  ----");
 
         nTmpVal = getByte(_pos++);
         nDhtClass_Tc = (nTmpVal & 0xF0) >> 4;       // Tc, range 0..1
         nDhtHuffTblId_Th = nTmpVal & 0x0F;  // Th, range 0..3
-        strTmp = QString("  Destination ID = %1").arg(nDhtHuffTblId_Th);
-        _log.info(strTmp);
-        strTmp = QString("  Class = %1 (%2)").arg(nDhtClass_Tc).arg(nDhtClass_Tc ? "AC Table" : "DC / Lossless Table");
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("  Destination ID = %1").arg(nDhtHuffTblId_Th));
+        LOG_INFO(_log, QString("  Class = %1 (%2)").arg(nDhtClass_Tc).arg(nDhtClass_Tc ? "AC Table" : "DC / Lossless Table"));
 
         // Add in some error checking to prevent
         if (nDhtClass_Tc >= MAX_DHT_CLASS) {
-            strTmp = QString("Invalid DHT Class (%1). Aborting DHT Load.").arg(nDhtClass_Tc);
-            _log.error(strTmp);
+            LOG_ERROR(_log, QString("Invalid DHT Class (%1). Aborting DHT Load.").arg(nDhtClass_Tc));
             _pos = nPosEnd;
             //m_bStateAbort = true; // Stop decoding
             break;
         }
 
         if (nDhtHuffTblId_Th >= MAX_DHT_DEST_ID) {
-            strTmp = QString("Invalid DHT Dest ID (%1). Aborting DHT Load.").arg(nDhtHuffTblId_Th);
-            _log.error(strTmp);
+            LOG_ERROR(_log, QString("Invalid DHT Dest ID (%1). Aborting DHT Load.").arg(nDhtHuffTblId_Th));
             _pos = nPosEnd;
             //m_bStateAbort = true; // Stop decoding
             break;
@@ -4486,23 +4612,28 @@ void JfifDecode::decodeDht(bool bInject) {
             // Keep a total count of the number of DHT codes read
             nDhtCodesTotal += m_anDhtNumCodesLen_Li[nIndLen];
 
-            strFull = QString("    Codes of length %1 bits (%2 total): ")
-                .arg(nIndLen, 2, 10, QChar('0'))
-                .arg(m_anDhtNumCodesLen_Li[nIndLen], 3, 10, QChar('0'));
+            if (LOG_INFO_ON(_log)) {
+                strFull = QString("    Codes of length %1 bits (%2 total): ")
+                    .arg(nIndLen, 2, 10, QChar('0'))
+                    .arg(m_anDhtNumCodesLen_Li[nIndLen], 3, 10, QChar('0'));
+            }
 
             for (uint32_t nIndCode = 0; ((!_stateAbort) && (nIndCode < m_anDhtNumCodesLen_Li[nIndLen])); nIndCode++) {
-                // Start a new line for every 16 codes
-                if ((nIndCode != 0) && ((nIndCode % 16) == 0)) {
-                    strFull = "                                         ";
-                }
-
                 nTmpVal = getByte(_pos++);
-                strTmp = QString("%1 ").arg(nTmpVal, 2, 16, QChar('0'));
-                strFull += strTmp;
+
+                if (LOG_INFO_ON(_log)) {
+                    // Start a new line for every 16 codes
+                    if ((nIndCode != 0) && ((nIndCode % 16) == 0)) {
+                        strFull = "                                         ";
+                    }
+
+                    strTmp = QString("%1 ").arg(nTmpVal, 2, 16, QChar('0'));
+                    strFull += strTmp;
+                }
 
                 // Only write 16 codes per line
                 if ((nIndCode % 16) == 15) {
-                    _log.info(strFull);
+                    LOG_INFO(_log, strFull);
                     strFull.clear();
                 }
 
@@ -4513,8 +4644,7 @@ void JfifDecode::decodeDht(bool bInject) {
                     anDhtCodeVal[nDhtInd++] = nTmpVal;    // Vij, range 0..255
                 } else {
                     nDhtInd++;
-                    strTmp = QString("Excessive DHT entries (%1)... skipping").arg(nDhtInd);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("Excessive DHT entries (%1)... skipping").arg(nDhtInd));
 
                     if (!_stateAbort) {
                         decodeErrCheck(true);
@@ -4522,11 +4652,10 @@ void JfifDecode::decodeDht(bool bInject) {
                 }
             }
 
-            _log.info(strFull);
+            LOG_INFO(_log, strFull);
         }
 
-        strTmp = QString("    Total number of codes: %1").arg(nDhtCodesTotal, 3, 10, QChar('0'));
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("    Total number of codes: %1").arg(nDhtCodesTotal, 3, 10, QChar('0')));
 
         uint32_t nDhtLookupInd = 0;
 
@@ -4536,15 +4665,14 @@ void JfifDecode::decodeDht(bool bInject) {
         nDhtInd = 0;
 
         if (_appConfig.expandDht()) {
-            _log.info("");
-            _log.info("  Expanded Form of Codes:");
+            LOG_INFO(_log, "");
+            LOG_INFO(_log, "  Expanded Form of Codes:");
         }
 
         for (uint32_t nBitLen = 1; ((!_stateAbort) && (nBitLen <= 16)); nBitLen++) {
             if (m_anDhtNumCodesLen_Li[nBitLen] > 0) {
                 if (_appConfig.expandDht()) {
-                    strTmp = QString("    Codes of length %1 bits:").arg(nBitLen, 2, 10, QChar('0'));
-                    _log.info(strTmp);
+                    LOG_INFO(_log, QString("    Codes of length %1 bits:").arg(nBitLen, 2, 10, QChar('0')));
                 }
 
                 // Codes exist for this bit-length
@@ -4580,10 +4708,9 @@ void JfifDecode::decodeDht(bool bInject) {
                             }
                         }
 
-                        strTmp = QString("%1 (Total Len = %2)").arg(strFull, -40).arg(
-                            nBitLen + (anDhtCodeVal[nDhtInd] & 0xF), 2);
-
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("%1 (Total Len = %2)")
+                            .arg(strFull, -40)
+                            .arg(nBitLen + (anDhtCodeVal[nDhtInd] & 0xF), 2));
                     }
 
                     // Store the lookup value
@@ -4623,7 +4750,7 @@ void JfifDecode::decodeDht(bool bInject) {
             decodeErrCheck(bRet);
         }
 
-        _log.info("");
+        LOG_INFO(_log, "");
     }
 
     if (bInject) {
@@ -4660,37 +4787,34 @@ void JfifDecode::decodeErrCheck(bool bRet) {
 // RETURN:
 // - True if decode error is fatal (configurable)
 //
-bool JfifDecode::expectMarkerEnd(uint32_t nMarkerStart, uint32_t nMarkerLen) {
+bool JfifDecode::expectMarkerEnd(uint64_t nMarkerStart, uint32_t nMarkerLen) {
     QString strTmp;
 
-    uint32_t nMarkerEnd = nMarkerStart + nMarkerLen;
+    uint64_t nMarkerEnd = nMarkerStart + nMarkerLen;
     uint32_t nMarkerExtra = nMarkerEnd - _pos;
 
     if (_pos < nMarkerEnd) {
         // The length indicates that there is more data than we processed
-        strTmp = QString("  WARNING: Marker length longer than expected");
-        _log.warn(strTmp);
+        LOG_WARN(_log, QString("  WARNING: Marker length longer than expected"));
 
         if (!_appConfig.relaxedParsing()) {
             // Abort
-            _log.error("  Stopping decode");
-            _log.error("  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
+            LOG_ERROR(_log, "  Stopping decode");
+            LOG_ERROR(_log, "  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
             return false;
         } else {
             // Warn and skip
-            strTmp = QString("  Skipping remainder [%1 bytes]").arg(nMarkerExtra);
-            _log.warn(strTmp);
+            LOG_WARN(_log, QString("  Skipping remainder [%1 bytes]").arg(nMarkerExtra));
             _pos += nMarkerExtra;
         }
     } else if (_pos > nMarkerEnd) {
         // The length indicates that there is less data than we processed
-        strTmp = QString("  WARNING: Marker length shorter than expected");
-        _log.warn(strTmp);
+        LOG_WARN(_log, QString("  WARNING: Marker length shorter than expected"));
 
         if (!_appConfig.relaxedParsing()) {
             // Abort
-            _log.error("  Stopping decode");
-            _log.error("  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
+            LOG_ERROR(_log, "  Stopping decode");
+            LOG_ERROR(_log, "  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
             return false;
         } else {
             // Warn but no skip
@@ -4702,15 +4826,15 @@ bool JfifDecode::expectMarkerEnd(uint32_t nMarkerStart, uint32_t nMarkerLen) {
             // 2) Actual length defined in marker
             if (getByte(_pos) == 0xFF) {
                 // Using actual data expected seems more promising
-                _log.warn("  Resuming decode");
+                LOG_WARN(_log, "  Resuming decode");
             } else if (getByte(nMarkerEnd) == 0xFF) {
                 // Using actual length seems more promising
                 _pos = nMarkerEnd;
-                _log.warn("  Rolling back pointer to end indicated by length");
-                _log.warn("  Resuming decode");
+                LOG_WARN(_log, "  Rolling back pointer to end indicated by length");
+                LOG_WARN(_log, "  Resuming decode");
             } else {
                 // No luck. Expect marker failure now
-                _log.warn("  Resuming decode");
+                LOG_WARN(_log, "  Resuming decode");
             }
         }
     }
@@ -4747,29 +4871,27 @@ bool JfifDecode::validateValue(uint32_t &nVal, uint32_t nMin, uint32_t nMax, con
         return true;
     } else {
         if (nVal < nMin) {
-            _log.error(QString("%1 value too small (Actual = %2, Expected >= %3)").arg(strName).arg(nVal).arg(nMin));
+            LOG_ERROR(_log, QString("%1 value too small (Actual = %2, Expected >= %3)").arg(strName).arg(nVal).arg(nMin));
         } else if (nVal > nMax) {
-            _log.error(QString("%1 value too large (Actual = %2, Expected <= %3)").arg(strName).arg(nVal).arg(nMax));
+            LOG_ERROR(_log, QString("%1 value too large (Actual = %2, Expected <= %3)").arg(strName).arg(nVal).arg(nMax));
         }
 
         if (!_appConfig.relaxedParsing()) {
             // Defined as fatal error
             // TODO: Replace with glb_strMsgStopDecode?
-            _log.error("  Stopping decode");
-            _log.error("  Use [Relaxed Parsing] to continue");
+            LOG_ERROR(_log, "  Stopping decode");
+            LOG_ERROR(_log, "  Use [Relaxed Parsing] to continue");
             return false;
         } else {
             // Non-fatal
             if (bOverride) {
                 // Update value with override
                 nVal = nOverrideVal;
-                strErr = QString("  WARNING: Forcing value to [%1]").arg(nOverrideVal);
-                _log.warn(strErr);
-                _log.warn("  Resuming decode");
+                LOG_WARN(_log, QString("  WARNING: Forcing value to [%1]").arg(nOverrideVal));
+                LOG_WARN(_log, "  Resuming decode");
             } else {
                 // No override
-                strErr = QString("  Resuming decode");
-                _log.warn(strErr);
+                LOG_WARN(_log, QString("  Resuming decode"));
             }
             return true;
         }
@@ -4784,6 +4906,46 @@ bool JfifDecode::validateValue(uint32_t &nVal, uint32_t nMin, uint32_t nMax, con
 #define DECMARK_ERR 1
 #define DECMARK_EOI 2
 
+// Add a marker segment to the identity hash (see getIdentity())
+// - Hashes the marker code and the segment from its length field on
+//
+// PRE:
+// - _pos is just past the marker code
+//
+void JfifDecode::hashIdentitySegment(uint32_t nCode) {
+    const auto nMarker = static_cast<uint8_t>(nCode);
+    _identity.update(&nMarker, 1);
+
+    const uint64_t nLength = getByte(_pos) * 256 + getByte(_pos + 1);
+    const auto nEnd = _pos + nLength;
+
+    for (auto nPos = _pos; nPos < nEnd;) {
+        const uint8_t *pData;
+        const auto nLen = _wbuf.getSpan(nPos, static_cast<uint32_t>(nEnd - nPos), pData);
+        if (nLen == 0) break;
+
+        _identity.update(pData, nLen);
+        nPos += nLen;
+    }
+}
+
+// Add the bytes from _contentPos up to nPosEnd to the content hash (see
+// getContentKey())
+//
+void JfifDecode::hashContentTo(uint64_t nPosEnd) {
+    while (_contentOk && _contentPos < nPosEnd) {
+        const uint8_t *pData;
+        const auto nLen = _wbuf.getSpan(_contentPos, static_cast<uint32_t>(qMin<uint64_t>(nPosEnd - _contentPos, UINT32_MAX)), pData);
+        if (nLen == 0) {
+            _contentOk = false;
+            break;
+        }
+
+        _content.update(pData, nLen);
+        _contentPos += nLen;
+    }
+}
+
 uint32_t JfifDecode::decodeMarker() {
     char acIdentifier[MAX_IDENTIFIER];
 
@@ -4798,14 +4960,14 @@ uint32_t JfifDecode::decodeMarker() {
     uint16_t nTmpVal2;
 
     uint32_t nCode;
-    uint32_t nPosEnd;
-    uint32_t nPosSaved;      // General-purpose saved position in file
-    uint32_t nPosExifStart;
+    uint64_t nPosEnd;
+    uint64_t nPosSaved;      // General-purpose saved position in file
+    uint64_t nPosExifStart;
     uint32_t nRet;                // General purpose return value
 
     bool bRet;
 
-    uint32_t nPosMarkerStart;        // Offset for current marker
+    uint64_t nPosMarkerStart;        // Offset for current marker
     uint32_t nColTransform = 0;   // Color Transform from APP14 marker
 
     // For DQT
@@ -4839,8 +5001,7 @@ uint32_t JfifDecode::decodeMarker() {
 
     // Report out any padding
     if (nSkipMarkerPad > 0) {
-        strTmp = QString("*** Skipped %1 marker pad bytes ***").arg(nSkipMarkerPad);
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("*** Skipped %1 marker pad bytes ***").arg(nSkipMarkerPad));
     }
 
     // Save the current marker offset
@@ -4848,6 +5009,12 @@ uint32_t JfifDecode::decodeMarker() {
 
     addHeader(nCode);
 
+    // SOFn, DHT and DAC share 0xC0..0xCF with the reserved JPG code
+    if ((nCode >= JFIF_SOF0 && nCode <= JFIF_SOF15 && nCode != JFIF_JPG)
+        || nCode == JFIF_DQT || nCode == JFIF_DRI || nCode == JFIF_SOS) {
+        hashIdentitySegment(nCode);
+    }
+
     switch (nCode) {
         case JFIF_SOI:             // SOI
             _stateSoi = true;
@@ -4857,8 +5024,7 @@ uint32_t JfifDecode::decodeMarker() {
             // Photoshop DUCKY (Save For Web)
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
             //nLength = m_pWBuf->BufX(m_nPos,2,!m_nImgExifEndian);
-            strTmp = QString("  Length          = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Length          = %1").arg(nLength));
 
             nPosSaved = _pos;
 
@@ -4866,19 +5032,17 @@ uint32_t JfifDecode::decodeMarker() {
 
             strcpy(acIdentifier, _wbuf.readStrN(_pos, MAX_IDENTIFIER - 1).toLatin1().data());
             acIdentifier[MAX_IDENTIFIER - 1] = 0;     // Null terminate just in case
-            strTmp = QString("  Identifier      = [%1]").arg(acIdentifier);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Identifier      = [%1]").arg(acIdentifier));
             _pos += static_cast<uint32_t>(strlen(acIdentifier)) + 1;
 
             if (strcmp(acIdentifier, "Ducky") != 0) {
-                _log.info("    Not Photoshop DUCKY. Skipping remainder.");
+                LOG_INFO(_log, "    Not Photoshop DUCKY. Skipping remainder.");
             } else                      // Photoshop
             {
                 // Please see reference on http://cpan.uwinnipeg.ca/htdocs/Image-ExifTool/Image/ExifTool/APP12.pm.html
                 // A direct indexed approach should be safe
                 m_nImgQualPhotoshopSfw = getByte(_pos + 6);
-                strTmp = QString("  Photoshop Save For Web Quality = [%1]").arg(m_nImgQualPhotoshopSfw);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("  Photoshop Save For Web Quality = [%1]").arg(m_nImgQualPhotoshopSfw));
             }
 
             // Restore original position in file to a point
@@ -4890,14 +5054,13 @@ uint32_t JfifDecode::decodeMarker() {
             // JPEG Adobe  tag
 
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
-            strTmp = QString("  Length            = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Length            = %1").arg(nLength));
 
             nPosSaved = _pos;
 
             // Some files had very short segment (eg. nLength=2)
             if (nLength < 2 + 12) {
-                _log.info("    Segment too short for Identifier. Skipping remainder.");
+                LOG_INFO(_log, "    Segment too short for Identifier. Skipping remainder.");
                 _pos = nPosSaved + nLength;
                 break;
             }
@@ -4908,35 +5071,31 @@ uint32_t JfifDecode::decodeMarker() {
             _pos += 5;
 
             nTmpVal = getByte(_pos + 0) * 256 + getByte(_pos + 1);
-            strTmp = QString("  DCTEncodeVersion  = %1").arg(nTmpVal);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  DCTEncodeVersion  = %1").arg(nTmpVal));
 
             nTmpVal = getByte(_pos + 2) * 256 + getByte(_pos + 3);
-            strTmp = QString("  APP14Flags0       = %1").arg(nTmpVal);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  APP14Flags0       = %1").arg(nTmpVal));
 
             nTmpVal = getByte(_pos + 4) * 256 + getByte(_pos + 5);
-            strTmp = QString("  APP14Flags1       = %1").arg(nTmpVal);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  APP14Flags1       = %1").arg(nTmpVal));
 
             nColTransform = getByte(_pos + 6);
 
             switch (nColTransform) {
                 case APP14_COLXFM_UNK_RGB:
-                    strTmp = QString("  ColorTransform    = %1 [Unknown (RGB or CMYK)]").arg(nColTransform);
+                    LOG_INFO(_log, QString("  ColorTransform    = %1 [Unknown (RGB or CMYK)]").arg(nColTransform));
                     break;
                 case APP14_COLXFM_YCC:
-                    strTmp = QString("  ColorTransform    = %1 [YCbCr]").arg(nColTransform);
+                    LOG_INFO(_log, QString("  ColorTransform    = %1 [YCbCr]").arg(nColTransform));
                     break;
                 case APP14_COLXFM_YCCK:
-                    strTmp = QString("  ColorTransform    = %1 [YCCK]").arg(nColTransform);
+                    LOG_INFO(_log, QString("  ColorTransform    = %1 [YCCK]").arg(nColTransform));
                     break;
                 default:
-                    strTmp = QString("  ColorTransform    = %1 [???]").arg(nColTransform);
+                    LOG_INFO(_log, QString("  ColorTransform    = %1 [???]").arg(nColTransform));
                     break;
             }
 
-            _log.info(strTmp);
             m_nApp14ColTransform = (nColTransform & 0xFF);
 
             // Restore original position in file to a point
@@ -4949,14 +5108,13 @@ uint32_t JfifDecode::decodeMarker() {
             // Photoshop (Save As)
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
             //nLength = m_pWBuf->BufX(m_nPos,2,!m_nImgExifEndian);
-            strTmp = QString("  Length          = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Length          = %1").arg(nLength));
 
             nPosSaved = _pos;
 
             // Some files had very short segment (eg. nLength=2)
             if (nLength < 2 + 20) {
-                _log.info("    Segment too short for Identifier. Skipping remainder.");
+                LOG_INFO(_log, "    Segment too short for Identifier. Skipping remainder.");
                 _pos = nPosSaved + nLength;
                 break;
             }
@@ -4965,12 +5123,11 @@ uint32_t JfifDecode::decodeMarker() {
 
             strcpy(acIdentifier, _wbuf.readStrN(_pos, MAX_IDENTIFIER - 1).toLatin1().data());
             acIdentifier[MAX_IDENTIFIER - 1] = 0;     // Null terminate just in case
-            strTmp = QString("  Identifier      = [%1]").arg(acIdentifier);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Identifier      = [%1]").arg(acIdentifier));
             _pos += static_cast<uint32_t>(strlen(acIdentifier)) + 1;
 
             if (strcmp(acIdentifier, "Photoshop 3.0") != 0) {
-                _log.info("    Not Photoshop. Skipping remainder.");
+                LOG_INFO(_log, "    Not Photoshop. Skipping remainder.");
             } else                      // Photoshop
             {
                 decodeApp13Ps();
@@ -4984,8 +5141,7 @@ uint32_t JfifDecode::decodeMarker() {
         case JFIF_APP1:
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
             //nLength = m_pWBuf->BufX(m_nPos,2,!m_nImgExifEndian);
-            strTmp = QString("  Length          = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Length          = %1").arg(nLength));
 
             nPosSaved = _pos;
 
@@ -4993,14 +5149,13 @@ uint32_t JfifDecode::decodeMarker() {
 
             strcpy(acIdentifier, _wbuf.readStrN(_pos, MAX_IDENTIFIER - 1).toLatin1().data());
             acIdentifier[MAX_IDENTIFIER - 1] = 0;     // Null terminate just in case
-            strTmp = QString("  Identifier      = [%1]").arg(acIdentifier);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Identifier      = [%1]").arg(acIdentifier));
             _pos += static_cast<uint32_t>(strlen(acIdentifier));
 
             if (strncmp(acIdentifier, "http://ns.adobe.com/xap/1.0/\x00", 29) == 0) {                         //@@
                 // XMP
 
-                _log.info("    XMP = ");
+                LOG_INFO(_log, "    XMP = ");
 
                 _pos++;
 
@@ -5008,7 +5163,7 @@ uint32_t JfifDecode::decodeMarker() {
                 // as single byte characters. In reality, it should probably be
                 // updated to support unicode properly.
 
-                uint32_t nPosMarkerEnd = nPosSaved + nLength - 1;
+                uint64_t nPosMarkerEnd = nPosSaved + nLength - 1;
                 uint32_t sXmpLen = nPosMarkerEnd - _pos;
 
                 uint8_t cXmpChar;
@@ -5034,7 +5189,7 @@ uint32_t JfifDecode::decodeMarker() {
                     if (cXmpChar == 0x0A) {
                         // Only print line if some non-space elements!
                         if (bNonSpace) {
-                            _log.info(strLine);
+                            LOG_INFO(_log, strLine);
                         }
                         // Reset state
                         strLine = "          |";
@@ -5072,18 +5227,18 @@ uint32_t JfifDecode::decodeMarker() {
 
                 strTmp = printAsHexUc(acIdentifierTiff, 8);
                 strFull += strTmp;
-                _log.info(strFull);
+                LOG_INFO(_log, strFull);
 
                 switch (acIdentifierTiff[0] * 256 + acIdentifierTiff[1]) {
                     case 0x4949:         // "II"
                         // Intel alignment
                         m_nImgExifEndian = 0;
-                        _log.info("  Endian          = Intel (little)");
+                        LOG_INFO(_log, "  Endian          = Intel (little)");
                         break;
                     case 0x4D4D:         // "MM"
                         // Motorola alignment
                         m_nImgExifEndian = 1;
-                        _log.info("  Endian          = Motorola (big)");
+                        LOG_INFO(_log, "  Endian          = Motorola (big)");
                         break;
                 }
 
@@ -5091,8 +5246,7 @@ uint32_t JfifDecode::decodeMarker() {
                 uint32_t test_002a;
 
                 test_002a = byteSwap2(acIdentifierTiff[2], acIdentifierTiff[3]);
-                strTmp = QString("  TAG Mark x002A  = 0x%1").arg(test_002a, 4, 16, QChar('0'));
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("  TAG Mark x002A  = 0x%1").arg(test_002a, 4, 16, QChar('0')));
 
                 uint32_t nIfdCount;     // Current IFD #
 
@@ -5126,13 +5280,13 @@ uint32_t JfifDecode::decodeMarker() {
                 if ((nPosSaved + nLength) <= (nPosExifStart + nOffsetIfd1)) {
                     // We've run out of space for any IFD, so cancel now
                     exif_done = true;
-                    _log.info("  No IFD entries");
+                    LOG_INFO(_log, "  No IFD entries");
                 }
 
                 nIfdCount = 0;
 
                 while (!exif_done) {
-                    _log.info("");
+                    LOG_INFO(_log, "");
 
                     strTmp = QString("IFD%1").arg(nIfdCount);
 
@@ -5144,8 +5298,7 @@ uint32_t JfifDecode::decodeMarker() {
                     nOffsetIfd1 = byteSwap4(getByte(_pos + 0), getByte(_pos + 1), getByte(_pos + 2), getByte(_pos + 3));
                     _pos += 4;
 
-                    strTmp = QString("    Offset to Next IFD = 0x%1").arg(nOffsetIfd1, 8, 16, QChar('0'));
-                    _log.info(strTmp);
+                    LOG_INFO(_log, QString("    Offset to Next IFD = 0x%1").arg(nOffsetIfd1, 8, 16, QChar('0')));
 
                     if (nRet != 0) {
                         // Error condition (DecodeExifIfd returned error)
@@ -5163,27 +5316,26 @@ uint32_t JfifDecode::decodeMarker() {
 
                 // If EXIF SubIFD was defined, then handle it now
                 if (m_nImgExifSubIfdPtr != 0) {
-                    _log.info("");
+                    LOG_INFO(_log, "");
                     decodeExifIfd("SubIFD", nPosExifStart, m_nImgExifSubIfdPtr);
                 }
 
                 if (m_nImgExifMakerPtr != 0) {
-                    _log.info("");
+                    LOG_INFO(_log, "");
                     decodeExifIfd("MakerIFD", nPosExifStart, m_nImgExifMakerPtr);
                 }
 
                 if (m_nImgExifGpsIfdPtr != 0) {
-                    _log.info("");
+                    LOG_INFO(_log, "");
                     decodeExifIfd("GPSIFD", nPosExifStart, m_nImgExifGpsIfdPtr);
                 }
 
                 if (m_nImgExifInteropIfdPtr != 0) {
-                    _log.info("");
+                    LOG_INFO(_log, "");
                     decodeExifIfd("InteropIFD", nPosExifStart, m_nImgExifInteropIfdPtr);
                 }
             } else {
-                strTmp = QString("Identifier [%1] not supported. Skipping remainder.").arg(acIdentifier);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("Identifier [%1] not supported. Skipping remainder.").arg(acIdentifier));
             }
 
             //////////
@@ -5224,8 +5376,7 @@ uint32_t JfifDecode::decodeMarker() {
             // Photoshop (Save As)
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
             //nLength = m_pWBuf->BufX(m_nPos,2,!m_nImgExifEndian);
-            strTmp = QString("  Length          = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Length          = %1").arg(nLength));
 
             nPosSaved = _pos;
 
@@ -5233,20 +5384,19 @@ uint32_t JfifDecode::decodeMarker() {
 
             strcpy(acIdentifier, _wbuf.readStrN(_pos, MAX_IDENTIFIER - 1).toLatin1().data());
             acIdentifier[MAX_IDENTIFIER - 1] = 0;     // Null terminate just in case
-            strTmp = QString("  Identifier      = [%1]").arg(acIdentifier);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Identifier      = [%1]").arg(acIdentifier));
             _pos += static_cast<uint32_t>(strlen(acIdentifier)) + 1;
 
             if (strcmp(acIdentifier, "FPXR") == 0) {
                 // Photoshop
-                _log.info("    FlashPix:");
+                LOG_INFO(_log, "    FlashPix:");
                 decodeApp2FlashPix();
             } else if (strcmp(acIdentifier, "ICC_PROFILE") == 0) {
                 // ICC Profile
-                _log.info("    ICC Profile:");
+                LOG_INFO(_log, "    ICC Profile:");
                 decodeApp2IccProfile(nLength);
             } else {
-                _log.info("    Not supported. Skipping remainder.");
+                LOG_INFO(_log, "    Not supported. Skipping remainder.");
             }
 
             // Restore original position in file to a point
@@ -5269,7 +5419,7 @@ uint32_t JfifDecode::decodeMarker() {
         case JFIF_APP15:
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
             //nLength = m_pWBuf->BufX(m_nPos,2,!m_nImgExifEndian);
-            _log.info(QString("  Length     = %1").arg(nLength));
+            LOG_INFO(_log, QString("  Length     = %1").arg(nLength));
 
             if (_verbose) {
                 strFull.clear();
@@ -5286,12 +5436,12 @@ uint32_t JfifDecode::decodeMarker() {
                     strFull += QString("%1 ").arg(nTmpVal, 2, 16, QChar('0'));
 
                     if ((i % 16) == 15) {
-                        _log.info(strFull);
+                        LOG_INFO(_log, strFull);
                         strFull.clear();
                     }
                 }
 
-                _log.info(strFull);
+                LOG_INFO(_log, strFull);
 
                 strFull.clear();
 
@@ -5312,11 +5462,11 @@ uint32_t JfifDecode::decodeMarker() {
                     }
 
                     if ((i % 32) == 31) {
-                        _log.info(strFull);
+                        LOG_INFO(_log, strFull);
                     }
                 }
 
-                _log.info(strFull);
+                LOG_INFO(_log, strFull);
             }                         // nVerbose
 
             _pos += nLength;
@@ -5326,13 +5476,11 @@ uint32_t JfifDecode::decodeMarker() {
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
             //nLength = m_pWBuf->BufX(m_nPos,2,!m_nImgExifEndian);
             _pos += 2;
-            strTmp = QString("  Length     = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Length     = %1").arg(nLength));
 
             strcpy(_app0Identifier, _wbuf.readStrN(_pos, MAX_IDENTIFIER - 1).toLatin1().data());
             _app0Identifier[MAX_IDENTIFIER - 1] = 0;       // Null terminate just in case
-            strTmp = QString("  Identifier = [%1]").arg(_app0Identifier);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Identifier = [%1]").arg(_app0Identifier));
 
             if (strcmp(_app0Identifier, "JFIF")) {
                 // Only process remainder if it is JFIF. This marker
@@ -5342,8 +5490,7 @@ uint32_t JfifDecode::decodeMarker() {
 
                 m_nImgVersionMajor = getByte(_pos++);
                 m_nImgVersionMinor = getByte(_pos++);
-                strTmp = QString("  version    = [%1.%2]").arg(m_nImgVersionMajor).arg(m_nImgVersionMinor);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("  version    = [%1.%2]").arg(m_nImgVersionMajor).arg(m_nImgVersionMinor));
 
                 m_nImgUnits = getByte(_pos++);
 
@@ -5359,31 +5506,30 @@ uint32_t JfifDecode::decodeMarker() {
                 switch (m_nImgUnits) {
                     case 0:
                         strFull += "(aspect ratio)";
-                        _log.info(strFull);
+                        LOG_INFO(_log, strFull);
                         break;
 
                     case 1:
                         strFull += "DPI (dots per inch)";
-                        _log.info(strFull);
+                        LOG_INFO(_log, strFull);
                         break;
 
                     case 2:
                         strFull += "DPcm (dots per cm)";
-                        _log.info(strFull);
+                        LOG_INFO(_log, strFull);
                         break;
 
                     default:
                         strTmp = QString("Unknown ImgUnits parameter [%1]").arg(m_nImgUnits);
                         strFull += strTmp;
-                        _log.warn(strFull);
+                        LOG_WARN(_log, strFull);
                         //return DECMARK_ERR;
                         break;
                 }
 
                 m_nImgThumbSizeX = getByte(_pos++);
                 m_nImgThumbSizeY = getByte(_pos++);
-                strTmp = QString("  thumbnail  = %1 x %2").arg(m_nImgThumbSizeX).arg(m_nImgThumbSizeY);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("  thumbnail  = %1 x %2").arg(m_nImgThumbSizeX).arg(m_nImgThumbSizeY));
 
                 // Unpack the thumbnail:
                 uint32_t thumbnail_r, thumbnail_g, thumbnail_b;
@@ -5401,7 +5547,7 @@ uint32_t JfifDecode::decodeMarker() {
                                 .arg(thumbnail_g, 2, 16, QChar('0'))
                                 .arg(thumbnail_b, 2, 16, QChar('0'));
                             strFull += strTmp;
-                            _log.info(strFull);
+                            LOG_INFO(_log, strFull);
                         }
                     }
                 }
@@ -5432,9 +5578,9 @@ uint32_t JfifDecode::decodeMarker() {
                 // Need to fill in predefined DHT table from spec:
                 //   OpenDML file format for AVI, section "Proposed Data Chunk Format"
                 //   Described in MMREG.H
-                _log.info("  Detected MotionJPEG");
-                _log.info("  Importing standard Huffman table...");
-                _log.info("");
+                LOG_INFO(_log, "  Detected MotionJPEG");
+                LOG_INFO(_log, "  Importing standard Huffman table...");
+                LOG_INFO(_log, "");
 
                 addHeader(JFIF_DHT_FAKE);
 
@@ -5448,7 +5594,7 @@ uint32_t JfifDecode::decodeMarker() {
 
             } else {
                 // Not JFIF or AVI1
-                _log.info("    Not known APP0 type. Skipping remainder.");
+                LOG_INFO(_log, "    Not known APP0 type. Skipping remainder.");
                 _pos += nLength - 2;
             }
 
@@ -5466,11 +5612,10 @@ uint32_t JfifDecode::decodeMarker() {
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);    // Lq
             nPosEnd = _pos + nLength;
             _pos += 2;
-            strTmp = QString("  Table length = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Table length = %1").arg(nLength));
 
             while (nPosEnd > _pos) {
-                _log.info("  ----");
+                LOG_INFO(_log, "  ----");
 
                 nTmpVal = getByte(_pos++);        // Pq | Tq
                 nDqtPrecision_Pq = (nTmpVal & 0xF0) >> 4;       // Pq, range 0-1
@@ -5483,7 +5628,7 @@ uint32_t JfifDecode::decodeMarker() {
                 } else if (nDqtPrecision_Pq == 1) {
                     strDqtPrecision = "16 bits";
                 } else {
-                    _log.warn(QString("    Unsupported precision value [%1]").arg(nDqtPrecision_Pq));
+                    LOG_WARN(_log, QString("    Unsupported precision value [%1]").arg(nDqtPrecision_Pq));
                     strDqtPrecision = "???";
                     // FIXME: Consider terminating marker parsing early
                 }
@@ -5494,8 +5639,7 @@ uint32_t JfifDecode::decodeMarker() {
                 if (!validateValue(nDqtQuantDestId_Tq, 0, 3, "DQT Destination ID <Tq>", true, 0))
                     return DECMARK_ERR;
 
-                strTmp = QString("  Precision=%1").arg(strDqtPrecision);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("  Precision=%1").arg(strDqtPrecision));
 #else
                                                                                                                                         // Decode with additional DQT extension (ITU-T-JPEG-Plus-Proposal_R3.doc)
 
@@ -5571,34 +5715,36 @@ uint32_t JfifDecode::decodeMarker() {
           }
         }
 #endif
-                strTmp = QString("  Destination ID=%1").arg(nDqtQuantDestId_Tq);
-
-                if (nDqtQuantDestId_Tq == 0) {
-                    strTmp += " (Luminance)";
-                } else if (nDqtQuantDestId_Tq == 1) {
-                    strTmp += " (Chrominance)";
-                } else if (nDqtQuantDestId_Tq == 2) {
-                    strTmp += " (Chrominance)";
-                } else {
-                    strTmp += " (???)";
-                }
+                if (LOG_INFO_ON(_log)) {
+                    strTmp = QString("  Destination ID=%1").arg(nDqtQuantDestId_Tq);
 
-                _log.info(strTmp);
+                    if (nDqtQuantDestId_Tq == 0) {
+                        strTmp += " (Luminance)";
+                    } else if (nDqtQuantDestId_Tq == 1) {
+                        strTmp += " (Chrominance)";
+                    } else if (nDqtQuantDestId_Tq == 2) {
+                        strTmp += " (Chrominance)";
+                    } else {
+                        strTmp += " (???)";
+                    }
+
+                    LOG_INFO(_log, strTmp);
+                }
 
                 // FIXME: The following is somewhat superseded by ValidateValue() above with the exception of skipping remainder
                 if (nDqtQuantDestId_Tq >= MAX_DQT_DEST_ID) {
-                    _log.error(QString("Destination ID <Tq> = %1, >= %2").arg(nDqtQuantDestId_Tq).arg(
+                    LOG_ERROR(_log, QString("Destination ID <Tq> = %1, >= %2").arg(nDqtQuantDestId_Tq).arg(
                         MAX_DQT_DEST_ID));
 
                     if (!_appConfig.relaxedParsing()) {
-                        _log.error("  Stopping decode");
+                        LOG_ERROR(_log, "  Stopping decode");
                         return DECMARK_ERR;
                     } else {
                         // Now skip remainder of DQT
                         // FIXME
-                        _log.warn(QString("  Skipping remainder of marker [%1 bytes]").arg(
+                        LOG_WARN(_log, QString("  Skipping remainder of marker [%1 bytes]").arg(
                             nPosMarkerStart + nLength - _pos));
-                        _log.info("");
+                        LOG_INFO(_log, "");
                         _pos = nPosMarkerStart + nLength;
                         return DECMARK_OK;
                     }
@@ -5677,7 +5823,10 @@ uint32_t JfifDecode::decodeMarker() {
 
                     for (uint32_t nDqtX = 0; nDqtX < 8; nDqtX++) {
                         nCoeffInd = nDqtY * 8 + nDqtX;
-                        strFull += QString("%1 ").arg(m_anImgDqtTbl[nDqtQuantDestId_Tq][nCoeffInd], 3);
+
+                        if (LOG_INFO_ON(_log)) {
+                            strFull += QString("%1 ").arg(m_anImgDqtTbl[nDqtQuantDestId_Tq][nCoeffInd], 3);
+                        }
 
                         // Store the DQT entry into the Image Decoder
                         bRet = _imgDec.setDqtEntry(nDqtQuantDestId_Tq, nCoeffInd, glb_anUnZigZag[nCoeffInd],
@@ -5701,7 +5850,7 @@ uint32_t JfifDecode::decodeMarker() {
              strFull += ">";
            */
 
-                    _log.info(strFull);
+                    LOG_INFO(_log, strFull);
                 }
 
                 // Perform some statistical analysis of the quality factor
@@ -5725,7 +5874,7 @@ uint32_t JfifDecode::decodeMarker() {
 
                 // Save the quality rating for later
                 m_adImgDqtQual[nDqtQuantDestId_Tq] = dQuality;
-                _log.info(QString("    Approx quality factor = %1 (scaling=%2 variance=%3)")
+                LOG_INFO(_log, QString("    Approx quality factor = %1 (scaling=%2 variance=%3)")
                               .arg(dQuality, 0, 'f', 2)
                               .arg(dSumPercent, 0, 'f', 2)
                               .arg(dVariance, 0, 'f', 2));
@@ -5741,8 +5890,7 @@ uint32_t JfifDecode::decodeMarker() {
         case JFIF_DAC:             // DAC (Arithmetic Coding)
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);    // La
             _pos += 2;
-            strTmp = QString("  Arithmetic coding header length = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Arithmetic coding header length = %1").arg(nLength));
 
             uint32_t nDAC_n;
             uint32_t nDAC_Tc, nDAC_Tb;
@@ -5754,20 +5902,17 @@ uint32_t JfifDecode::decodeMarker() {
                 nTmpVal = getByte(_pos++);        // Tc,Tb
                 nDAC_Tc = (nTmpVal & 0xF0) >> 4;
                 nDAC_Tb = (nTmpVal & 0x0F);
-                strTmp = QString("  #%1: Table class                  = %2")
+                LOG_INFO(_log, QString("  #%1: Table class                  = %2")
                     .arg(nInd + 1, 2, 10, QChar('0'))
-                    .arg(nDAC_Tc);
-                _log.info(strTmp);
-                strTmp = QString("  #%1: Table destination identifier = %2")
+                    .arg(nDAC_Tc));
+                LOG_INFO(_log, QString("  #%1: Table destination identifier = %2")
                     .arg(nInd, 2, 10, QChar('0'))
-                    .arg(nDAC_Tb);
-                _log.info(strTmp);
+                    .arg(nDAC_Tb));
 
                 nDAC_Cs = getByte(_pos++);        // Cs
-                strTmp = QString("  #%1: Conditioning table value     = %2")
+                LOG_INFO(_log, QString("  #%1: Conditioning table value     = %2")
                     .arg(nInd + 1, 2, 10, QChar('0'))
-                    .arg(nDAC_Cs);
-                _log.info(strTmp);
+                    .arg(nDAC_Cs));
 
                 if (!validateValue(nDAC_Tc, 0, 1, "Table class <Tc>", true, 0))
                     return DECMARK_ERR;
@@ -5797,13 +5942,11 @@ uint32_t JfifDecode::decodeMarker() {
         case JFIF_DNL:             // DNL (Define number of lines)
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);    // Ld
             _pos += 2;
-            strTmp = QString("  Header length = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Header length = %1").arg(nLength));
 
             nTmpVal = getByte(_pos) * 256 + getByte(_pos + 1);    // NL
             _pos += 2;
-            strTmp = QString("  Number of lines = %1").arg(nTmpVal);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Number of lines = %1").arg(nTmpVal));
 
             if (!validateValue(nTmpVal, 1, 65535, "Number of lines <NL>", true, 1))
                 return DECMARK_ERR;
@@ -5816,8 +5959,7 @@ uint32_t JfifDecode::decodeMarker() {
         case JFIF_EXP:
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);    // Le
             _pos += 2;
-            strTmp = QString("  Header length = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Header length = %1").arg(nLength));
 
             uint32_t nEXP_Eh, nEXP_Ev;
 
@@ -5825,10 +5967,8 @@ uint32_t JfifDecode::decodeMarker() {
             nEXP_Eh = (nTmpVal & 0xF0) >> 4;
             nEXP_Ev = (nTmpVal & 0x0F);
             _pos += 2;
-            strTmp = QString("  Expand horizontally = %1").arg(nEXP_Eh);
-            _log.info(strTmp);
-            strTmp = QString("  Expand vertically   = %1").arg(nEXP_Ev);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Expand horizontally = %1").arg(nEXP_Eh));
+            LOG_INFO(_log, QString("  Expand vertically   = %1").arg(nEXP_Ev));
 
             if (!validateValue(nEXP_Eh, 0, 1, "Expand horizontally <Eh>", true, 0))
                 return DECMARK_ERR;
@@ -5883,34 +6023,29 @@ uint32_t JfifDecode::decodeMarker() {
 
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);    // Lf
             _pos += 2;
-            strTmp = QString("  Frame header length = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Frame header length = %1").arg(nLength));
 
             m_nSofPrecision_P = getByte(_pos++);        // P
-            strTmp = QString("  Precision = %1").arg(m_nSofPrecision_P);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Precision = %1").arg(m_nSofPrecision_P));
 
             if (!validateValue(m_nSofPrecision_P, 2, 16, "Precision <P>", true, 8))
                 return DECMARK_ERR;
 
             m_nSofNumLines_Y = getByte(_pos) * 256 + getByte(_pos + 1);   // Y
             _pos += 2;
-            strTmp = QString("  Number of Lines = %1").arg(m_nSofNumLines_Y);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Number of Lines = %1").arg(m_nSofNumLines_Y));
 
             if (!validateValue(m_nSofNumLines_Y, 0, 65535, "Number of Lines <Y>", true, 0))
                 return DECMARK_ERR;
 
             m_nSofSampsPerLine_X = getByte(_pos) * 256 + getByte(_pos + 1);       // X
             _pos += 2;
-            strTmp = QString("  Samples per Line = %1").arg(m_nSofSampsPerLine_X);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Samples per Line = %1").arg(m_nSofSampsPerLine_X));
 
             if (!validateValue(m_nSofSampsPerLine_X, 1, 65535, "Samples per Line <X>", true, 1))
                 return DECMARK_ERR;
 
-            strTmp = QString("  Image Size = %1 x %2").arg(m_nSofSampsPerLine_X).arg(m_nSofNumLines_Y);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Image Size = %1 x %2").arg(m_nSofSampsPerLine_X).arg(m_nSofNumLines_Y));
 
             // Determine orientation
             //   m_nSofSampsPerLine_X = X
@@ -5920,13 +6055,11 @@ uint32_t JfifDecode::decodeMarker() {
             if (m_nSofNumLines_Y > m_nSofSampsPerLine_X)
                 m_eImgLandscape = ENUM_LANDSCAPE_NO;
 
-            strTmp = QString("  Raw Image Orientation = %1").arg(
-                m_eImgLandscape == ENUM_LANDSCAPE_YES ? "Landscape" : "Portrait");
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Raw Image Orientation = %1").arg(
+                m_eImgLandscape == ENUM_LANDSCAPE_YES ? "Landscape" : "Portrait"));
 
             m_nSofNumComps_Nf = getByte(_pos++);        // Nf, range 1..255
-            strTmp = QString("  Number of Img components = %1").arg(m_nSofNumComps_Nf);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Number of Img components = %1").arg(m_nSofNumComps_Nf));
 
             if (!validateValue(m_nSofNumComps_Nf, 1, 255, "Number of Img components <Nf>", true, 1))
                 return DECMARK_ERR;
@@ -6042,7 +6175,7 @@ uint32_t JfifDecode::decodeMarker() {
                     strFull += " (???)";  // Unknown
                 }
 
-                _log.info(strFull);
+                LOG_INFO(_log, strFull);
             }
 
             // Test for bad input, clean up if bad
@@ -6109,8 +6242,7 @@ uint32_t JfifDecode::decodeMarker() {
         case JFIF_COM:             // COM
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
             _pos += 2;
-            strTmp = QString("  Comment length = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Comment length = %1").arg(nLength));
 
             // Check for JPEG COM vulnerability
             //   http://marc.info/?l=bugtraq&m=109524346729948
@@ -6120,15 +6252,13 @@ uint32_t JfifDecode::decodeMarker() {
             // obvious way to
 
             if ((nLength == 0) || (nLength == 1)) {
-                strTmp = QString("    JPEG Comment Field Vulnerability detected!");
-                _log.error(strTmp);
-                strTmp = QString("    Skipping data until next marker...");
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("    JPEG Comment Field Vulnerability detected!"));
+                LOG_ERROR(_log, QString("    Skipping data until next marker..."));
                 nLength = 2;
 
                 bool bDoneSearch = false;
 
-                uint32_t nSkipStart = _pos;
+                uint64_t nSkipStart = _pos;
 
                 while (!bDoneSearch) {
                     if (getByte(_pos) != 0xFF) {
@@ -6142,8 +6272,7 @@ uint32_t JfifDecode::decodeMarker() {
                     }
                 }
 
-                strTmp = QString("    Skipped %1 bytes").arg(_pos - nSkipStart);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("    Skipped %1 bytes").arg(_pos - nSkipStart));
 
                 // Break out of case statement
                 break;
@@ -6165,7 +6294,7 @@ uint32_t JfifDecode::decodeMarker() {
             }
 
             strFull += m_strComment;
-            _log.info(strFull);
+            LOG_INFO(_log, strFull);
 
             break;
 
@@ -6176,7 +6305,7 @@ uint32_t JfifDecode::decodeMarker() {
             break;
 
         case JFIF_SOS:             // SOS
-            uint32_t nPosScanStart;      // Byte count at start of scan data segment
+            uint64_t nPosScanStart;      // Byte count at start of scan data segment
 
             _stateSos = true;
 
@@ -6193,24 +6322,20 @@ uint32_t JfifDecode::decodeMarker() {
 
             // Ensure that we have seen proper markers before we try this one!
             if (!_stateSofOk) {
-                strTmp = QString("  SOS before valid SOF defined");
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("  SOS before valid SOF defined"));
                 return DECMARK_ERR;
             }
 
-            strTmp = QString("  Scan header length = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Scan header length = %1").arg(nLength));
 
             m_nSosNumCompScan_Ns = getByte(_pos++);     // Ns, range 1..4
-            strTmp = QString("  Number of img components = %1").arg(m_nSosNumCompScan_Ns);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Number of img components = %1").arg(m_nSosNumCompScan_Ns));
 
             // Just in case something got corrupted, don't want to get out
             // of range here. Note that this will be a hard abort, and
             // will not resume decoding.
             if (m_nSosNumCompScan_Ns > MAX_SOS_COMP_NS) {
-                strTmp = QString("  Scan decode does not support > %1 components").arg(MAX_SOS_COMP_NS);
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("  Scan decode does not support > %1 components").arg(MAX_SOS_COMP_NS));
                 return DECMARK_ERR;
             }
 
@@ -6232,7 +6357,7 @@ uint32_t JfifDecode::decodeMarker() {
                     .arg(nSosHuffTblSelDc_Td)
                     .arg(nSosHuffTblSelAc_Ta);
                 strFull += strTmp;
-                _log.info(strFull);
+                LOG_INFO(_log, strFull);
 
                 bRet = _imgDec.SetDhtTables(nScanCompInd, nSosHuffTblSelDc_Td, nSosHuffTblSelAc_Ta);
 
@@ -6243,16 +6368,14 @@ uint32_t JfifDecode::decodeMarker() {
             m_nSosSpectralEnd_Se = getByte(_pos++);
             m_nSosSuccApprox_A = getByte(_pos++);
 
-            strTmp = QString("  Spectral selection = %1 .. %2")
+            LOG_INFO(_log, QString("  Spectral selection = %1 .. %2")
                 .arg(m_nSosSpectralStart_Ss)
-                .arg(m_nSosSpectralEnd_Se);
-            _log.info(strTmp);
-            strTmp = QString("  Successive approximation = 0x%1").arg(m_nSosSuccApprox_A, 2, 16, QChar('0'));
-            _log.info(strTmp);
+                .arg(m_nSosSpectralEnd_Se));
+            LOG_INFO(_log, QString("  Successive approximation = 0x%1").arg(m_nSosSuccApprox_A, 2, 16, QChar('0')));
 
             if (_appConfig.scanDump()) {
-                _log.info("");
-                _log.info("  Scan Data: (after bitstuff removed)");
+                LOG_INFO(_log, "");
+                LOG_INFO(_log, "  Scan Data: (after bitstuff removed)");
             }
 
             // Save the scan data segment position
@@ -6284,6 +6407,40 @@ uint32_t JfifDecode::decodeMarker() {
 
             strFull.clear();
 
+            if (!_appConfig.scanDump()) {
+                // Nothing to dump, so skip ahead a window at a time
+                uint64_t nPosMarker;
+
+                // Bring the content hash up to the scan so that the skip
+                // can carry it on (see getContentKey())
+                ContentHash *pContent = nullptr;
+                if (_appConfig.dedup() && !_appConfig.dedupIdentity()) {
+                    hashContentTo(_pos);
+
+                    if (_contentOk && _contentPos == _pos) {
+                        pContent = &_content;
+                    }
+                }
+
+                if (_wbuf.skipScanData(_pos, nPosMarker, &_scanRstPos, &_identity, pContent)) {
+                    _pos = nPosMarker;
+
+                    if (pContent) {
+                        _contentPos = nPosMarker;
+                    }
+                } else {
+                    if (pContent) {
+                        _contentOk = false;
+                    }
+
+                    // Same end position as the byte-wise walk below
+                    _pos = _posFileEnd + 1;
+                    LOG_ERROR(_log, QString("Ran out of buffer before EOI during phase 1 of Scan decode @ 0x%1").arg(_pos, 8, 16, QChar('0')));
+                }
+
+                bSkipDone = true;
+            }
+
             while (!bSkipDone) {
                 nSkipCount++;
                 nSkipPos++;
@@ -6297,20 +6454,30 @@ uint32_t JfifDecode::decodeMarker() {
                     if (nSkipData == 0x00) {
                         // Byte stuff
                         nSkipData = 0xFF;
+
+                        const uint8_t nUnstuffed = 0xFF;
+                        _identity.update(&nUnstuffed, 1);
                     } else if ((nSkipData >= JFIF_RST0) && (nSkipData <= JFIF_RST7)) {
                         // Skip over
+                        _scanRstPos.push_back(_pos - 2);
+
+                        const uint8_t anRst[2] = { 0xFF, static_cast<uint8_t>(nSkipData) };
+                        _identity.update(anRst, 2);
                     } else {
                         // Marker
                         bSkipDone = true;
                         _pos -= 2;
                     }
+                } else {
+                    const auto nData = static_cast<uint8_t>(nSkipData);
+                    _identity.update(&nData, 1);
                 }
 
                 if (_appConfig.scanDump() && (!bSkipDone)) {
                     // Only display 20 lines of scan data
                     if (nSkipPos > 640) {
                         if (!bScanDumpTrunc) {
-                            _log.warn("    WARNING: Dump truncated.");
+                            LOG_WARN(_log, "    WARNING: Dump truncated.");
                             bScanDumpTrunc = true;
                         }
                     } else {
@@ -6322,7 +6489,7 @@ uint32_t JfifDecode::decodeMarker() {
                         strFull += strTmp;
 
                         if (((nSkipPos - 1) % 32) == 31) {
-                            _log.info(strFull);
+                            LOG_INFO(_log, strFull);
                             strFull.clear();
                         }
                     }
@@ -6337,12 +6504,16 @@ uint32_t JfifDecode::decodeMarker() {
                 // checking m_nPos against file length? .. and not
                 // return but "break".
                 if (!_wbuf.isBufferOk()) {
-                    _log.error(QString("Ran out of buffer before EOI during phase 1 of Scan decode @ 0x%1").arg(_pos, 8, 16, QChar('0')));
+                    LOG_ERROR(_log, QString("Ran out of buffer before EOI during phase 1 of Scan decode @ 0x%1").arg(_pos, 8, 16, QChar('0')));
                     break;
                 }
             }
 
-            _log.info(strFull);
+            LOG_INFO(_log, strFull);
+
+            if (qMin(_pos, _posFileEnd) > nPosScanStart) {
+                _scanLength += qMin(_pos, _posFileEnd) - nPosScanStart;
+            }
 
             //              }
 
@@ -6350,20 +6521,20 @@ uint32_t JfifDecode::decodeMarker() {
             // If the option is set, start parsing!
             if (_appConfig.decodeImage() && m_bImgSofUnsupported) {
                 // SOF marker was of type we don't support, so skip decoding
-                _log.warn("  Scan parsing doesn't support this SOF mode.");
+                LOG_WARN(_log, "  Scan parsing doesn't support this SOF mode.");
 #ifndef DEBUG_YCCK
             } else if (_appConfig.decodeImage() && (m_nSofNumComps_Nf == 4)) {
-                _log.warn("  Scan parsing doesn't support CMYK files yet.");
+                LOG_WARN(_log, "  Scan parsing doesn't support CMYK files yet.");
 #endif
             } else if (_appConfig.decodeImage() && !m_bImgSofUnsupported) {
                 if (!_stateSofOk) {
-                    _log.warn("  Scan decode disabled as SOF not decoded.");
+                    LOG_WARN(_log, "  Scan decode disabled as SOF not decoded.");
                 } else if (!_stateDqtOk) {
-                    _log.warn("  Scan decode disabled as DQT not decoded.");
+                    LOG_WARN(_log, "  Scan decode disabled as DQT not decoded.");
                 } else if (!_stateDhtOk) {
-                    _log.warn("  Scan decode disabled as DHT not decoded.");
+                    LOG_WARN(_log, "  Scan decode disabled as DHT not decoded.");
                 } else {
-                    _log.info("");
+                    LOG_INFO(_log, "");
 
                     // Set the primary image details
                     _imgDec.setImageDetails(m_nSofSampsPerLine_X, m_nSofNumLines_Y,
@@ -6376,8 +6547,24 @@ uint32_t JfifDecode::decodeMarker() {
                     if (_imgSrcDirty) {
                         _imgDec.decodeScanImg(nPosScanStart, true, false);
                         _imgSrcDirty = false;
+
+                        if (_appConfig.perceptualHash() && !_perceptualHashTried) {
+                            _perceptualHashTried = true;
+                            _perceptualHashSet = _imgDec.dcPerceptualHash(_perceptualHash);
+                        }
                     }
                 }
+            } else if (_appConfig.perceptualHash() && !_perceptualHashTried && !m_bImgSofUnsupported
+                       && (m_nSofNumComps_Nf != 4) && _stateSofOk && _stateDqtOk && _stateDhtOk) {
+                // Decode the first scan for its DC values alone: no IDCT
+                // and no preview image. Only ever once per image, even if
+                // no hash comes of it (eg. an image too small to hash).
+                _perceptualHashTried = true;
+                _imgDec.setImageDetails(m_nSofSampsPerLine_X, m_nSofNumLines_Y,
+                                        m_nSofNumComps_Nf, m_nSosNumCompScan_Ns, m_nImgRstEn, m_nImgRstInterval);
+                _imgDec.decodeScanImg(nPosScanStart, false, true);
+
+                _perceptualHashSet = _imgDec.dcPerceptualHash(_perceptualHash);
             }
 
             _stateSosOk = true;
@@ -6388,8 +6575,7 @@ uint32_t JfifDecode::decodeMarker() {
             uint32_t nVal;
 
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);
-            strTmp = QString("  Length     = %1").arg(nLength);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  Length     = %1").arg(nLength));
             nVal = getByte(_pos + 2) * 256 + getByte(_pos + 3);
 
             // According to ITU-T spec B.2.4.4, we only expect
@@ -6401,8 +6587,7 @@ uint32_t JfifDecode::decodeMarker() {
                 m_nImgRstEn = false;
             }
 
-            strTmp = QString("  interval   = %1").arg(m_nImgRstInterval);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("  interval   = %1").arg(m_nImgRstInterval));
             _pos += 4;
 
             if (!expectMarkerEnd(nPosMarkerStart, nLength))
@@ -6411,7 +6596,7 @@ uint32_t JfifDecode::decodeMarker() {
             break;
 
         case JFIF_EOI:             // EOI
-            _log.info("");
+            LOG_INFO(_log, "");
 
             // Save the EOI file position
             // NOTE: If the file is missing the EOI, then this variable will be
@@ -6446,9 +6631,8 @@ uint32_t JfifDecode::decodeMarker() {
             // Unsupported marker
             // - Provide generic decode based on length
             nLength = getByte(_pos) * 256 + getByte(_pos + 1);    // Length
-            strTmp = QString("  Header length = %1").arg(nLength);
-            _log.info(strTmp);
-            _log.warn("  Skipping unsupported marker");
+            LOG_INFO(_log, QString("  Header length = %1").arg(nLength));
+            LOG_WARN(_log, "  Skipping unsupported marker");
             _pos += nLength;
             break;
 
@@ -6465,54 +6649,50 @@ uint32_t JfifDecode::decodeMarker() {
             // But for the sake of robustness, we can check here to see if treating
             // as a standalone marker will arrive at another marker (ie. OK). If not,
             // proceed to assume there is a length indicator.
-            strTmp = QString("  WARNING: Restart marker [0xFF%1] detected outside scan").arg(nCode, 2, 16, QChar('0'));
-            _log.warn(strTmp);
+            LOG_WARN(_log, QString("  WARNING: Restart marker [0xFF%1] detected outside scan").arg(nCode, 2, 16, QChar('0')));
 
             if (!_appConfig.relaxedParsing()) {
                 // Abort
-                _log.error("  Stopping decode");
-                _log.info("  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
+                LOG_ERROR(_log, "  Stopping decode");
+                LOG_INFO(_log, "  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
                 return DECMARK_ERR;
             } else {
                 // Ignore
                 // Check to see if standalone marker treatment looks OK
                 if (getByte(_pos + 2) == 0xFF) {
                     // Looks like standalone
-                    _log.warn("  Ignoring standalone marker. Proceeding with decode.");
+                    LOG_WARN(_log, "  Ignoring standalone marker. Proceeding with decode.");
                     _pos += 2;
                 } else {
                     // Looks like marker with length
 
                     nLength = getByte(_pos) * 256 + getByte(_pos + 1);
-                    strTmp = QString("  Header length = %1").arg(nLength);
-                    _log.info(strTmp);
-                    _log.warn("  Skipping marker");
+                    LOG_INFO(_log, QString("  Header length = %1").arg(nLength));
+                    LOG_WARN(_log, "  Skipping marker");
                     _pos += nLength;
                 }
             }
             break;
 
         default:
-            strTmp = QString("  WARNING: Unknown marker [0xFF%1]").arg(nCode, 2, 16, QChar('0'));
-            _log.warn(strTmp);
+            LOG_WARN(_log, QString("  WARNING: Unknown marker [0xFF%1]").arg(nCode, 2, 16, QChar('0')));
 
             if (!_appConfig.relaxedParsing()) {
                 // Abort
-                _log.error("  Stopping decode");
-                _log.info("  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
+                LOG_ERROR(_log, "  Stopping decode");
+                LOG_INFO(_log, "  Use [Img Search Fwd/Rev] to locate other valid embedded JPEGs");
                 return DECMARK_ERR;
             } else {
                 // Skip
                 nLength = getByte(_pos) * 256 + getByte(_pos + 1);
-                strTmp = QString("  Header length = %1").arg(nLength);
-                _log.info(strTmp);
-                _log.warn("  Skipping marker");
+                LOG_INFO(_log, QString("  Header length = %1").arg(nLength));
+                LOG_WARN(_log, "  Skipping marker");
                 _pos += nLength;
             }
     }
 
     // Add white-space between each marker
-    _log.info(" ");
+    LOG_INFO(_log, " ");
 
     // If we decided to abort for any reason, make sure we trap it now.
     // This will stop the ProcessFile() while loop. We can set m_bStateAbort
@@ -6530,131 +6710,131 @@ void JfifDecode::addHeader(uint32_t code) {
 
     switch (code) {
         case JFIF_SOI:
-            _log.info("*** Marker: SOI (xFFD8) ***");
+            LOG_INFO(_log, "*** Marker: SOI (xFFD8) ***");
             break;
 
         case JFIF_APP0:
-            _log.info("*** Marker: APP0 (xFFE0) ***");
+            LOG_INFO(_log, "*** Marker: APP0 (xFFE0) ***");
             break;
 
         case JFIF_APP1:
-            _log.info("*** Marker: APP1 (xFFE1) ***");
+            LOG_INFO(_log, "*** Marker: APP1 (xFFE1) ***");
             break;
 
         case JFIF_APP2:
-            _log.info("*** Marker: APP2 (xFFE2) ***");
+            LOG_INFO(_log, "*** Marker: APP2 (xFFE2) ***");
             break;
 
         case JFIF_APP3:
-            _log.info("*** Marker: APP3 (xFFE3) ***");
+            LOG_INFO(_log, "*** Marker: APP3 (xFFE3) ***");
             break;
 
         case JFIF_APP4:
-            _log.info("*** Marker: APP4 (xFFE4) ***");
+            LOG_INFO(_log, "*** Marker: APP4 (xFFE4) ***");
             break;
 
         case JFIF_APP5:
-            _log.info("*** Marker: APP5 (xFFE5) ***");
+            LOG_INFO(_log, "*** Marker: APP5 (xFFE5) ***");
             break;
 
         case JFIF_APP6:
-            _log.info("*** Marker: APP6 (xFFE6) ***");
+            LOG_INFO(_log, "*** Marker: APP6 (xFFE6) ***");
             break;
 
         case JFIF_APP7:
-            _log.info("*** Marker: APP7 (xFFE7) ***");
+            LOG_INFO(_log, "*** Marker: APP7 (xFFE7) ***");
             break;
 
         case JFIF_APP8:
-            _log.info("*** Marker: APP8 (xFFE8) ***");
+            LOG_INFO(_log, "*** Marker: APP8 (xFFE8) ***");
             break;
 
         case JFIF_APP9:
-            _log.info("*** Marker: APP9 (xFFE9) ***");
+            LOG_INFO(_log, "*** Marker: APP9 (xFFE9) ***");
             break;
 
         case JFIF_APP10:
-            _log.info("*** Marker: APP10 (xFFEA) ***");
+            LOG_INFO(_log, "*** Marker: APP10 (xFFEA) ***");
             break;
 
         case JFIF_APP11:
-            _log.info("*** Marker: APP11 (xFFEB) ***");
+            LOG_INFO(_log, "*** Marker: APP11 (xFFEB) ***");
             break;
 
         case JFIF_APP12:
-            _log.info("*** Marker: APP12 (xFFEC) ***");
+            LOG_INFO(_log, "*** Marker: APP12 (xFFEC) ***");
             break;
 
         case JFIF_APP13:
-            _log.info("*** Marker: APP13 (xFFED) ***");
+            LOG_INFO(_log, "*** Marker: APP13 (xFFED) ***");
             break;
 
         case JFIF_APP14:
-            _log.info("*** Marker: APP14 (xFFEE) ***");
+            LOG_INFO(_log, "*** Marker: APP14 (xFFEE) ***");
             break;
 
         case JFIF_APP15:
-            _log.info("*** Marker: APP15 (xFFEF) ***");
+            LOG_INFO(_log, "*** Marker: APP15 (xFFEF) ***");
             break;
 
         case JFIF_SOF0:
-            _log.info("*** Marker: SOF0 (Baseline DCT) (xFFC0) ***");
+            LOG_INFO(_log, "*** Marker: SOF0 (Baseline DCT) (xFFC0) ***");
             break;
 
         case JFIF_SOF1:
-            _log.info("*** Marker: SOF1 (Extended Sequential DCT, Huffman) (xFFC1) ***");
+            LOG_INFO(_log, "*** Marker: SOF1 (Extended Sequential DCT, Huffman) (xFFC1) ***");
             break;
 
         case JFIF_SOF2:
-            _log.info("*** Marker: SOF2 (Progressive DCT, Huffman) (xFFC2) ***");
+            LOG_INFO(_log, "*** Marker: SOF2 (Progressive DCT, Huffman) (xFFC2) ***");
             break;
 
         case JFIF_SOF3:
-            _log.info("*** Marker: SOF3 (Lossless Process, Huffman) (xFFC3) ***");
+            LOG_INFO(_log, "*** Marker: SOF3 (Lossless Process, Huffman) (xFFC3) ***");
             break;
 
         case JFIF_SOF5:
-            _log.info("*** Marker: SOF5 (Differential Sequential DCT, Huffman) (xFFC4) ***");
+            LOG_INFO(_log, "*** Marker: SOF5 (Differential Sequential DCT, Huffman) (xFFC4) ***");
             break;
 
         case JFIF_SOF6:
-            _log.info("*** Marker: SOF6 (Differential Progressive DCT, Huffman) (xFFC5) ***");
+            LOG_INFO(_log, "*** Marker: SOF6 (Differential Progressive DCT, Huffman) (xFFC5) ***");
             break;
 
         case JFIF_SOF7:
-            _log.info("*** Marker: SOF7 (Differential Lossless Process, Huffman) (xFFC6) ***");
+            LOG_INFO(_log, "*** Marker: SOF7 (Differential Lossless Process, Huffman) (xFFC6) ***");
             break;
 
         case JFIF_SOF9:
-            _log.info("*** Marker: SOF9 (Sequential DCT, Arithmetic) (xFFC9) ***");
+            LOG_INFO(_log, "*** Marker: SOF9 (Sequential DCT, Arithmetic) (xFFC9) ***");
             break;
 
         case JFIF_SOF10:
-            _log.info("*** Marker: SOF10 (Progressive DCT, Arithmetic) (xFFCA) ***");
+            LOG_INFO(_log, "*** Marker: SOF10 (Progressive DCT, Arithmetic) (xFFCA) ***");
             break;
 
         case JFIF_SOF11:
-            _log.info("*** Marker: SOF11 (Lossless Process, Arithmetic) (xFFCB) ***");
+            LOG_INFO(_log, "*** Marker: SOF11 (Lossless Process, Arithmetic) (xFFCB) ***");
             break;
 
         case JFIF_SOF13:
-            _log.info("*** Marker: SOF13 (Differential Sequential, Arithmetic) (xFFCD) ***");
+            LOG_INFO(_log, "*** Marker: SOF13 (Differential Sequential, Arithmetic) (xFFCD) ***");
             break;
 
         case JFIF_SOF14:
-            _log.info("*** Marker: SOF14 (Differential Progressive DCT, Arithmetic) (xFFCE) ***");
+            LOG_INFO(_log, "*** Marker: SOF14 (Differential Progressive DCT, Arithmetic) (xFFCE) ***");
             break;
 
         case JFIF_SOF15:
-            _log.info("*** Marker: SOF15 (Differential Lossless Process, Arithmetic) (xFFCF) ***");
+            LOG_INFO(_log, "*** Marker: SOF15 (Differential Lossless Process, Arithmetic) (xFFCF) ***");
             break;
 
         case JFIF_JPG:
-            _log.info("*** Marker: JPG (xFFC8) ***");
+            LOG_INFO(_log, "*** Marker: JPG (xFFC8) ***");
             break;
 
         case JFIF_DAC:
-            _log.info("*** Marker: DAC (xFFCC) ***");
+            LOG_INFO(_log, "*** Marker: DAC (xFFCC) ***");
             break;
 
         case JFIF_RST0:
@@ -6665,129 +6845,135 @@ void JfifDecode::addHeader(uint32_t code) {
         case JFIF_RST5:
         case JFIF_RST6:
         case JFIF_RST7:
-            _log.info("*** Marker: RST# ***");
+            LOG_INFO(_log, "*** Marker: RST# ***");
             break;
 
         case JFIF_DQT:             // Define quantization tables
-            _log.info("*** Marker: DQT (xFFDB) ***");
-            _log.info("  Define a Quantization Table.");
+            LOG_INFO(_log, "*** Marker: DQT (xFFDB) ***");
+            LOG_INFO(_log, "  Define a Quantization Table.");
             break;
 
         case JFIF_COM:             // COM
-            _log.info("*** Marker: COM (Comment) (xFFFE) ***");
+            LOG_INFO(_log, "*** Marker: COM (Comment) (xFFFE) ***");
             break;
 
         case JFIF_DHT:             // DHT
-            _log.info("*** Marker: DHT (Define Huffman Table) (xFFC4) ***");
+            LOG_INFO(_log, "*** Marker: DHT (Define Huffman Table) (xFFC4) ***");
             break;
 
         case JFIF_DHT_FAKE:        // DHT from standard table (MotionJPEG)
-            _log.info("*** Marker: DHT from MotionJPEG standard (Define Huffman Table) ***");
+            LOG_INFO(_log, "*** Marker: DHT from MotionJPEG standard (Define Huffman Table) ***");
             break;
 
         case JFIF_SOS:             // SOS
-            _log.info("*** Marker: SOS (Start of Scan) (xFFDA) ***");
+            LOG_INFO(_log, "*** Marker: SOS (Start of Scan) (xFFDA) ***");
             break;
 
         case JFIF_DRI:             // DRI
-            _log.info("*** Marker: DRI (Restart Interval) (xFFDD) ***");
+            LOG_INFO(_log, "*** Marker: DRI (Restart Interval) (xFFDD) ***");
             break;
 
         case JFIF_EOI:             // EOI
-            _log.info("*** Marker: EOI (End of Image) (xFFD9) ***");
+            LOG_INFO(_log, "*** Marker: EOI (End of Image) (xFFD9) ***");
             break;
 
         case JFIF_DNL:
-            _log.info("*** Marker: DNL (Define Number of Lines) (xFFDC) ***");
+            LOG_INFO(_log, "*** Marker: DNL (Define Number of Lines) (xFFDC) ***");
             break;
         case JFIF_DHP:
-            _log.info("*** Marker: DHP (Define Hierarchical Progression) (xFFDE) ***");
+            LOG_INFO(_log, "*** Marker: DHP (Define Hierarchical Progression) (xFFDE) ***");
             break;
         case JFIF_EXP:
-            _log.info("*** Marker: EXP (Expand Reference Components) (xFFDF) ***");
+            LOG_INFO(_log, "*** Marker: EXP (Expand Reference Components) (xFFDF) ***");
             break;
         case JFIF_JPG0:
-            _log.info("*** Marker: JPG0 (JPEG Extension) (xFFF0) ***");
+            LOG_INFO(_log, "*** Marker: JPG0 (JPEG Extension) (xFFF0) ***");
             break;
         case JFIF_JPG1:
-            _log.info("*** Marker: JPG1 (JPEG Extension) (xFFF1) ***");
+            LOG_INFO(_log, "*** Marker: JPG1 (JPEG Extension) (xFFF1) ***");
             break;
         case JFIF_JPG2:
-            _log.info("*** Marker: JPG2 (JPEG Extension) (xFFF2) ***");
+            LOG_INFO(_log, "*** Marker: JPG2 (JPEG Extension) (xFFF2) ***");
             break;
         case JFIF_JPG3:
-            _log.info("*** Marker: JPG3 (JPEG Extension) (xFFF3) ***");
+            LOG_INFO(_log, "*** Marker: JPG3 (JPEG Extension) (xFFF3) ***");
             break;
         case JFIF_JPG4:
-            _log.info("*** Marker: JPG4 (JPEG Extension) (xFFF4) ***");
+            LOG_INFO(_log, "*** Marker: JPG4 (JPEG Extension) (xFFF4) ***");
             break;
         case JFIF_JPG5:
-            _log.info("*** Marker: JPG5 (JPEG Extension) (xFFF5) ***");
+            LOG_INFO(_log, "*** Marker: JPG5 (JPEG Extension) (xFFF5) ***");
             break;
         case JFIF_JPG6:
-            _log.info("*** Marker: JPG6 (JPEG Extension) (xFFF6) ***");
+            LOG_INFO(_log, "*** Marker: JPG6 (JPEG Extension) (xFFF6) ***");
             break;
         case JFIF_JPG7:
-            _log.info("*** Marker: JPG7 (JPEG Extension) (xFFF7) ***");
+            LOG_INFO(_log, "*** Marker: JPG7 (JPEG Extension) (xFFF7) ***");
             break;
         case JFIF_JPG8:
-            _log.info("*** Marker: JPG8 (JPEG Extension) (xFFF8) ***");
+            LOG_INFO(_log, "*** Marker: JPG8 (JPEG Extension) (xFFF8) ***");
             break;
         case JFIF_JPG9:
-            _log.info("*** Marker: JPG9 (JPEG Extension) (xFFF9) ***");
+            LOG_INFO(_log, "*** Marker: JPG9 (JPEG Extension) (xFFF9) ***");
             break;
         case JFIF_JPG10:
-            _log.info("*** Marker: JPG10 (JPEG Extension) (xFFFA) ***");
+            LOG_INFO(_log, "*** Marker: JPG10 (JPEG Extension) (xFFFA) ***");
             break;
         case JFIF_JPG11:
-            _log.info("*** Marker: JPG11 (JPEG Extension) (xFFFB) ***");
+            LOG_INFO(_log, "*** Marker: JPG11 (JPEG Extension) (xFFFB) ***");
             break;
         case JFIF_JPG12:
-            _log.info("*** Marker: JPG12 (JPEG Extension) (xFFFC) ***");
+            LOG_INFO(_log, "*** Marker: JPG12 (JPEG Extension) (xFFFC) ***");
             break;
         case JFIF_JPG13:
-            _log.info("*** Marker: JPG13 (JPEG Extension) (xFFFD) ***");
+            LOG_INFO(_log, "*** Marker: JPG13 (JPEG Extension) (xFFFD) ***");
             break;
         case JFIF_TEM:
-            _log.info("*** Marker: TEM (Temporary) (xFF01) ***");
+            LOG_INFO(_log, "*** Marker: TEM (Temporary) (xFF01) ***");
             break;
 
         default:
-            strTmp = QString("*** Marker: ??? (Unknown) (xFF%1) ***").arg(code, 2, 16, QChar('0'));
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("*** Marker: ??? (Unknown) (xFF%1) ***").arg(code, 2, 16, QChar('0')));
             break;
     }
 
     // Adjust position to account for the word used in decoding the marker!
-    strTmp = QString("  OFFSET: 0x%1").arg(_pos - 2, 8, 16, QChar('0'));
-    _log.info(strTmp);
+    LOG_INFO(_log, QString("  OFFSET: 0x%1").arg(_pos - 2, 8, 16, QChar('0')));
 }
 
-uint32_t JfifDecode::writeBuf(QFile &file, uint32_t startOffset, uint32_t endOffset, bool overlayEnabled) {
+uint64_t JfifDecode::writeBuf(QFile &file, uint64_t startOffset, uint64_t endOffset, bool overlayEnabled) {
     if (endOffset < startOffset) return 0;
 
     auto size = endOffset - startOffset + 1;
     if (size > MAX_SEGMENT_SIZE) {
         size = MAX_SEGMENT_SIZE;
-        _log.warn("Segment size");
+        LOG_WARN(_log, "Segment size");
     }
 
-    const auto bufPtr = reinterpret_cast<const char *>(&_writeBuf);
+    // Copied inside the kernel unless overlay bytes have to be written
+    _wbuf.copyToFile(file, startOffset, size, !overlayEnabled);
 
-    auto index = startOffset;
-    const auto tmpEndOffset = startOffset + size - 1;
-    while (index <= tmpEndOffset) {
-        auto copyLength = tmpEndOffset - index + 1;
-        if (copyLength > EXPORT_BUF_SIZE) copyLength = EXPORT_BUF_SIZE;
+    return size;
+}
 
-        for (auto tmpIndex = 0; tmpIndex < copyLength; tmpIndex++) {
-            _writeBuf[tmpIndex] = getByte(index + tmpIndex, !overlayEnabled);
-        }
+// Append a range of the buffer to an in-memory export
+//
+uint64_t JfifDecode::writeBuf(QByteArray &data, uint64_t startOffset, uint64_t endOffset, bool overlayEnabled) {
+    if (endOffset < startOffset) return 0;
 
-        file.write(bufPtr, copyLength);
-        index += copyLength;
+    auto size = endOffset - startOffset + 1;
+    if (size > MAX_SEGMENT_SIZE) {
+        size = MAX_SEGMENT_SIZE;
+        LOG_WARN(_log, "Segment size");
     }
 
+    const auto nBase = data.size();
+    data.resize(nBase + static_cast<int>(size));
+
+    const auto nRead = _wbuf.readBytes(startOffset, reinterpret_cast<uint8_t *>(data.data()) + nBase,
+                                       static_cast<uint32_t>(size), !overlayEnabled);
+    data.resize(nBase + static_cast<int>(nRead));
+
     return size;
 }
 
@@ -6798,9 +6984,9 @@ void JfifDecode::decodeEmbeddedThumb() {
     QString strTmp;
     QString strMarker;
 
-    uint32_t nPosSaved;
-    uint32_t nPosSaved_sof;
-    uint32_t nPosEnd;
+    uint64_t nPosSaved;
+    uint64_t nPosSaved_sof;
+    uint64_t nPosEnd;
 
     bool bDone;
 
@@ -6826,12 +7012,10 @@ void JfifDecode::decodeEmbeddedThumb() {
 
     // Examine the EXIF embedded thumbnail (if it exists)
     if (m_nImgExifThumbComp == 6) {
-        _log.info("");
-        _log.info("*** Embedded JPEG Thumbnail ***");
-        strTmp = QString("  Offset: 0x%1").arg(m_nImgExifThumbOffset, 8, 16, QChar('0'));
-        _log.info(strTmp);
-        strTmp = QString("  Length: 0x%1 (%2)").arg(m_nImgExifThumbLen, 8, 16, QChar('0')).arg(m_nImgExifThumbLen);
-        _log.info(strTmp);
+        LOG_INFO(_log, "");
+        LOG_INFO(_log, "*** Embedded JPEG Thumbnail ***");
+        LOG_INFO(_log, QString("  Offset: 0x%1").arg(m_nImgExifThumbOffset, 8, 16, QChar('0')));
+        LOG_INFO(_log, QString("  Length: 0x%1 (%2)").arg(m_nImgExifThumbLen, 8, 16, QChar('0')).arg(m_nImgExifThumbLen));
 
         // Quick scan for DQT tables
         _pos = m_nImgExifThumbOffset;
@@ -6841,9 +7025,8 @@ void JfifDecode::decodeEmbeddedThumb() {
             // For some reason, I have found files that have a nLength of 0
             if (m_nImgExifThumbLen != 0) {
                 if ((_pos - m_nImgExifThumbOffset) > m_nImgExifThumbLen) {
-                    strTmp = QString("Read more than specified EXIF thumb nLength (%1 bytes) before EOI").arg(
-                        m_nImgExifThumbLen);
-                    _log.error(strTmp);
+                    LOG_ERROR(_log, QString("Read more than specified EXIF thumb nLength (%1 bytes) before EOI").arg(
+                        m_nImgExifThumbLen));
                     bErrorAny = true;
                     bDone = true;
                 }
@@ -6856,11 +7039,9 @@ void JfifDecode::decodeEmbeddedThumb() {
             }
 
             if ((!bDone) && (getByte(_pos++) != 0xFF)) {
-                strTmp =
-                    QString("Expected marker 0xFF, got 0x%1 @ offset 0x%2")
-                        .arg(getByte(_pos - 1), 2, 16, QChar('0'))
-                        .arg(_pos - 1, 8, 16, QChar('0'));
-                _log.error(strTmp);
+                LOG_ERROR(_log, QString("Expected marker 0xFF, got 0x%1 @ offset 0x%2")
+                    .arg(getByte(_pos - 1), 2, 16, QChar('0'))
+                    .arg(_pos - 1, 8, 16, QChar('0')));
                 bErrorAny = true;
                 bDone = true;
             }
@@ -6868,25 +7049,23 @@ void JfifDecode::decodeEmbeddedThumb() {
             if (!bDone) {
                 nCode = getByte(_pos++);
 
-                _log.info("");
+                LOG_INFO(_log, "");
 
                 switch (nCode) {
                     case JFIF_SOI:       // SOI
-                        _log.info("  * Embedded Thumb Marker: SOI");
+                        LOG_INFO(_log, "  * Embedded Thumb Marker: SOI");
                         break;
 
                     case JFIF_DQT:       // Define quantization tables
-                        _log.info("  * Embedded Thumb Marker: DQT");
+                        LOG_INFO(_log, "  * Embedded Thumb Marker: DQT");
 
                         nLength = getByte(_pos) * 256 + getByte(_pos + 1);
                         nPosEnd = _pos + nLength;
                         _pos += 2;
-                        strTmp = QString("    Length = %1").arg(nLength);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("    Length = %1").arg(nLength));
 
                         while (nPosEnd > _pos) {
-                            strTmp = QString("    ----");
-                            _log.info(strTmp);
+                            LOG_INFO(_log, QString("    ----"));
 
                             nTmpVal = getByte(_pos++);
                             nDqtPrecision_Pq = (nTmpVal & 0xF0) >> 4;
@@ -6901,30 +7080,30 @@ void JfifDecode::decodeEmbeddedThumb() {
                                 strPrecision = QString("??? unknown [value=%1]").arg(nDqtPrecision_Pq);
                             }
 
-                            strTmp = QString("    Precision=%1").arg(strPrecision);
-                            _log.info(strTmp);
-                            strTmp = QString("    Destination ID=%1").arg(nDqtQuantDestId_Tq);
-
-                            // NOTE: The mapping between destination IDs and the actual
-                            // usage is defined in the SOF marker which is often later.
-                            // In nearly all images, the following is true. However, I have
-                            // seen some test images that set Tbl 3 = Lum, Tbl 0=Chr,
-                            // Tbl1=Chr, and Tbl2 undefined
-                            if (nDqtQuantDestId_Tq == 0) {
-                                strTmp += " (Luminance, typically)";
-                            } else if (nDqtQuantDestId_Tq == 1) {
-                                strTmp += " (Chrominance, typically)";
-                            } else if (nDqtQuantDestId_Tq == 2) {
-                                strTmp += " (Chrominance, typically)";
-                            } else {
-                                strTmp += " (???)";
-                            }
+                            LOG_INFO(_log, QString("    Precision=%1").arg(strPrecision));
+                            if (LOG_INFO_ON(_log)) {
+                                strTmp = QString("    Destination ID=%1").arg(nDqtQuantDestId_Tq);
+
+                                // NOTE: The mapping between destination IDs and the actual
+                                // usage is defined in the SOF marker which is often later.
+                                // In nearly all images, the following is true. However, I have
+                                // seen some test images that set Tbl 3 = Lum, Tbl 0=Chr,
+                                // Tbl1=Chr, and Tbl2 undefined
+                                if (nDqtQuantDestId_Tq == 0) {
+                                    strTmp += " (Luminance, typically)";
+                                } else if (nDqtQuantDestId_Tq == 1) {
+                                    strTmp += " (Chrominance, typically)";
+                                } else if (nDqtQuantDestId_Tq == 2) {
+                                    strTmp += " (Chrominance, typically)";
+                                } else {
+                                    strTmp += " (???)";
+                                }
 
-                            _log.info(strTmp);
+                                LOG_INFO(_log, strTmp);
+                            }
 
                             if (nDqtQuantDestId_Tq >= 4) {
-                                strTmp = QString("nDqtQuantDestId_Tq = %1, >= 4").arg(nDqtQuantDestId_Tq);
-                                _log.error(strTmp);
+                                LOG_ERROR(_log, QString("nDqtQuantDestId_Tq = %1, >= 4").arg(nDqtQuantDestId_Tq));
                                 bDone = true;
                                 bErrorAny = true;
                                 break;
@@ -6953,44 +7132,39 @@ void JfifDecode::decodeEmbeddedThumb() {
                                     decodeErrCheck(bRet);
                                 }
 
-                                _log.info(strFull);
+                                LOG_INFO(_log, strFull);
                             }
                         }
 
                         break;
 
                     case JFIF_SOF0:
-                        _log.info("  * Embedded Thumb Marker: SOF");
+                        LOG_INFO(_log, "  * Embedded Thumb Marker: SOF");
                         nLength = getByte(_pos) * 256 + getByte(_pos + 1);
                         nPosSaved_sof = _pos;
                         _pos += 2;
-                        strTmp = QString("    Frame header length = %1").arg(nLength);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("    Frame header length = %1").arg(nLength));
 
                         nImgPrecision = getByte(_pos++);
-                        strTmp = QString("    Precision = %1").arg(nImgPrecision);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("    Precision = %1").arg(nImgPrecision));
 
                         m_nImgThumbNumLines = getByte(_pos) * 256 + getByte(_pos + 1);
                         _pos += 2;
-                        strTmp = QString("    Number of Lines = %1").arg(m_nImgThumbNumLines);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("    Number of Lines = %1").arg(m_nImgThumbNumLines));
 
                         m_nImgThumbSampsPerLine = getByte(_pos) * 256 + getByte(_pos + 1);
                         _pos += 2;
-                        strTmp = QString("    Samples per Line = %1").arg(m_nImgThumbSampsPerLine);
-                        _log.info(strTmp);
-                        strTmp = QString("    Image Size = %1 x %2").arg(m_nImgThumbSampsPerLine).arg(
-                            m_nImgThumbNumLines);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("    Samples per Line = %1").arg(m_nImgThumbSampsPerLine));
+                        LOG_INFO(_log, QString("    Image Size = %1 x %2").arg(m_nImgThumbSampsPerLine).arg(
+                            m_nImgThumbNumLines));
 
                         _pos = nPosSaved_sof + nLength;
 
                         break;
 
                     case JFIF_SOS:       // SOS
-                        _log.info("  * Embedded Thumb Marker: SOS");
-                        _log.info("    Skipping scan data");
+                        LOG_INFO(_log, "  * Embedded Thumb Marker: SOS");
+                        LOG_INFO(_log, "    Skipping scan data");
                         bScanSkipDone = false;
                         nSkipCount = 0;
 
@@ -7009,12 +7183,11 @@ void JfifDecode::decodeEmbeddedThumb() {
                             }
                         }
 
-                        strTmp = QString("    Skipped %1 bytes").arg(nSkipCount);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("    Skipped %1 bytes").arg(nSkipCount));
                         break;
 
                     case JFIF_EOI:
-                        _log.info("  * Embedded Thumb Marker: EOI");
+                        LOG_INFO(_log, "  * Embedded Thumb Marker: EOI");
                         bDone = true;
                         break;
 
@@ -7030,11 +7203,9 @@ void JfifDecode::decodeEmbeddedThumb() {
 
                     default:
                         getMarkerName(nCode, strMarker);
-                        strTmp = QString("  * Embedded Thumb Marker: %1").arg(strMarker);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("  * Embedded Thumb Marker: %1").arg(strMarker));
                         nLength = getByte(_pos) * 256 + getByte(_pos + 1);
-                        strTmp = QString("    Length = %1").arg(nLength);
-                        _log.info(strTmp);
+                        LOG_INFO(_log, QString("    Length = %1").arg(nLength));
                         _pos += nLength;
                         break;
                 }
@@ -7044,9 +7215,8 @@ void JfifDecode::decodeEmbeddedThumb() {
         // Now calculate the signature
         if (!bErrorAny) {
             // prepareSignatureThumb();
-            _log.info("");
-            strTmp = QString("  * Embedded Thumb Signature: %1").arg(m_strHashThumb);
-            _log.info(strTmp);
+            LOG_INFO(_log, "");
+            LOG_INFO(_log, QString("  * Embedded Thumb Signature: %1").arg(m_strHashThumb));
         }
 
         if (bErrorThumbLenZero) {
@@ -7091,11 +7261,11 @@ bool JfifDecode::getMarkerName(uint32_t code, QString &marker) {
 // If so, parse the headers.
 // TODO: Expand this function to use sub-functions for each block type
 bool JfifDecode::decodeAvi() {
-    _log.debug("JfifDecode::decodeAvi() Begin");
+    LOG_DEBUG(_log, "JfifDecode::decodeAvi() Begin");
 
     QString strTmp;
 
-    uint32_t nPosSaved;
+    uint64_t nPosSaved;
 
     _avi = false;
     _aviMjpeg = false;
@@ -7114,7 +7284,7 @@ bool JfifDecode::decodeAvi() {
 
     QString strForm;
 
-    _log.debug("JfifDecode::decodeAvi() Checkpoint 1");
+    LOG_DEBUG(_log, "JfifDecode::decodeAvi() Checkpoint 1");
 
     strRiff = _wbuf.readStrN(_pos, 4);
     _pos += 4;
@@ -7123,14 +7293,14 @@ bool JfifDecode::decodeAvi() {
     strForm = _wbuf.readStrN(_pos, 4);
     _pos += 4;
 
-    _log.debug("JfifDecode::decodeAvi() Checkpoint 2");
+    LOG_DEBUG(_log, "JfifDecode::decodeAvi() Checkpoint 2");
 
     if ((strRiff == "RIFF") && (strForm == "AVI ")) {
         _avi = true;
-        _log.info("");
-        _log.info("*** AVI File Decoding ***");
-        _log.info("Decoding RIFF AVI format...");
-        _log.info("");
+        LOG_INFO(_log, "");
+        LOG_INFO(_log, "*** AVI File Decoding ***");
+        LOG_INFO(_log, "Decoding RIFF AVI format...");
+        LOG_INFO(_log, "");
     } else {
         // Reset file position
         _pos = nPosSaved;
@@ -7140,7 +7310,7 @@ bool JfifDecode::decodeAvi() {
     QString strHeader;
 
     uint32_t nChunkSize;
-    uint32_t nChunkDataStart;
+    uint64_t nChunkDataStart;
 
     bool done = false;
 
@@ -7152,8 +7322,7 @@ bool JfifDecode::decodeAvi() {
 
         strHeader = _wbuf.readStrN(_pos, 4);
         _pos += 4;
-        strTmp = QString("  %1").arg(strHeader);
-        _log.info(strTmp);
+        LOG_INFO(_log, QString("  %1").arg(strHeader));
 
         nChunkSize = _wbuf.getDataX(_pos, 4, bSwap);
         _pos += 4;
@@ -7166,13 +7335,12 @@ bool JfifDecode::decodeAvi() {
             strListType = _wbuf.readStrN(_pos, 4);
             _pos += 4;
 
-            strTmp = QString("    %1").arg(strListType);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("    %1").arg(strListType));
 
             if (strListType == "hdrl") {
                 // --- hdrl ---
 
-                uint32_t nPosHdrlStart;
+                uint64_t nPosHdrlStart;
 
                 QString strHdrlId;
 
@@ -7192,7 +7360,7 @@ bool JfifDecode::decodeAvi() {
                 // --- strl ---
 
                 // strhHEADER
-                uint32_t nPosStrlStart;
+                uint64_t nPosStrlStart;
 
                 QString strStrlId;
 
@@ -7255,11 +7423,9 @@ bool JfifDecode::decodeAvi() {
                     fccTypeDecode = QString("[%1]").arg(fccType);
                 }
 
-                strTmp = QString("      -[FourCC Type]  = %1").arg(fccTypeDecode);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("      -[FourCC Type]  = %1").arg(fccTypeDecode));
 
-                strTmp = QString("      -[FourCC Codec] = [%1]").arg(fccHandler);
-                _log.info(strTmp);
+                LOG_INFO(_log, QString("      -[FourCC Codec] = [%1]").arg(fccHandler));
 
                 double fSampleRate = 0;
 
@@ -7267,20 +7433,22 @@ bool JfifDecode::decodeAvi() {
                     fSampleRate = static_cast<double>(dwRate) / static_cast<double>(dwScale);
                 }
 
-                strTmp = QString("      -[Sample Rate]  = [%.2f]").arg(fSampleRate);
+                if (LOG_INFO_ON(_log)) {
+                    strTmp = QString("      -[Sample Rate]  = [%.2f]").arg(fSampleRate);
 
-                if (fccType == "vids") {
-                    strTmp.append(" frames/sec");
-                } else if (fccType == "auds") {
-                    strTmp.append(" samples/sec");
-                }
+                    if (fccType == "vids") {
+                        strTmp.append(" frames/sec");
+                    } else if (fccType == "auds") {
+                        strTmp.append(" samples/sec");
+                    }
 
-                _log.info(strTmp);
+                    LOG_INFO(_log, strTmp);
+                }
 
                 _pos = nPosStrlStart + nStrhLen;      // Skip
 
                 strTmp = QString("      %1").arg(fccType);
-                _log.info(strTmp);
+                LOG_INFO(_log, strTmp);
 
                 if (fccType == "vids") {
                     // --- vids ---
@@ -7300,7 +7468,7 @@ bool JfifDecode::decodeAvi() {
                     QString strSkipId;
 
                     uint32_t nSkipLen;
-                    uint32_t nSkipStart;
+                    uint64_t nSkipStart;
 
                     strSkipId = _wbuf.readStrN(_pos, 4);
                     _pos += 4;
@@ -7317,7 +7485,7 @@ bool JfifDecode::decodeAvi() {
                     QString strSkipId;
 
                     uint32_t nSkipLen;
-                    uint32_t nSkipStart;
+                    uint64_t nSkipStart;
 
                     strSkipId = _wbuf.readStrN(_pos, 4);
                     _pos += 4;
@@ -7333,7 +7501,7 @@ bool JfifDecode::decodeAvi() {
 
                     uint32_t nSkipLen;
 
-                    uint32_t nSkipStart;
+                    uint64_t nSkipStart;
 
                     strSkipId = _wbuf.readStrN(_pos, 4);
                     _pos += 4;
@@ -7345,7 +7513,7 @@ bool JfifDecode::decodeAvi() {
                 }
 
                 // strnHEADER
-                uint32_t nPosStrnStart;
+                uint64_t nPosStrnStart;
 
                 QString strStrnId;
 
@@ -7367,7 +7535,7 @@ bool JfifDecode::decodeAvi() {
                 _pos = nChunkDataStart + nChunkSize + (nChunkSize % 2);
             } else if (strListType == "INFO") {
                 // INFO
-                uint32_t nInfoStart;
+                uint64_t nInfoStart;
 
                 nInfoStart = _pos;
 
@@ -7385,8 +7553,7 @@ bool JfifDecode::decodeAvi() {
 
                     strIsft = _wbuf.readStrN(_pos, nChunkSize);
                     strIsft = strIsft.trimmed();  //!! trim right
-                    strTmp = QString("      -[Software] = [%1]").arg(strIsft);
-                    _log.info(strTmp);
+                    LOG_INFO(_log, QString("      -[Software] = [%1]").arg(strIsft));
                 }
 
                 _pos = nChunkDataStart + nChunkSize + (nChunkSize % 2);
@@ -7405,8 +7572,7 @@ bool JfifDecode::decodeAvi() {
 
             strIditTimestamp = _wbuf.readStrN(_pos, nChunkSize);
             strIditTimestamp = strIditTimestamp.trimmed();    //!!
-            strTmp = QString("    -[Timestamp] = [1s]").arg(strIditTimestamp);
-            _log.info(strTmp);
+            LOG_INFO(_log, QString("    -[Timestamp] = [1s]").arg(strIditTimestamp));
 
             _pos = nChunkDataStart + nChunkSize + (nChunkSize % 2);
 
@@ -7425,23 +7591,23 @@ bool JfifDecode::decodeAvi() {
         }
     }
 
-    _log.info("");
+    LOG_INFO(_log, "");
 
     if (_aviMjpeg) {
         m_strImgExtras += "[AVI]:[mjpg],";
-        _log.info("  AVI is MotionJPEG");
-        _log.warn("  Use [Tools->Img Search Fwd] to locate next frame");
+        LOG_INFO(_log, "  AVI is MotionJPEG");
+        LOG_WARN(_log, "  Use [Tools->Img Search Fwd] to locate next frame");
     } else {
         m_strImgExtras += "[AVI]:[????],";
-        _log.warn("  AVI is not MotionJPEG. [Img Search Fwd/Rev] unlikely to find frames.");
+        LOG_WARN(_log, "  AVI is not MotionJPEG. [Img Search Fwd/Rev] unlikely to find frames.");
     }
 
-    _log.info("");
+    LOG_INFO(_log, "");
 
     // Reset file position
     _pos = nPosSaved;
 
-    _log.debug("JfifDecode::decodeAvi() End");
+    LOG_DEBUG(_log, "JfifDecode::decodeAvi() End");
 
     return _aviMjpeg;
 }
@@ -7450,7 +7616,7 @@ bool JfifDecode::decodeAvi() {
 // The main loop steps through all of the JFIF markers and calls
 // DecodeMarker() each time until we reach the end of file or an error.
 // Finally, we invoke the compression signature search function.
-void JfifDecode::processFile(uint32_t position) {
+void JfifDecode::processFile(uint64_t position) {
     // Reset the JFIF decoder state as we may be redoing another file
     reset();
 
@@ -7463,25 +7629,25 @@ void JfifDecode::processFile(uint32_t position) {
     // as we want top-level caller to do this. This way we can
     // still insert extra lines from top level.
 
-    // GetLength returns ULONGLONG. Abort on large files (>=4GB)
-    if (_wbuf.fileSize() > 0xFFFFFFFF) {
-        _log.error("File too large. Skipping.");
-        return;
-    }
-
-    _posFileEnd = static_cast<uint32_t>(_wbuf.fileSize());
+    _posFileEnd = static_cast<uint64_t>(_wbuf.fileSize());
 
     auto startPos = position;
     _pos = startPos;
     _posEmbedStart = startPos; // Save the embedded file start position
+    _contentPos = startPos;
 
-    _log.info(QString("Start Offset: 0x%1").arg(startPos, 8, 16, QChar('0')));
+    LOG_INFO(_log, QString("Start Offset: 0x%1").arg(startPos, 8, 16, QChar('0')));
 
     // ----------------------------------------------------------------
     // Test for AVI file
     // - Detect header
     // - start from beginning of file
-    decodeAvi();
+    if (_aviCheck) {
+        decodeAvi();
+    } else {
+        _avi = false;
+        _aviMjpeg = false;
+    }
     // TODO: Should we skip decode of file if not MJPEG?
     // ----------------------------------------------------------------
 
@@ -7493,7 +7659,7 @@ void JfifDecode::processFile(uint32_t position) {
     //     m_strImgExtras += strTmp;
     // }
 
-    uint32_t dataAfterEof = 0;
+    uint64_t dataAfterEof = 0;
 
     auto done = false;
     while (!done) {
@@ -7510,7 +7676,7 @@ void JfifDecode::processFile(uint32_t position) {
             }
         } else {
             if (_pos > _wbuf.fileSize()) {
-                _log.error("Early EOF - file may be missing EOI");
+                LOG_ERROR(_log, "Early EOF - file may be missing EOI");
                 done = true;
             }
         }
@@ -7549,7 +7715,7 @@ void JfifDecode::processFile(uint32_t position) {
                 m_strImgQuantCss = QString("%1x%2").arg(nCssFactH).arg(nCssFactV);
             } else {
                 // Portrait orientation (flip subsampling ratio)
-                m_strImgQuantCss = QString("%1x%1").arg(nCssFactV).arg(nCssFactH);
+                m_strImgQuantCss = QString("%1x%2").arg(nCssFactV).arg(nCssFactH);
             }
         } else if (m_nSofNumComps_Nf == NUM_CHAN_GRAYSCALE) {
             m_strImgQuantCss = "Gray";
@@ -7561,9 +7727,9 @@ void JfifDecode::processFile(uint32_t position) {
         // prepareSignature();
 
         if (dataAfterEof > 0) {
-            _log.info("");
-            _log.info("*** Additional Info ***");
-            _log.info(QString("Data exists after EOF, range: 0x%1-0x%2 (%3 bytes)")
+            LOG_INFO(_log, "");
+            LOG_INFO(_log, "*** Additional Info ***");
+            LOG_INFO(_log, QString("Data exists after EOF, range: 0x%1-0x%2 (%3 bytes)")
                           .arg(_posEoi, 8, 16, QChar('0'))
                           .arg(_posFileEnd, 8, 16, QChar('0'))
                           .arg(dataAfterEof));
@@ -7582,13 +7748,13 @@ bool JfifDecode::exportJpegPrepare(bool forceSoi, bool forceEoi, bool ignoreEoi)
     //   [m_nPosEmbedStart ... m_nPosEmbedEnd]
     // If state is valid (i.e. file opened)
 
-    _log.info("");
-    _log.info("*** Exporting JPEG ***");
+    LOG_INFO(_log, "");
+    LOG_INFO(_log, "*** Exporting JPEG ***");
 
     if (!_stateEoi) {
         if (!forceEoi && !ignoreEoi) {
-            _log.error(QString("Missing marker: %1").arg("EOI"));
-            _log.error("Aborting export. Consider enabling [Force EOI] or [Ignore Missing EOI] option");
+            LOG_ERROR(_log, QString("Missing marker: %1").arg("EOI"));
+            LOG_ERROR(_log, "Aborting export. Consider enabling [Force EOI] or [Ignore Missing EOI] option");
             return false;
         } else if (ignoreEoi) {
             _posEmbedEnd = _posFileEnd;
@@ -7596,14 +7762,14 @@ bool JfifDecode::exportJpegPrepare(bool forceSoi, bool forceEoi, bool ignoreEoi)
     }
 
     if ((_posEmbedStart == 0) && (_posEmbedEnd == 0)) {
-        _log.error("No frame found at this position in file. Consider using [Img Search]");
+        LOG_ERROR(_log, "No frame found at this position in file. Consider using [Img Search]");
         return false;
     }
 
     if (!_stateSoi) {
         if (!forceSoi) {
-            _log.error(QString("Missing marker: %1").arg("SOI"));
-            _log.error("Aborting export. Consider enabling [Force SOI] option");
+            LOG_ERROR(_log, QString("Missing marker: %1").arg("SOI"));
+            LOG_ERROR(_log, "Aborting export. Consider enabling [Force SOI] option");
             return false;
         } else {
             // We're missing the SOI but the user has requested
@@ -7612,8 +7778,8 @@ bool JfifDecode::exportJpegPrepare(bool forceSoi, bool forceEoi, bool ignoreEoi)
     }
 
     if (!_stateSos) {
-        _log.error(QString("Missing marker: %1").arg("SOS"));
-        _log.error("Aborting export");
+        LOG_ERROR(_log, QString("Missing marker: %1").arg("SOS"));
+        LOG_ERROR(_log, "Aborting export");
         return false;
     }
 
@@ -7623,12 +7789,12 @@ bool JfifDecode::exportJpegPrepare(bool forceSoi, bool forceEoi, bool ignoreEoi)
     if (!_stateSof) missing += "SOF ";
 
     if (!missing.isEmpty()) {
-        _log.warn(QString("Missing marker: %1").arg(missing));
-        _log.warn("Exported JPEG may not be valid");
+        LOG_WARN(_log, QString("Missing marker: %1").arg(missing));
+        LOG_WARN(_log, "Exported JPEG may not be valid");
     }
 
     if (_posEmbedEnd < _posEmbedStart) {
-        _log.error("Invalid SOI-EOI order. Export aborted.");
+        LOG_ERROR(_log, "Invalid SOI-EOI order. Export aborted.");
         return false;
     }
 
@@ -7638,14 +7804,14 @@ bool JfifDecode::exportJpegPrepare(bool forceSoi, bool forceEoi, bool ignoreEoi)
 // Export the embedded JPEG image at the current position in the file (with overlays)
 // (maybe the primary image or even an embedded thumbnail).
 bool JfifDecode::exportJpegDo(const QString &outFilePath, bool overlayEnabled, bool dhtAviInsert, bool forceSoi, bool forceEoi) {
-    _log.info(QString("Exporting to: [%1]").arg(outFilePath));
+    LOG_INFO(_log, QString("Exporting to: [%1]").arg(outFilePath));
 
     // Open specified file
     // Added in shareDenyNone as this apparently helps resolve some people's troubles
     // with an error showing: Couldn't open file "Sharing Violation"
     QFile outFile(outFilePath);
     if (!outFile.open(QIODevice::WriteOnly)) {
-        _log.error(QString("Couldn't open file for write [%1]: [%2]").arg(outFilePath, outFile.errorString()));
+        LOG_ERROR(_log, QString("Couldn't open file for write [%1]: [%2]").arg(outFilePath, outFile.errorString()));
         return false;
     }
 
@@ -7659,7 +7825,7 @@ bool JfifDecode::exportJpegDo(const QString &outFilePath, bool overlayEnabled, b
 
     // If we need to force an SOI, do it now
     if (!_stateSoi && forceSoi) {
-        _log.info("Forcing SOI Marker");
+        LOG_INFO(_log, "Forcing SOI Marker");
 
         uint8_t anBufSoi[2] = { 0xFF, JFIF_SOI };
         outFile.write(reinterpret_cast<const char *>(&anBufSoi), 2);
@@ -7669,7 +7835,7 @@ bool JfifDecode::exportJpegDo(const QString &outFilePath, bool overlayEnabled, b
 
     if (dhtAviInsert) {
         // Step 2. The following struct includes the JFIF marker too
-        _log.info("Inserting standard AVI DHT huffman table");
+        LOG_INFO(_log, "Inserting standard AVI DHT huffman table");
         outFile.write(reinterpret_cast<const char *>(&_motionJpegDhtSeg), JFIF_DHT_FAKE_SZ);
     }
 
@@ -7678,7 +7844,7 @@ bool JfifDecode::exportJpegDo(const QString &outFilePath, bool overlayEnabled, b
 
     // Now optionally insert the EOI Marker
     if (forceEoi) {
-        _log.info("Forcing EOI Marker");
+        LOG_INFO(_log, "Forcing EOI Marker");
 
         uint8_t anBufEoi[2] = { 0xFF, JFIF_EOI };
         outFile.write(reinterpret_cast<const char *>(&anBufEoi), 2);
@@ -7686,7 +7852,36 @@ bool JfifDecode::exportJpegDo(const QString &outFilePath, bool overlayEnabled, b
 
     outFile.close();
 
-    _log.info("Export done");
+    LOG_INFO(_log, "Export done");
+
+    return true;
+}
+
+// Export the embedded JPEG image into memory instead of a file
+// - Same layout as exportJpegDo(), for writers that collect many images
+//   (eg. PackWriter)
+bool JfifDecode::exportJpegData(QByteArray &data, bool overlayEnabled, bool dhtAviInsert, bool forceSoi, bool forceEoi) {
+    // Keeps the capacity when the caller reuses the array
+    data.resize(0);
+    data.reserve(static_cast<int>(qMin<uint64_t>(_posEmbedEnd - _posEmbedStart + 1 + JFIF_DHT_FAKE_SZ + 4, MAX_SEGMENT_SIZE)));
+
+    if (!_stateSoi && forceSoi) {
+        data += static_cast<char>(0xFF);
+        data += static_cast<char>(JFIF_SOI);
+    }
+
+    writeBuf(data, _posEmbedStart, _posSos - 1, overlayEnabled);
+
+    if (dhtAviInsert) {
+        data.append(reinterpret_cast<const char *>(&_motionJpegDhtSeg), JFIF_DHT_FAKE_SZ);
+    }
+
+    writeBuf(data, _posSos, _posEmbedEnd, overlayEnabled);
+
+    if (forceEoi) {
+        data += static_cast<char>(0xFF);
+        data += static_cast<char>(JFIF_EOI);
+    }
 
     return true;
 }
@@ -33,16 +33,16 @@
 #include <QString>
 
 #include <memory>
+#include <vector>
 
 // #include "DbSigs.h"
+#include "ContentHash.h"
 #include "DecodePs.h"
 #include "ImgDecode.h"
 #include "SnoopConfig.h"
 #include "WindowBuf.h"
 #include "log/ILog.h"
 
-static constexpr uint32_t EXPORT_BUF_SIZE = 128 * 1024;
-
 static const int32_t MAX_IFD_COMPS = 150;        // Maximum number of IFD entry components to display
 
 static const uint32_t JFIF_SOF0 = 0xC0;
@@ -130,6 +130,44 @@ struct MarkerNameTable {
     QString strName;
 };
 
+// Summary of the last analysis, for reporting without the text log
+// - Strings the decoder didn't find are left empty
+// - Quality factors are negative for a table that wasn't defined
+struct ImageInfo {
+    uint64_t nPosStart;           // Image start (SOI)
+    uint64_t nPosEnd;             // Image end (past the EOI, if found)
+    bool bEoiFound;
+
+    bool bProgressive;
+    uint32_t nPrecision;
+    uint32_t nWidth;
+    uint32_t nHeight;
+    uint32_t nNumComps;
+    QString strSubsampling;       // eg. "2x1", empty if not known
+
+    double dQualLum;              // Approx quality factor of DQT 0
+    double dQualChr;              // Approx quality factor of DQT 1
+    uint32_t nQualPhotoshopSa;    // Photoshop "Save As" quality, 0 if none
+    uint32_t nQualPhotoshopSfw;   // Photoshop "Save For Web" quality, 0 if none
+
+    QString strExifMake;
+    QString strExifModel;
+    QString strExifQual;          // Quality from the makernotes (eg. "fine")
+    QString strSoftware;
+    QString strHash;
+    QString strHashRot;
+
+    uint64_t nThumbOffset;        // EXIF JPEG thumbnail, 0 length if none
+    uint32_t nThumbLength;
+    uint64_t nScanLength;
+
+    uint64_t nIdentityHash;       // See JfifDecode::getIdentity()
+    uint64_t nIdentityLength;     // 0 if there is no identity
+
+    uint64_t nPerceptualHash;     // See JfifDecode::getPerceptualHash()
+    bool bPerceptualHash;         // false if there is no perceptual hash
+};
+
 class JfifDecode final {
     Q_DISABLE_COPY(JfifDecode)
 public:
@@ -141,9 +179,18 @@ public:
     // Public accesssor & mutator functions
     void getAviMode(bool &isAvi, bool &isMjpeg) const;
     void setAviMode(bool isAvi, bool isMjpeg);
-    uint32_t getPosEmbedStart() const;
-    uint32_t getPosEmbedEnd() const;
+    void setAviCheck(bool check);
+    uint64_t getPosEmbedStart() const;
+    uint64_t getPosEmbedEnd() const;
+    bool getEoiFound() const;
+    bool getExifThumb(uint64_t &nOffset, uint32_t &nLength) const;
+    uint64_t getScanLength() const;
+    const std::vector<uint64_t> &getScanRstPos() const;
+    ContentKey getIdentity() const;
+    bool getContentKey(uint64_t nPosEnd, ContentKey &key);
+    bool getPerceptualHash(uint64_t &nHash) const;
     void getDecodeSummary(QString &strHash, QString &strHashRot, QString &strImgExifMake, QString &strImgExifModel, QString &strImgQualExif, QString &strSoftware, teDbAdd &eDbReqSuggest);
+    void getImageInfo(ImageInfo &sInfo) const;
     uint32_t getDqtZigZagIndex(uint32_t nInd, bool bZigZag);
     uint32_t getDqtQuantStd(uint32_t nInd);
 
@@ -152,11 +199,13 @@ public:
     // void ExportRangeSet(uint32_t nStart, uint32_t nEnd);
     bool exportJpegPrepare(bool forceSoi, bool forceEoi, bool ignoreEoi);
     bool exportJpegDo(const QString &outFilePath, bool overlayEnabled, bool dhtAviInsert, bool forceSoi, bool forceEoi);
+    bool exportJpegData(QByteArray &data, bool overlayEnabled, bool dhtAviInsert, bool forceSoi, bool forceEoi);
 
-    void processFile(uint32_t position);
+    void processFile(uint64_t position);
 
 private:
-    uint32_t writeBuf(QFile &file, uint32_t startOffset, uint32_t endOffset, bool overlayEnabled);
+    uint64_t writeBuf(QFile &file, uint64_t startOffset, uint64_t endOffset, bool overlayEnabled);
+    uint64_t writeBuf(QByteArray &data, uint64_t startOffset, uint64_t endOffset, bool overlayEnabled);
 
     // Display routines
     void dbgAddLine(const QString &strLine);
@@ -166,16 +215,18 @@ private:
     QString printAsHex32(uint32_t *anWords, uint32_t nCount);
 
     // Buffer access
-    quint8 getByte(uint32_t nOffset, bool bClean);
+    quint8 getByte(uint64_t nOffset, bool bClean);
     void unByteSwap4(uint32_t nVal, uint32_t &nByte0, uint32_t &nByte1, uint32_t &nByte2, uint32_t &nByte3);
     uint32_t byteSwap4(uint32_t nByte0, uint32_t nByte1, uint32_t nByte2, uint32_t nByte3);
     uint32_t byteSwap2(uint32_t nByte0, uint32_t nByte1);
-    uint32_t readSwap2(uint32_t nPos);
-    uint32_t readSwap4(uint32_t nPos);
-    uint32_t readBe4(uint32_t nPos);
+    uint32_t readSwap2(uint64_t nPos);
+    uint32_t readSwap4(uint64_t nPos);
+    uint32_t readBe4(uint64_t nPos);
 
     uint32_t decodeMarker();
-    bool expectMarkerEnd(uint32_t nMarkerStart, uint32_t nMarkerLen);
+    void hashIdentitySegment(uint32_t nCode);
+    void hashContentTo(uint64_t nPosEnd);
+    bool expectMarkerEnd(uint64_t nMarkerStart, uint32_t nMarkerLen);
     void decodeEmbeddedThumb();
     bool decodeAvi();
 
@@ -183,14 +234,14 @@ private:
 
     // Marker specific parsing
     static bool getMarkerName(uint32_t code, QString &marker);
-    uint32_t decodeExifIfd(const QString &strIfd, uint32_t nPosExifStart, uint32_t nStartIfdPtr);
+    uint32_t decodeExifIfd(const QString &strIfd, uint64_t nPosExifStart, uint32_t nStartIfdPtr);
     // uint32_t DecodeMakerIfd(uint32_t ifd_tag,uint32_t ptr,uint32_t len);
     bool decodeMakerSubType();
     void decodeDht(bool bInject);
     uint32_t decodeApp13Ps();
     uint32_t decodeApp2FlashPix();
     uint32_t decodeApp2IccProfile(uint32_t nLen);
-    uint32_t decodeIccHeader(uint32_t nPos);
+    uint32_t decodeIccHeader(uint64_t nPos);
 
     // DQT / DHT
     void clearDqt();
@@ -198,9 +249,9 @@ private:
     void genLookupHuffMask();
 
     // Field parsing
-    bool decodeValRational(uint32_t nPos, double &nVal);
-    QString decodeValFraction(uint32_t nPos);
-    bool decodeValGps(uint32_t nPos, QString &strCoord);
+    bool decodeValRational(uint64_t nPos, double &nVal);
+    QString decodeValFraction(uint64_t nPos);
+    bool decodeValGps(uint64_t nPos, QString &strCoord);
     bool printValGps(uint32_t nCount, double fCoord1, double fCoord2, double fCoord3, QString &coord);
     QString decodeIccDateTime(uint32_t anVal[3]);
     QString lookupExifTag(const QString &strSect, uint32_t nTag, bool &bUnknown);
@@ -215,7 +266,6 @@ private:
     SnoopConfig &_appConfig;
     std::unique_ptr<DecodePs> _psDec;
 
-    uint8_t _writeBuf[EXPORT_BUF_SIZE];
     bool _verbose;
     bool _bufFakeDht;           // Flag to redirect DHT read to AVI DHT over Buffer content
 
@@ -227,17 +277,29 @@ private:
     bool _imgOk;                // Img decode encounter SOF
     bool _avi;                  // Is it an AVI file?
     bool _aviMjpeg;             // Is it a MotionJPEG AVI file?
+    bool _aviCheck;             // Look for an AVI header (see setAviCheck())
     bool _psd;                  // Is it a Photoshop file?
 
     bool _imgSrcDirty;          // Do we need to recalculate the scan decode?
 
     // File position records
-    uint32_t _pos;           // Current file/buffer position
-    uint32_t _posEoi;        // Position of EOI (0xFFD9) marker
-    uint32_t _posSos;
-    uint32_t _posEmbedStart; // Embedded/offset start
-    uint32_t _posEmbedEnd;   // Embedded/offset end
-    uint32_t _posFileEnd;    // End of file position
+    uint64_t _pos;           // Current file/buffer position
+    uint64_t _posEoi;        // Position of EOI (0xFFD9) marker
+    uint64_t _posSos;
+    uint64_t _posEmbedStart; // Embedded/offset start
+    uint64_t _posEmbedEnd;   // Embedded/offset end
+    uint64_t _posFileEnd;    // End of file position
+
+    // Scan data records (summed over all scans)
+    uint64_t _scanLength;                // Bytes of entropy-coded data
+    std::vector<uint64_t> _scanRstPos;   // Positions of the RSTn markers
+    ContentHash _identity;               // See getIdentity()
+    ContentHash _content;                // See getContentKey()
+    uint64_t _contentPos;                // Bytes before this are in _content
+    bool _contentOk;                     // _content holds every byte up to _contentPos
+    bool _perceptualHashTried;           // The scan was decoded for _perceptualHash
+    bool _perceptualHashSet;             // _perceptualHash is set
+    uint64_t _perceptualHash;            // See getPerceptualHash()
 
     // Decoder state
     char _app0Identifier[MAX_IDENTIFIER];      // APP0 type: JFIF, AVI1, etc.
@@ -309,7 +371,7 @@ private:
 
     // Embedded EXIF Thumbnail
     uint32_t m_nImgExifThumbComp;
-    uint32_t m_nImgExifThumbOffset;
+    uint64_t m_nImgExifThumbOffset;
     uint32_t m_nImgExifThumbLen;
     uint32_t m_anImgThumbDqt[4][64];
     bool m_abImgDqtThumbSet[4];
@@ -0,0 +1,321 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "KnownHashSet.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+// Bytes of the hash list read at a time by build()
+static constexpr qint64 HASH_LIST_BLOCK = 1024 * 1024;
+
+typedef std::array<uint8_t, 16> Md5Hash;
+
+KnownHashSet::~KnownHashSet() {
+    close();
+}
+
+// Map a set written by build()
+// - The set is rejected if any of its tables lie outside the file
+//
+// RETURN:
+// - Success in mapping a complete set
+//
+bool KnownHashSet::open(const QString &setPath) {
+    close();
+
+    _file.setFileName(setPath);
+    if (!_file.open(QIODevice::ReadOnly)) return false;
+
+    const auto nSize = static_cast<uint64_t>(_file.size());
+    if (nSize < sizeof(HashSetHeader)) {
+        close();
+        return false;
+    }
+
+    _map = _file.map(0, _file.size());
+    if (!_map) {
+        close();
+        return false;
+    }
+
+    const auto header = reinterpret_cast<const HashSetHeader *>(_map);
+    const auto nFanoutSize = (HASH_SET_FANOUT + 1) * sizeof(uint64_t);
+
+    const auto bValid = memcmp(header->anMagic, HASH_SET_MAGIC, sizeof(HASH_SET_MAGIC)) == 0
+                        && header->nVersion == HASH_SET_VERSION
+                        && header->nByteOrder == HASH_SET_BYTE_ORDER
+                        && header->nBloomWords > 0
+                        && (header->nBloomWords & (header->nBloomWords - 1)) == 0
+                        && header->nBloomOffset >= sizeof(HashSetHeader)
+                        && header->nBloomWords <= (nSize - header->nBloomOffset) / sizeof(uint64_t)
+                        && header->nFanoutOffset >= header->nBloomOffset + header->nBloomWords * sizeof(uint64_t)
+                        && header->nFanoutOffset <= nSize && nFanoutSize <= nSize - header->nFanoutOffset
+                        && header->nHashOffset >= header->nFanoutOffset + nFanoutSize
+                        && header->nHashOffset <= nSize
+                        && header->nHashCount <= (nSize - header->nHashOffset) / 16;
+
+    if (!bValid) {
+        close();
+        return false;
+    }
+
+    _header = header;
+    _bloom = reinterpret_cast<const uint64_t *>(_map + header->nBloomOffset);
+    _fanout = reinterpret_cast<const uint64_t *>(_map + header->nFanoutOffset);
+    _hashes = _map + header->nHashOffset;
+
+    // Lookups trust the fanout to stay inside the hash table
+    if (_fanout[HASH_SET_FANOUT] != header->nHashCount) {
+        close();
+        return false;
+    }
+
+    for (uint32_t nBucket = 0; nBucket < HASH_SET_FANOUT; nBucket++) {
+        if (_fanout[nBucket] > _fanout[nBucket + 1]) {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void KnownHashSet::close() {
+    if (_map) {
+        _file.unmap(const_cast<uchar *>(_map));
+    }
+
+    _file.close();
+
+    _map = nullptr;
+    _header = nullptr;
+    _bloom = nullptr;
+    _fanout = nullptr;
+    _hashes = nullptr;
+}
+
+uint64_t KnownHashSet::count() const {
+    return _header ? _header->nHashCount : 0;
+}
+
+// Determine whether an MD5 is in the set
+//
+bool KnownHashSet::contains(const uint8_t anMd5[16]) const {
+    if (!_header) return false;
+
+    // Any clear probe bit means the hash was never added
+    uint64_t nBase, nStep;
+    bloomProbes(anMd5, nBase, nStep);
+
+    const auto nMask = _header->nBloomWords * 64 - 1;
+
+    for (uint32_t nProbe = 0; nProbe < _header->nBloomProbes; nProbe++) {
+        const auto nBit = (nBase + nProbe * nStep) & nMask;
+        if ((_bloom[nBit >> 6] & (1ULL << (nBit & 63))) == 0) return false;
+    }
+
+    const auto nBucket = (static_cast<uint32_t>(anMd5[0]) << 8) | anMd5[1];
+    auto nLo = _fanout[nBucket];
+    auto nHi = _fanout[nBucket + 1];
+
+    while (nLo < nHi) {
+        const auto nMid = nLo + (nHi - nLo) / 2;
+        const auto nCmp = memcmp(_hashes + nMid * 16, anMd5, 16);
+
+        if (nCmp == 0) return true;
+
+        if (nCmp < 0) {
+            nLo = nMid + 1;
+        } else {
+            nHi = nMid;
+        }
+    }
+
+    return false;
+}
+
+// Build a set from a list of MD5 hashes
+// - Reads one hash per line (see parseHash()); lines without one, such
+//   as headers, are skipped
+//
+// INPUT:
+// - listPath                   Hash list to read
+// - setPath                    Set file to write
+// - nBloomBits                 Bloom filter bits per hash
+//
+// OUTPUT:
+// - pCount                     If not null, number of distinct hashes
+//
+// RETURN:
+// - Success in reading the list and writing the set
+//
+bool KnownHashSet::build(const QString &listPath, const QString &setPath, uint32_t nBloomBits, uint64_t *pCount) {
+    QFile list(listPath);
+    if (!list.open(QIODevice::ReadOnly)) return false;
+
+    std::vector<Md5Hash> hashes;
+    std::vector<char> block(HASH_LIST_BLOCK);
+    std::vector<char> line;
+
+    const auto addLine = [&hashes, &line]() {
+        Md5Hash hash;
+        if (parseHash(line.data(), line.size(), hash.data())) {
+            hashes.push_back(hash);
+        }
+
+        line.clear();
+    };
+
+    for (;;) {
+        const auto nRead = list.read(block.data(), HASH_LIST_BLOCK);
+        if (nRead < 0) return false;
+        if (nRead == 0) break;
+
+        for (qint64 nInd = 0; nInd < nRead; nInd++) {
+            if (block[nInd] == '\n') {
+                addLine();
+            } else {
+                line.push_back(block[nInd]);
+            }
+        }
+    }
+
+    // Last line without a newline
+    addLine();
+
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+    // The filter size is rounded up to a power of two so that probes
+    // can be masked instead of divided
+    const auto nBits = qMax<uint64_t>(hashes.size() * nBloomBits, 64);
+    uint64_t nBloomWords = 1;
+    while (nBloomWords * 64 < nBits) {
+        nBloomWords <<= 1;
+    }
+
+    std::vector<uint64_t> bloom(nBloomWords, 0);
+    std::vector<uint64_t> fanout(HASH_SET_FANOUT + 1, 0);
+    const auto nMask = nBloomWords * 64 - 1;
+
+    for (const auto &hash : hashes) {
+        uint64_t nBase, nStep;
+        bloomProbes(hash.data(), nBase, nStep);
+
+        for (uint32_t nProbe = 0; nProbe < HASH_SET_BLOOM_PROBES; nProbe++) {
+            const auto nBit = (nBase + nProbe * nStep) & nMask;
+            bloom[nBit >> 6] |= 1ULL << (nBit & 63);
+        }
+
+        fanout[((static_cast<uint32_t>(hash[0]) << 8) | hash[1]) + 1]++;
+    }
+
+    for (uint32_t nBucket = 0; nBucket < HASH_SET_FANOUT; nBucket++) {
+        fanout[nBucket + 1] += fanout[nBucket];
+    }
+
+    HashSetHeader header = {};
+    memcpy(header.anMagic, HASH_SET_MAGIC, sizeof(HASH_SET_MAGIC));
+    header.nVersion = HASH_SET_VERSION;
+    header.nByteOrder = HASH_SET_BYTE_ORDER;
+    header.nHashCount = hashes.size();
+    header.nBloomWords = nBloomWords;
+    header.nBloomProbes = HASH_SET_BLOOM_PROBES;
+    header.nBloomOffset = sizeof(HashSetHeader);
+    header.nFanoutOffset = header.nBloomOffset + nBloomWords * sizeof(uint64_t);
+    header.nHashOffset = header.nFanoutOffset + fanout.size() * sizeof(uint64_t);
+
+    QFile file(setPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    const auto writeAll = [&file](const void *pData, uint64_t nLen) {
+        return file.write(reinterpret_cast<const char *>(pData), static_cast<qint64>(nLen)) == static_cast<qint64>(nLen);
+    };
+
+    const auto bOk = writeAll(&header, sizeof(header))
+                     && writeAll(bloom.data(), bloom.size() * sizeof(uint64_t))
+                     && writeAll(fanout.data(), fanout.size() * sizeof(uint64_t))
+                     && writeAll(hashes.data(), hashes.size() * sizeof(Md5Hash));
+
+    if (bOk && pCount) {
+        *pCount = hashes.size();
+    }
+
+    return bOk;
+}
+
+// Find the MD5 in a line of a hash list
+// - Takes the first run of exactly 32 hex digits, so plain lists,
+//   md5sum output and CSV exports with longer hashes (eg. SHA-1) in
+//   earlier columns are all read
+//
+// OUTPUT:
+// - anMd5                      The hash, if found
+//
+// RETURN:
+// - Whether the line holds an MD5
+//
+bool KnownHashSet::parseHash(const char *pLine, size_t nLen, uint8_t anMd5[16]) {
+    const auto hexVal = [](char ch) -> int {
+        if (ch >= '0' && ch <= '9') return ch - '0';
+        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+        return -1;
+    };
+
+    size_t nInd = 0;
+
+    while (nInd < nLen) {
+        if (hexVal(pLine[nInd]) < 0) {
+            nInd++;
+            continue;
+        }
+
+        auto nRunEnd = nInd;
+        while (nRunEnd < nLen && hexVal(pLine[nRunEnd]) >= 0) {
+            nRunEnd++;
+        }
+
+        if (nRunEnd - nInd == 32) {
+            for (uint32_t nByte = 0; nByte < 16; nByte++) {
+                anMd5[nByte] = static_cast<uint8_t>((hexVal(pLine[nInd + nByte * 2]) << 4) | hexVal(pLine[nInd + nByte * 2 + 1]));
+            }
+
+            return true;
+        }
+
+        nInd = nRunEnd;
+    }
+
+    return false;
+}
+
+// Bloom filter probes are nBase + i * nStep (double hashing)
+// - An MD5 is already uniformly distributed, so its two halves serve
+//   as the two hashes
+//
+void KnownHashSet::bloomProbes(const uint8_t anMd5[16], uint64_t &nBase, uint64_t &nStep) {
+    memcpy(&nBase, anMd5, sizeof(nBase));
+    memcpy(&nStep, anMd5 + 8, sizeof(nStep));
+
+    // An odd step visits distinct bits of the power-of-two filter
+    nStep |= 1;
+}
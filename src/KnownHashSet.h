@@ -0,0 +1,103 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Set of known-file MD5 hashes (eg. stock or operating system images)
+//   that carving can leave out
+// - Built once from a hash list by build(), then memory-mapped by
+//   open(), so sets of millions of hashes load instantly and only the
+//   pages that lookups touch are read
+// - A Bloom filter answers most lookups of unknown images without
+//   touching the hash table; the rest are settled by a search of the
+//   sorted hashes, narrowed by a fanout table on their first two bytes
+// - File layout (host byte order, checked through nByteOrder):
+//   - HashSetHeader
+//   - Bloom filter, uint64_t[nBloomWords]
+//   - Fanout, uint64_t[HASH_SET_FANOUT + 1]: entry i counts the hashes
+//     whose first two bytes are below i
+//   - Hashes, uint8_t[nHashCount][16], sorted and unique
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_KNOWNHASHSET_H
+#define JPEGSNOOP_KNOWNHASHSET_H
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+
+static const char HASH_SET_MAGIC[8] = {'J', 'S', 'N', 'P', 'K', 'H', 'S', 'T'};
+static constexpr uint32_t HASH_SET_VERSION = 1;
+static constexpr uint32_t HASH_SET_BYTE_ORDER = 0x01020304;
+
+// Fanout buckets, indexed by the first two bytes of a hash
+static constexpr uint32_t HASH_SET_FANOUT = 65536;
+
+// Bloom filter bits per hash (about 1% false positives with 7 probes)
+static constexpr uint32_t HASH_SET_BLOOM_BITS = 10;
+static constexpr uint32_t HASH_SET_BLOOM_PROBES = 7;
+
+struct HashSetHeader {
+    char anMagic[8];            // HASH_SET_MAGIC
+    uint32_t nVersion;          // HASH_SET_VERSION
+    uint32_t nByteOrder;        // HASH_SET_BYTE_ORDER as written
+    uint64_t nHashCount;
+    uint64_t nBloomWords;       // A power of two
+    uint32_t nBloomProbes;
+    uint32_t nReserved;
+    uint64_t nBloomOffset;      // File offset of the Bloom filter
+    uint64_t nFanoutOffset;     // File offset of the fanout table
+    uint64_t nHashOffset;       // File offset of the sorted hashes
+};
+
+static_assert(sizeof(HashSetHeader) == 64, "Hash set header layout");
+
+class KnownHashSet {
+    Q_DISABLE_COPY(KnownHashSet)
+public:
+    KnownHashSet() = default;
+    ~KnownHashSet();
+
+    bool open(const QString &setPath);
+    void close();
+
+    bool isOpen() const { return _header != nullptr; }
+    uint64_t count() const;
+
+    bool contains(const uint8_t anMd5[16]) const;
+
+    static bool build(const QString &listPath, const QString &setPath, uint32_t nBloomBits = HASH_SET_BLOOM_BITS,
+                      uint64_t *pCount = nullptr);
+    static bool parseHash(const char *pLine, size_t nLen, uint8_t anMd5[16]);
+
+private:
+    static void bloomProbes(const uint8_t anMd5[16], uint64_t &nBase, uint64_t &nStep);
+
+    QFile _file;
+    const uchar *_map = nullptr;
+    const HashSetHeader *_header = nullptr;
+    const uint64_t *_bloom = nullptr;
+    const uint64_t *_fanout = nullptr;
+    const uint8_t *_hashes = nullptr;
+};
+
+#endif
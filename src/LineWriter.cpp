@@ -0,0 +1,87 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "LineWriter.h"
+
+#include <cstdio>
+
+LineWriter::LineWriter(const QString &filePath) {
+    openOutput(_file, filePath);
+
+    _buf.reserve(LINE_WRITER_BUF * 2);
+}
+
+LineWriter::~LineWriter() {
+    flush();
+    _file.close();
+}
+
+bool LineWriter::isOpen() const {
+    return _file.isOpen();
+}
+
+// Add one or more finished lines
+// - Callers format their lines before taking the lock
+//
+void LineWriter::append(const QByteArray &lines) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _buf += lines;
+    if (_buf.size() >= LINE_WRITER_BUF) {
+        writeBuf();
+    }
+}
+
+// Write out the buffered lines
+//
+void LineWriter::flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    writeBuf();
+    _file.flush();
+}
+
+// Open a file for output, truncating it
+// - An empty path or "-" writes to stdout
+// - Also used by AsyncLog, which writes from its own thread
+//
+// RETURN:
+// - Whether the file could be opened
+//
+bool LineWriter::openOutput(QFile &file, const QString &filePath) {
+    if (filePath.isEmpty() || filePath == "-") {
+        return file.open(stdout, QIODevice::WriteOnly);
+    }
+
+    file.setFileName(filePath);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+// PRE:
+// - _mutex is held
+//
+void LineWriter::writeBuf() {
+    if (_buf.isEmpty()) return;
+
+    if (_file.isOpen()) {
+        _file.write(_buf);
+    }
+
+    _buf.clear();
+}
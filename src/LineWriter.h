@@ -0,0 +1,66 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Buffered output of text lines to a file or stdout, shared by the
+//   writers of line-based result files (ResultWriter, HashManifest)
+// - Lines are appended to a buffer and written out in large blocks.
+//   append() may be called from several threads; each call is written
+//   whole.
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_LINEWRITER_H
+#define JPEGSNOOP_LINEWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <mutex>
+
+// Bytes of lines buffered before they are written out
+static constexpr int LINE_WRITER_BUF = 64 * 1024;
+
+class LineWriter {
+    Q_DISABLE_COPY(LineWriter)
+public:
+    // An empty path or "-" writes to stdout
+    explicit LineWriter(const QString &filePath);
+    ~LineWriter();
+
+    bool isOpen() const;
+
+    void append(const QByteArray &lines);
+    void flush();
+
+    static bool openOutput(QFile &file, const QString &filePath);
+
+private:
+    void writeBuf();
+
+    QFile _file;
+    std::mutex _mutex;
+    QByteArray _buf;
+};
+
+#endif
@@ -0,0 +1,335 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "Md5Multi.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JPEGSNOOP_MD5_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// One 32-bit word of every lane
+#ifdef JPEGSNOOP_MD5_SSE2
+
+typedef __m128i Lanes;
+
+inline Lanes lanesLoad(const uint32_t *pnWords) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(pnWords)); }
+inline void lanesStore(uint32_t *pnWords, Lanes x) { _mm_storeu_si128(reinterpret_cast<__m128i *>(pnWords), x); }
+inline Lanes lanesSplat(uint32_t n) { return _mm_set1_epi32(static_cast<int>(n)); }
+inline Lanes lanesAdd(Lanes x, Lanes y) { return _mm_add_epi32(x, y); }
+inline Lanes lanesAnd(Lanes x, Lanes y) { return _mm_and_si128(x, y); }
+inline Lanes lanesOr(Lanes x, Lanes y) { return _mm_or_si128(x, y); }
+inline Lanes lanesXor(Lanes x, Lanes y) { return _mm_xor_si128(x, y); }
+
+template<int N>
+inline Lanes lanesRotl(Lanes x) { return _mm_or_si128(_mm_slli_epi32(x, N), _mm_srli_epi32(x, 32 - N)); }
+
+#else
+
+struct Lanes {
+    uint32_t an[MD5_MULTI_LANES];
+};
+
+inline Lanes lanesLoad(const uint32_t *pnWords) {
+    Lanes x;
+    memcpy(x.an, pnWords, sizeof(x.an));
+    return x;
+}
+
+inline void lanesStore(uint32_t *pnWords, Lanes x) {
+    memcpy(pnWords, x.an, sizeof(x.an));
+}
+
+inline Lanes lanesSplat(uint32_t n) {
+    Lanes x;
+    for (auto &nLane : x.an) nLane = n;
+    return x;
+}
+
+#define MD5_LANES_OP(name, op)                                      \
+    inline Lanes name(Lanes x, Lanes y) {                           \
+        for (size_t nLane = 0; nLane < MD5_MULTI_LANES; nLane++) {  \
+            x.an[nLane] = x.an[nLane] op y.an[nLane];               \
+        }                                                           \
+        return x;                                                   \
+    }
+
+MD5_LANES_OP(lanesAdd, +)
+MD5_LANES_OP(lanesAnd, &)
+MD5_LANES_OP(lanesOr, |)
+MD5_LANES_OP(lanesXor, ^)
+
+#undef MD5_LANES_OP
+
+template<int N>
+inline Lanes lanesRotl(Lanes x) {
+    for (auto &nLane : x.an) nLane = (nLane << N) | (nLane >> (32 - N));
+    return x;
+}
+
+#endif
+
+// The MD5 round functions (RFC 1321), in forms that need no NOT except in I
+inline Lanes md5F(Lanes x, Lanes y, Lanes z) { return lanesXor(z, lanesAnd(x, lanesXor(y, z))); }
+inline Lanes md5G(Lanes x, Lanes y, Lanes z) { return lanesXor(y, lanesAnd(z, lanesXor(x, y))); }
+inline Lanes md5H(Lanes x, Lanes y, Lanes z) { return lanesXor(lanesXor(x, y), z); }
+inline Lanes md5I(Lanes x, Lanes y, Lanes z) { return lanesXor(y, lanesOr(x, lanesXor(z, lanesSplat(0xFFFFFFFF)))); }
+
+#define MD5_STEP(f, a, b, c, d, x, t, s) \
+    a = lanesAdd(b, lanesRotl<s>(lanesAdd(lanesAdd(a, f(b, c, d)), lanesAdd(x, lanesSplat(t)))))
+
+inline uint32_t readLe32(const uint8_t *pData) {
+    return static_cast<uint32_t>(pData[0]) | (static_cast<uint32_t>(pData[1]) << 8)
+           | (static_cast<uint32_t>(pData[2]) << 16) | (static_cast<uint32_t>(pData[3]) << 24);
+}
+
+// Compress one 64-byte block of every lane into its state
+//
+void md5Compress(Lanes anState[4], const uint8_t *const apBlock[MD5_MULTI_LANES]) {
+    Lanes w[16];
+
+    for (size_t nWord = 0; nWord < 16; nWord++) {
+        uint32_t anWord[MD5_MULTI_LANES];
+        for (size_t nLane = 0; nLane < MD5_MULTI_LANES; nLane++) {
+            anWord[nLane] = readLe32(apBlock[nLane] + nWord * 4);
+        }
+
+        w[nWord] = lanesLoad(anWord);
+    }
+
+    auto a = anState[0];
+    auto b = anState[1];
+    auto c = anState[2];
+    auto d = anState[3];
+
+    // Round 1
+    MD5_STEP(md5F, a, b, c, d, w[0], 0xd76aa478, 7);
+    MD5_STEP(md5F, d, a, b, c, w[1], 0xe8c7b756, 12);
+    MD5_STEP(md5F, c, d, a, b, w[2], 0x242070db, 17);
+    MD5_STEP(md5F, b, c, d, a, w[3], 0xc1bdceee, 22);
+    MD5_STEP(md5F, a, b, c, d, w[4], 0xf57c0faf, 7);
+    MD5_STEP(md5F, d, a, b, c, w[5], 0x4787c62a, 12);
+    MD5_STEP(md5F, c, d, a, b, w[6], 0xa8304613, 17);
+    MD5_STEP(md5F, b, c, d, a, w[7], 0xfd469501, 22);
+    MD5_STEP(md5F, a, b, c, d, w[8], 0x698098d8, 7);
+    MD5_STEP(md5F, d, a, b, c, w[9], 0x8b44f7af, 12);
+    MD5_STEP(md5F, c, d, a, b, w[10], 0xffff5bb1, 17);
+    MD5_STEP(md5F, b, c, d, a, w[11], 0x895cd7be, 22);
+    MD5_STEP(md5F, a, b, c, d, w[12], 0x6b901122, 7);
+    MD5_STEP(md5F, d, a, b, c, w[13], 0xfd987193, 12);
+    MD5_STEP(md5F, c, d, a, b, w[14], 0xa679438e, 17);
+    MD5_STEP(md5F, b, c, d, a, w[15], 0x49b40821, 22);
+
+    // Round 2
+    MD5_STEP(md5G, a, b, c, d, w[1], 0xf61e2562, 5);
+    MD5_STEP(md5G, d, a, b, c, w[6], 0xc040b340, 9);
+    MD5_STEP(md5G, c, d, a, b, w[11], 0x265e5a51, 14);
+    MD5_STEP(md5G, b, c, d, a, w[0], 0xe9b6c7aa, 20);
+    MD5_STEP(md5G, a, b, c, d, w[5], 0xd62f105d, 5);
+    MD5_STEP(md5G, d, a, b, c, w[10], 0x02441453, 9);
+    MD5_STEP(md5G, c, d, a, b, w[15], 0xd8a1e681, 14);
+    MD5_STEP(md5G, b, c, d, a, w[4], 0xe7d3fbc8, 20);
+    MD5_STEP(md5G, a, b, c, d, w[9], 0x21e1cde6, 5);
+    MD5_STEP(md5G, d, a, b, c, w[14], 0xc33707d6, 9);
+    MD5_STEP(md5G, c, d, a, b, w[3], 0xf4d50d87, 14);
+    MD5_STEP(md5G, b, c, d, a, w[8], 0x455a14ed, 20);
+    MD5_STEP(md5G, a, b, c, d, w[13], 0xa9e3e905, 5);
+    MD5_STEP(md5G, d, a, b, c, w[2], 0xfcefa3f8, 9);
+    MD5_STEP(md5G, c, d, a, b, w[7], 0x676f02d9, 14);
+    MD5_STEP(md5G, b, c, d, a, w[12], 0x8d2a4c8a, 20);
+
+    // Round 3
+    MD5_STEP(md5H, a, b, c, d, w[5], 0xfffa3942, 4);
+    MD5_STEP(md5H, d, a, b, c, w[8], 0x8771f681, 11);
+    MD5_STEP(md5H, c, d, a, b, w[11], 0x6d9d6122, 16);
+    MD5_STEP(md5H, b, c, d, a, w[14], 0xfde5380c, 23);
+    MD5_STEP(md5H, a, b, c, d, w[1], 0xa4beea44, 4);
+    MD5_STEP(md5H, d, a, b, c, w[4], 0x4bdecfa9, 11);
+    MD5_STEP(md5H, c, d, a, b, w[7], 0xf6bb4b60, 16);
+    MD5_STEP(md5H, b, c, d, a, w[10], 0xbebfbc70, 23);
+    MD5_STEP(md5H, a, b, c, d, w[13], 0x289b7ec6, 4);
+    MD5_STEP(md5H, d, a, b, c, w[0], 0xeaa127fa, 11);
+    MD5_STEP(md5H, c, d, a, b, w[3], 0xd4ef3085, 16);
+    MD5_STEP(md5H, b, c, d, a, w[6], 0x04881d05, 23);
+    MD5_STEP(md5H, a, b, c, d, w[9], 0xd9d4d039, 4);
+    MD5_STEP(md5H, d, a, b, c, w[12], 0xe6db99e5, 11);
+    MD5_STEP(md5H, c, d, a, b, w[15], 0x1fa27cf8, 16);
+    MD5_STEP(md5H, b, c, d, a, w[2], 0xc4ac5665, 23);
+
+    // Round 4
+    MD5_STEP(md5I, a, b, c, d, w[0], 0xf4292244, 6);
+    MD5_STEP(md5I, d, a, b, c, w[7], 0x432aff97, 10);
+    MD5_STEP(md5I, c, d, a, b, w[14], 0xab9423a7, 15);
+    MD5_STEP(md5I, b, c, d, a, w[5], 0xfc93a039, 21);
+    MD5_STEP(md5I, a, b, c, d, w[12], 0x655b59c3, 6);
+    MD5_STEP(md5I, d, a, b, c, w[3], 0x8f0ccc92, 10);
+    MD5_STEP(md5I, c, d, a, b, w[10], 0xffeff47d, 15);
+    MD5_STEP(md5I, b, c, d, a, w[1], 0x85845dd1, 21);
+    MD5_STEP(md5I, a, b, c, d, w[8], 0x6fa87e4f, 6);
+    MD5_STEP(md5I, d, a, b, c, w[15], 0xfe2ce6e0, 10);
+    MD5_STEP(md5I, c, d, a, b, w[6], 0xa3014314, 15);
+    MD5_STEP(md5I, b, c, d, a, w[13], 0x4e0811a1, 21);
+    MD5_STEP(md5I, a, b, c, d, w[4], 0xf7537e82, 6);
+    MD5_STEP(md5I, d, a, b, c, w[11], 0xbd3af235, 10);
+    MD5_STEP(md5I, c, d, a, b, w[2], 0x2ad7d2bb, 15);
+    MD5_STEP(md5I, b, c, d, a, w[9], 0xeb86d391, 21);
+
+    anState[0] = lanesAdd(anState[0], a);
+    anState[1] = lanesAdd(anState[1], b);
+    anState[2] = lanesAdd(anState[2], c);
+    anState[3] = lanesAdd(anState[3], d);
+}
+
+#undef MD5_STEP
+
+// A lane hashes its message's whole blocks straight from the caller's
+// buffer, then the padded tail from its own copy
+struct Md5Lane {
+    bool bActive;
+    size_t nMsg;                // Index of the message being hashed
+    const uint8_t *pBlock;      // Next block to compress
+    uint64_t nBlocks;           // Blocks left before pBlock's run ends
+    bool bTail;                 // pBlock is in anTail
+    uint32_t nTailBlocks;
+    uint8_t anTail[128];        // Last partial block, padding and length
+};
+
+}
+
+// Hash a list of messages
+//
+// INPUT:
+// - apData                     Start of each message
+// - anLen                      Length of each message
+// - nCount                     Number of messages
+//
+// OUTPUT:
+// - aanMd5                     MD5 of each message
+//
+void Md5Multi::hash(const uint8_t *const apData[], const uint64_t anLen[], size_t nCount, uint8_t aanMd5[][16]) {
+    static const uint8_t anIdleBlock[64] = {};
+    static const uint32_t anInit[4] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+
+    Md5Lane aLanes[MD5_MULTI_LANES] = {};
+    uint32_t aanState[4][MD5_MULTI_LANES] = {};    // Idle lanes still run through the rounds
+    size_t nNextMsg = 0;
+
+    for (;;) {
+        // Give every free lane the next message
+        for (size_t nLane = 0; nLane < MD5_MULTI_LANES; nLane++) {
+            auto &lane = aLanes[nLane];
+            if (lane.bActive || nNextMsg == nCount) continue;
+
+            const auto nLen = anLen[nNextMsg];
+            const auto nRem = static_cast<uint32_t>(nLen % 64);
+
+            lane.bActive = true;
+            lane.nMsg = nNextMsg;
+            lane.pBlock = apData[nNextMsg];
+            lane.nBlocks = nLen / 64;
+            lane.bTail = false;
+            lane.nTailBlocks = nRem + 9 <= 64 ? 1 : 2;
+
+            memset(lane.anTail, 0, sizeof(lane.anTail));
+            if (nRem > 0) {
+                memcpy(lane.anTail, apData[nNextMsg] + nLen - nRem, nRem);
+            }
+            lane.anTail[nRem] = 0x80;
+
+            const auto nBits = nLen * 8;
+            for (uint32_t nByte = 0; nByte < 8; nByte++) {
+                lane.anTail[lane.nTailBlocks * 64 - 8 + nByte] = static_cast<uint8_t>(nBits >> (nByte * 8));
+            }
+
+            if (lane.nBlocks == 0) {
+                lane.pBlock = lane.anTail;
+                lane.nBlocks = lane.nTailBlocks;
+                lane.bTail = true;
+            }
+
+            for (size_t nWord = 0; nWord < 4; nWord++) {
+                aanState[nWord][nLane] = anInit[nWord];
+            }
+
+            nNextMsg++;
+        }
+
+        // Run every lane until the first one reaches the end of its run
+        uint64_t nRun = UINT64_MAX;
+        for (const auto &lane : aLanes) {
+            if (lane.bActive && lane.nBlocks < nRun) {
+                nRun = lane.nBlocks;
+            }
+        }
+
+        if (nRun == UINT64_MAX) break;
+
+        Lanes anState[4];
+        for (size_t nWord = 0; nWord < 4; nWord++) {
+            anState[nWord] = lanesLoad(aanState[nWord]);
+        }
+
+        const uint8_t *apBlock[MD5_MULTI_LANES];
+        for (size_t nLane = 0; nLane < MD5_MULTI_LANES; nLane++) {
+            apBlock[nLane] = aLanes[nLane].bActive ? aLanes[nLane].pBlock : anIdleBlock;
+        }
+
+        for (uint64_t nBlock = 0; nBlock < nRun; nBlock++) {
+            md5Compress(anState, apBlock);
+
+            for (size_t nLane = 0; nLane < MD5_MULTI_LANES; nLane++) {
+                if (aLanes[nLane].bActive) {
+                    apBlock[nLane] += 64;
+                }
+            }
+        }
+
+        for (size_t nWord = 0; nWord < 4; nWord++) {
+            lanesStore(aanState[nWord], anState[nWord]);
+        }
+
+        // Move each lane on to its tail, or hand back its digest
+        for (size_t nLane = 0; nLane < MD5_MULTI_LANES; nLane++) {
+            auto &lane = aLanes[nLane];
+            if (!lane.bActive) continue;
+
+            lane.pBlock = apBlock[nLane];
+            lane.nBlocks -= nRun;
+            if (lane.nBlocks > 0) continue;
+
+            if (!lane.bTail) {
+                lane.pBlock = lane.anTail;
+                lane.nBlocks = lane.nTailBlocks;
+                lane.bTail = true;
+                continue;
+            }
+
+            for (size_t nWord = 0; nWord < 4; nWord++) {
+                for (uint32_t nByte = 0; nByte < 4; nByte++) {
+                    aanMd5[lane.nMsg][nWord * 4 + nByte] = static_cast<uint8_t>(aanState[nWord][nLane] >> (nByte * 8));
+                }
+            }
+
+            lane.bActive = false;
+        }
+    }
+}
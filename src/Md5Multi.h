@@ -0,0 +1,49 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Computes the MD5 of many messages at once, one message per lane of
+//   a SIMD register (multi-buffer hashing)
+// - MD5 is a serial chain within a message, so a single message can't
+//   use the vector unit. Independent messages can: MD5_MULTI_LANES
+//   messages are compressed together, each lane taking the next queued
+//   message as soon as its own one is done.
+// - Uses SSE2 where the compiler targets it, otherwise the same lanes
+//   are computed by plain loops
+// - Digests match MD5Final() (see Md5.h)
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_MD5MULTI_H
+#define JPEGSNOOP_MD5MULTI_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Messages compressed side by side (32-bit lanes of a 128-bit register)
+static constexpr size_t MD5_MULTI_LANES = 4;
+
+class Md5Multi {
+public:
+    static void hash(const uint8_t *const apData[], const uint64_t anLen[], size_t nCount, uint8_t aanMd5[][16]);
+};
+
+#endif
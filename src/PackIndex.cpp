@@ -0,0 +1,181 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PackIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+PackIndex::~PackIndex() {
+    close();
+}
+
+// Map an index written by PackWriter
+// - The index is rejected if any of its tables lie outside the file
+//
+// RETURN:
+// - Success in mapping a complete index
+//
+bool PackIndex::open(const QString &indexPath) {
+    close();
+
+    _file.setFileName(indexPath);
+    if (!_file.open(QIODevice::ReadOnly)) return false;
+
+    const auto nSize = static_cast<uint64_t>(_file.size());
+    if (nSize < sizeof(PackIndexHeader)) {
+        close();
+        return false;
+    }
+
+    _map = _file.map(0, _file.size());
+    if (!_map) {
+        close();
+        return false;
+    }
+
+    const auto header = reinterpret_cast<const PackIndexHeader *>(_map);
+
+    // Each table must fit between its offset and the next one
+    const auto bValid = memcmp(header->anMagic, PACK_INDEX_MAGIC, sizeof(PACK_INDEX_MAGIC)) == 0
+                        && header->nVersion == PACK_INDEX_VERSION
+                        && header->nByteOrder == PACK_INDEX_BYTE_ORDER
+                        && header->nEntryOffset >= sizeof(PackIndexHeader)
+                        && header->nEntryCount <= (nSize - header->nEntryOffset) / sizeof(PackIndexEntry)
+                        && header->nSourceOffset >= header->nEntryOffset + header->nEntryCount * sizeof(PackIndexEntry)
+                        && header->nSourceCount < (nSize - header->nSourceOffset) / sizeof(uint64_t)
+                        && header->nStringOffset >= header->nSourceOffset + (header->nSourceCount + 1) * sizeof(uint64_t)
+                        && header->nStringOffset <= nSize;
+
+    if (!bValid) {
+        close();
+        return false;
+    }
+
+    _header = header;
+    _entries = reinterpret_cast<const PackIndexEntry *>(_map + header->nEntryOffset);
+    _sourceOffsets = reinterpret_cast<const uint64_t *>(_map + header->nSourceOffset);
+    _strings = reinterpret_cast<const char *>(_map + header->nStringOffset);
+
+    // Source paths must follow each other inside the string table
+    const auto nStringSize = nSize - header->nStringOffset;
+    for (uint64_t nSrc = 0; nSrc < header->nSourceCount; nSrc++) {
+        if (_sourceOffsets[nSrc] > _sourceOffsets[nSrc + 1] || _sourceOffsets[nSrc + 1] > nStringSize) {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PackIndex::close() {
+    if (_map) {
+        _file.unmap(const_cast<uchar *>(_map));
+    }
+
+    _file.close();
+
+    _map = nullptr;
+    _header = nullptr;
+    _entries = nullptr;
+    _sourceOffsets = nullptr;
+    _strings = nullptr;
+}
+
+uint64_t PackIndex::count() const {
+    return _header ? _header->nEntryCount : 0;
+}
+
+// PRE:
+// - nInd < count()
+//
+const PackIndexEntry &PackIndex::entry(uint64_t nInd) const {
+    return _entries[nInd];
+}
+
+// Look up the image carved from a source file position
+//
+// OUTPUT:
+// - nInd                       Entry number, if found
+//
+// RETURN:
+// - Whether the index holds such an image
+//
+bool PackIndex::find(const QString &srcPath, uint64_t nSrcOffset, uint64_t &nInd) const {
+    if (!_header) return false;
+
+    // Source paths are sorted, so their ids are in path order too
+    const auto path = srcPath.toUtf8();
+    uint32_t nLo = 0;
+    auto nHi = static_cast<uint32_t>(_header->nSourceCount);
+
+    while (nLo < nHi) {
+        const auto nMid = nLo + (nHi - nLo) / 2;
+        const auto pStr = _strings + _sourceOffsets[nMid];
+        const auto nLen = static_cast<size_t>(_sourceOffsets[nMid + 1] - _sourceOffsets[nMid]);
+        const auto nCmp = memcmp(pStr, path.constData(), std::min<size_t>(nLen, path.size()));
+
+        if (nCmp < 0 || (nCmp == 0 && nLen < static_cast<size_t>(path.size()))) {
+            nLo = nMid + 1;
+        } else {
+            nHi = nMid;
+        }
+    }
+
+    if (nLo >= _header->nSourceCount || source(nLo) != srcPath) return false;
+
+    const auto pEnd = _entries + _header->nEntryCount;
+    const auto it = std::lower_bound(_entries, pEnd, std::make_pair(nLo, nSrcOffset),
+                                     [](const PackIndexEntry &entry, const std::pair<uint32_t, uint64_t> &key) {
+                                         return entry.nSrcId < key.first
+                                                || (entry.nSrcId == key.first && entry.nSrcOffset < key.second);
+                                     });
+
+    if (it == pEnd || it->nSrcId != nLo || it->nSrcOffset != nSrcOffset) return false;
+
+    nInd = static_cast<uint64_t>(it - _entries);
+    return true;
+}
+
+uint64_t PackIndex::sourceCount() const {
+    return _header ? _header->nSourceCount : 0;
+}
+
+QString PackIndex::source(uint32_t nSrcId) const {
+    if (!_header || nSrcId >= _header->nSourceCount) return {};
+
+    const auto nStart = _sourceOffsets[nSrcId];
+    return QString::fromUtf8(_strings + nStart, static_cast<int>(_sourceOffsets[nSrcId + 1] - nStart));
+}
+
+QString PackIndex::packPath(uint32_t nPackId) const {
+    return packPath(_file.fileName(), nPackId);
+}
+
+// Name of a pack file, derived from the name of its index
+// - "dir/name.idx" has the packs "dir/name_0000.pack", "dir/name_0001.pack", ...
+//
+QString PackIndex::packPath(const QString &indexPath, uint32_t nPackId) {
+    auto base = indexPath;
+    if (base.endsWith(".idx")) {
+        base.chop(4);
+    }
+
+    return QString("%1_%2.pack").arg(base).arg(nPackId, 4, 10, QChar('0'));
+}
@@ -0,0 +1,102 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Reads the index of a set of pack files written by PackWriter
+// - The index is memory-mapped and its fixed-size entries are read in
+//   place, so any image can be looked up without loading the index
+// - Index layout (host byte order, checked through nByteOrder):
+//   - PackIndexHeader
+//   - PackIndexEntry[nEntryCount], sorted by source path then offset
+//   - uint64_t[nSourceCount + 1] offsets of the source paths into the
+//     string table (the last one is its size)
+//   - String table of the UTF-8 source paths, sorted
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_PACKINDEX_H
+#define JPEGSNOOP_PACKINDEX_H
+
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+
+static const char PACK_INDEX_MAGIC[8] = {'J', 'S', 'N', 'P', 'P', 'I', 'D', 'X'};
+static constexpr uint32_t PACK_INDEX_VERSION = 1;
+static constexpr uint32_t PACK_INDEX_BYTE_ORDER = 0x01020304;
+
+struct PackIndexHeader {
+    char anMagic[8];            // PACK_INDEX_MAGIC
+    uint32_t nVersion;          // PACK_INDEX_VERSION
+    uint32_t nByteOrder;        // PACK_INDEX_BYTE_ORDER as written
+    uint64_t nEntryCount;
+    uint64_t nEntryOffset;      // File offset of the entries
+    uint64_t nSourceCount;
+    uint64_t nSourceOffset;     // File offset of the source path offsets
+    uint64_t nStringOffset;     // File offset of the string table
+    uint32_t nPackCount;        // Pack files written (see PackIndex::packPath())
+    uint32_t nReserved;
+};
+
+struct PackIndexEntry {
+    uint64_t nOffset;           // Position of the image in its pack file
+    uint64_t nLength;           // Bytes in the image
+    uint64_t nSrcOffset;        // Position of the image in its source file
+    uint32_t nSrcId;            // Index of the source path
+    uint32_t nPackId;           // Pack file number
+    uint8_t anMd5[16];          // MD5 of the image bytes
+};
+
+static_assert(sizeof(PackIndexHeader) == 64, "Pack index header layout");
+static_assert(sizeof(PackIndexEntry) == 48, "Pack index entry layout");
+
+class PackIndex {
+    Q_DISABLE_COPY(PackIndex)
+public:
+    PackIndex() = default;
+    ~PackIndex();
+
+    bool open(const QString &indexPath);
+    void close();
+
+    bool isOpen() const { return _header != nullptr; }
+
+    uint64_t count() const;
+    const PackIndexEntry &entry(uint64_t nInd) const;
+    bool find(const QString &srcPath, uint64_t nSrcOffset, uint64_t &nInd) const;
+
+    uint64_t sourceCount() const;
+    QString source(uint32_t nSrcId) const;
+    QString packPath(uint32_t nPackId) const;
+
+    static QString packPath(const QString &indexPath, uint32_t nPackId);
+
+private:
+    QFile _file;
+    const uchar *_map = nullptr;
+    const PackIndexHeader *_header = nullptr;
+    const PackIndexEntry *_entries = nullptr;
+    const uint64_t *_sourceOffsets = nullptr;
+    const char *_strings = nullptr;
+};
+
+#endif
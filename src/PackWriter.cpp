@@ -0,0 +1,261 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PackWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "Md5.h"
+
+PackWriter::PackWriter(const QString &indexPath, uint64_t maxPackSize) :
+    _indexPath(indexPath),
+    _maxPackSize(maxPackSize) {
+
+    _staged.reserve(PACK_FLUSH_SIZE * 2);
+    openPack(0);
+}
+
+PackWriter::~PackWriter() {
+    close();
+}
+
+bool PackWriter::isOpen() const {
+    return !_failed;
+}
+
+// Add an image to the packs
+// - The image is hashed before taking the lock
+// - The worker that fills the staging buffer writes it out, while the
+//   other workers carry on staging images
+//
+// INPUT:
+// - srcPath                File the image was carved from
+// - srcOffset              Position of the image in that file
+// - data                   Image bytes
+//
+// OUTPUT:
+// - location               If not null, "<pack path>@<offset>"
+// - anMd5                  If not null, the MD5 of the image (as indexed)
+//
+// RETURN:
+// - false once the packs are closed or a write has failed
+//
+bool PackWriter::append(const QString &srcPath, uint64_t srcOffset, const QByteArray &data, QString *location,
+                        uint8_t *anMd5) {
+    const auto nLength = static_cast<uint64_t>(data.size());
+
+    Entry entry = {};
+    entry.srcPath = srcPath;
+    entry.entry.nLength = nLength;
+    entry.entry.nSrcOffset = srcOffset;
+    hashData(data, entry.entry.anMd5);
+
+    if (anMd5) {
+        memcpy(anMd5, entry.entry.anMd5, sizeof(entry.entry.anMd5));
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_closed || _failed) return false;
+
+    // Whatever is staged for the current pack has to be written before
+    // the next pack is started
+    QByteArray block;
+    auto bNewPack = false;
+
+    if (_packFill > 0 && _packFill + nLength > _maxPackSize) {
+        block.swap(_staged);
+        _packId++;
+        _packFill = 0;
+        bNewPack = true;
+    }
+
+    entry.entry.nPackId = _packId;
+    entry.entry.nOffset = _packFill;
+    _packFill += nLength;
+
+    _staged += data;
+    _entries.push_back(entry);
+
+    if (location) {
+        *location = QString("%1@%2").arg(PackIndex::packPath(_indexPath, _packId)).arg(entry.entry.nOffset);
+    }
+
+    if (!bNewPack) {
+        if (_staged.size() < PACK_FLUSH_SIZE) return true;
+
+        block.swap(_staged);
+    }
+
+    const auto nPackId = _packId;
+
+    std::unique_lock<std::mutex> writeLock(_writeMutex);
+    lock.unlock();
+
+    writeBlock(block);
+
+    if (bNewPack) {
+        openPack(nPackId);
+    }
+
+    return !_failed;
+}
+
+// Leave an image appended earlier out of the index, eg. a copy that
+// turned out to be a duplicate
+// - Its bytes stay in the pack, unreferenced
+//
+void PackWriter::remove(const QString &srcPath, uint64_t srcOffset) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _entries.erase(std::remove_if(_entries.begin(), _entries.end(), [&](const Entry &entry) {
+        return entry.entry.nSrcOffset == srcOffset && entry.srcPath == srcPath;
+    }), _entries.end());
+}
+
+// Write out what is still staged, close the pack file and write the index
+// - Every append() must have returned
+//
+// RETURN:
+// - Success in writing every image and the index
+//
+bool PackWriter::close() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_closed) return !_failed;
+
+    _closed = true;
+
+    std::unique_lock<std::mutex> writeLock(_writeMutex);
+    writeBlock(_staged);
+    _staged.clear();
+    _pack.close();
+
+    if (!_failed && !writeIndex()) {
+        _failed = true;
+    }
+
+    return !_failed;
+}
+
+// PRE:
+// - _writeMutex is held
+//
+bool PackWriter::openPack(uint32_t nPackId) {
+    _pack.close();
+    _pack.setFileName(PackIndex::packPath(_indexPath, nPackId));
+
+    if (!_pack.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        _failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+// PRE:
+// - _writeMutex is held
+//
+void PackWriter::writeBlock(const QByteArray &block) {
+    if (block.isEmpty() || _failed) return;
+
+    if (_pack.write(block) != block.size()) {
+        _failed = true;
+    }
+}
+
+// Write the index of every image appended
+// - Source paths are sorted (as UTF-8) and numbered in that order, and
+//   the entries sorted by source and offset, so the index is the same
+//   whatever order the workers appended in
+//
+// PRE:
+// - _mutex is held
+//
+bool PackWriter::writeIndex() {
+    std::map<QByteArray, uint32_t> sourceIds;
+    for (const auto &entry : _entries) {
+        sourceIds.emplace(entry.srcPath.toUtf8(), 0);
+    }
+
+    std::vector<uint64_t> sourceOffsets;
+    QByteArray strings;
+    uint32_t nSrcId = 0;
+
+    for (auto &source : sourceIds) {
+        source.second = nSrcId++;
+        sourceOffsets.push_back(static_cast<uint64_t>(strings.size()));
+        strings += source.first;
+    }
+
+    sourceOffsets.push_back(static_cast<uint64_t>(strings.size()));
+
+    std::vector<PackIndexEntry> entries;
+    entries.reserve(_entries.size());
+
+    for (auto &entry : _entries) {
+        entry.entry.nSrcId = sourceIds[entry.srcPath.toUtf8()];
+        entries.push_back(entry.entry);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const PackIndexEntry &a, const PackIndexEntry &b) {
+        return a.nSrcId < b.nSrcId || (a.nSrcId == b.nSrcId && a.nSrcOffset < b.nSrcOffset);
+    });
+
+    PackIndexHeader header = {};
+    memcpy(header.anMagic, PACK_INDEX_MAGIC, sizeof(PACK_INDEX_MAGIC));
+    header.nVersion = PACK_INDEX_VERSION;
+    header.nByteOrder = PACK_INDEX_BYTE_ORDER;
+    header.nEntryCount = entries.size();
+    header.nEntryOffset = sizeof(PackIndexHeader);
+    header.nSourceCount = sourceIds.size();
+    header.nSourceOffset = header.nEntryOffset + entries.size() * sizeof(PackIndexEntry);
+    header.nStringOffset = header.nSourceOffset + sourceOffsets.size() * sizeof(uint64_t);
+    header.nPackCount = _packId + 1;
+
+    QFile file(_indexPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    const auto writeAll = [&file](const void *pData, uint64_t nLen) {
+        return file.write(reinterpret_cast<const char *>(pData), static_cast<qint64>(nLen)) == static_cast<qint64>(nLen);
+    };
+
+    return writeAll(&header, sizeof(header))
+           && writeAll(entries.data(), entries.size() * sizeof(PackIndexEntry))
+           && writeAll(sourceOffsets.data(), sourceOffsets.size() * sizeof(uint64_t))
+           && writeAll(strings.constData(), static_cast<uint64_t>(strings.size()));
+}
+
+void PackWriter::hashData(const QByteArray &data, uint8_t anMd5[16]) {
+    MD5_CTX sMd5;
+    MD5Init(&sMd5);
+
+    // MD5Update() takes at most 2 GiB at a time
+    auto pData = reinterpret_cast<unsigned char *>(const_cast<char *>(data.constData()));
+    auto nLeft = static_cast<uint64_t>(data.size());
+
+    while (nLeft > 0) {
+        const auto nLen = static_cast<int32_t>(qMin<uint64_t>(nLeft, 1 << 30));
+        MD5Update(&sMd5, pData, nLen);
+        pData += nLen;
+        nLeft -= nLen;
+    }
+
+    MD5Final(&sMd5);
+    memcpy(anMd5, sMd5.digest, 16);
+}
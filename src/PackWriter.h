@@ -0,0 +1,99 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Stores carved images in a few large pack files instead of one file
+//   per image, which avoids creating an inode per image
+// - Images are appended to a staging buffer and written out in blocks
+//   of PACK_FLUSH_SIZE, so the pack files are written sequentially
+// - append() may be called from several workers. Each image gets its
+//   place in the pack when it is staged, and blocks are written in the
+//   same order, so no image is ever split or reordered.
+// - A new pack file is started once one would grow past the size limit
+// - close() writes the index (see PackIndex) for all the packs
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_PACKWRITER_H
+#define JPEGSNOOP_PACKWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "PackIndex.h"
+
+// Bytes staged before they are written to the pack file
+static constexpr int PACK_FLUSH_SIZE = 8 * 1024 * 1024;
+
+// Size a pack file is kept under (unless a single image is larger)
+static constexpr uint64_t PACK_FILE_MAX = 4ULL * 1024 * 1024 * 1024;
+
+class PackWriter {
+    Q_DISABLE_COPY(PackWriter)
+public:
+    // Packs are written to "<indexPath without .idx>_NNNN.pack"
+    explicit PackWriter(const QString &indexPath, uint64_t maxPackSize = PACK_FILE_MAX);
+    ~PackWriter();
+
+    bool isOpen() const;
+
+    bool append(const QString &srcPath, uint64_t srcOffset, const QByteArray &data, QString *location = nullptr,
+                uint8_t *anMd5 = nullptr);
+    void remove(const QString &srcPath, uint64_t srcOffset);
+    bool close();
+
+private:
+    struct Entry {
+        PackIndexEntry entry;
+        QString srcPath;        // The id is only assigned by writeIndex()
+    };
+
+    bool openPack(uint32_t nPackId);
+    void writeBlock(const QByteArray &block);
+    bool writeIndex();
+
+    static void hashData(const QByteArray &data, uint8_t anMd5[16]);
+
+    const QString _indexPath;
+    const uint64_t _maxPackSize;
+
+    // Guarded by _mutex
+    std::mutex _mutex;
+    QByteArray _staged;
+    std::vector<Entry> _entries;
+    uint32_t _packId = 0;       // Pack that staged images go to
+    uint64_t _packFill = 0;     // Bytes assigned in that pack
+    bool _closed = false;
+
+    // Guarded by _writeMutex, which is always taken while still holding
+    // _mutex so that blocks are written in the order they were staged
+    std::mutex _writeMutex;
+    QFile _pack;
+
+    std::atomic<bool> _failed{false};
+};
+
+#endif
@@ -0,0 +1,258 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PerceptualHash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static constexpr double PHASH_PI = 3.14159265358979323846;
+
+// Resample one axis by area averaging: each output sample is the mean
+// of the source span it covers (partly covered samples are weighted),
+// which both shrinks and enlarges
+//
+// INPUT:
+// - pSrc, nSrcStep             First source sample, and step between samples
+// - nSrcLen                    Number of source samples
+// - nDstStep                   Step between output samples
+//
+// OUTPUT:
+// - pDst                       PHASH_SIZE output samples
+//
+static void ResampleAxis(const double *pSrc, uint32_t nSrcStep, uint32_t nSrcLen, double *pDst, uint32_t nDstStep) {
+    const auto dScale = static_cast<double>(nSrcLen) / PHASH_SIZE;
+
+    for (uint32_t nOut = 0; nOut < PHASH_SIZE; nOut++) {
+        const auto dStart = nOut * dScale;
+        const auto dEnd = (nOut + 1) * dScale;
+
+        auto dSum = 0.0;
+        for (auto nIn = static_cast<uint32_t>(dStart); nIn < nSrcLen && nIn < dEnd; nIn++) {
+            const auto dWeight = std::min<double>(dEnd, nIn + 1) - std::max<double>(dStart, nIn);
+            dSum += pSrc[nIn * nSrcStep] * dWeight;
+        }
+
+        pDst[nOut * nDstStep] = dSum / (dEnd - dStart);
+    }
+}
+
+// Compute the perceptual hash of a DC map
+//
+// INPUT:
+// - pDc                        DC value of each 8x8 luminance block
+// - nStride                    Blocks from one row of the map to the next
+// - nWidth, nHeight            Blocks of the image itself (without the
+//                              MCU padding)
+//
+// OUTPUT:
+// - nHash                      The hash
+//
+// RETURN:
+// - false if the map is too small to hash
+//
+bool PerceptualHashFromDc(const int16_t *pDc, uint32_t nStride, uint32_t nWidth, uint32_t nHeight, uint64_t &nHash) {
+    if (!pDc || nWidth < 2 || nHeight < 2 || nStride < nWidth) return false;
+
+    std::vector<double> src(static_cast<size_t>(nWidth) * nHeight);
+    for (uint32_t nY = 0; nY < nHeight; nY++) {
+        for (uint32_t nX = 0; nX < nWidth; nX++) {
+            src[static_cast<size_t>(nY) * nWidth + nX] = pDc[static_cast<size_t>(nY) * nStride + nX];
+        }
+    }
+
+    // Rows first, then columns
+    std::vector<double> rows(static_cast<size_t>(nHeight) * PHASH_SIZE);
+    for (uint32_t nY = 0; nY < nHeight; nY++) {
+        ResampleAxis(&src[static_cast<size_t>(nY) * nWidth], 1, nWidth, &rows[static_cast<size_t>(nY) * PHASH_SIZE], 1);
+    }
+
+    double adMap[PHASH_SIZE * PHASH_SIZE];
+    for (uint32_t nX = 0; nX < PHASH_SIZE; nX++) {
+        ResampleAxis(&rows[nX], PHASH_SIZE, nHeight, &adMap[nX], PHASH_SIZE);
+    }
+
+    // Orthonormal DCT-II basis, for the frequencies that are kept
+    static constexpr uint32_t NUM_FREQ = PHASH_LOW + 1;
+    double adBasis[NUM_FREQ][PHASH_SIZE];
+
+    for (uint32_t nFreq = 0; nFreq < NUM_FREQ; nFreq++) {
+        const auto dNorm = std::sqrt((nFreq == 0 ? 1.0 : 2.0) / PHASH_SIZE);
+
+        for (uint32_t nInd = 0; nInd < PHASH_SIZE; nInd++) {
+            adBasis[nFreq][nInd] = dNorm * std::cos(PHASH_PI * (2 * nInd + 1) * nFreq / (2.0 * PHASH_SIZE));
+        }
+    }
+
+    // Transform the rows, then the columns of the low frequencies
+    double adRowDct[PHASH_SIZE][NUM_FREQ];
+    for (uint32_t nY = 0; nY < PHASH_SIZE; nY++) {
+        for (uint32_t nU = 0; nU < NUM_FREQ; nU++) {
+            auto dSum = 0.0;
+            for (uint32_t nX = 0; nX < PHASH_SIZE; nX++) {
+                dSum += adMap[nY * PHASH_SIZE + nX] * adBasis[nU][nX];
+            }
+            adRowDct[nY][nU] = dSum;
+        }
+    }
+
+    // The zero frequencies only hold the mean and are left out
+    double adCoeff[PHASH_LOW * PHASH_LOW];
+    for (uint32_t nV = 1; nV < NUM_FREQ; nV++) {
+        for (uint32_t nU = 1; nU < NUM_FREQ; nU++) {
+            auto dSum = 0.0;
+            for (uint32_t nY = 0; nY < PHASH_SIZE; nY++) {
+                dSum += adRowDct[nY][nU] * adBasis[nV][nY];
+            }
+            adCoeff[(nV - 1) * PHASH_LOW + (nU - 1)] = dSum;
+        }
+    }
+
+    double adSorted[PHASH_LOW * PHASH_LOW];
+    std::copy(std::begin(adCoeff), std::end(adCoeff), std::begin(adSorted));
+    std::nth_element(std::begin(adSorted), std::begin(adSorted) + PHASH_LOW * PHASH_LOW / 2, std::end(adSorted));
+    const auto dMedian = adSorted[PHASH_LOW * PHASH_LOW / 2];
+
+    nHash = 0;
+    for (uint32_t nBit = 0; nBit < PHASH_LOW * PHASH_LOW; nBit++) {
+        if (adCoeff[nBit] > dMedian) {
+            nHash |= 1ULL << nBit;
+        }
+    }
+
+    return true;
+}
+
+// Number of bits that differ between two hashes
+//
+uint32_t PerceptualHashDistance(uint64_t nHashA, uint64_t nHashB) {
+    auto nBits = nHashA ^ nHashB;
+
+#if defined(_MSC_VER)
+    nBits = nBits - ((nBits >> 1) & 0x5555555555555555ULL);
+    nBits = (nBits & 0x3333333333333333ULL) + ((nBits >> 2) & 0x3333333333333333ULL);
+    nBits = (nBits + (nBits >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<uint32_t>((nBits * 0x0101010101010101ULL) >> 56);
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(nBits));
+#endif
+}
+
+// Group hashes that are within a distance of each other (transitively)
+// - Two hashes within nMaxDist differ by at most nMaxDist / 4 bits in
+//   at least one of their four 16-bit chunks. So each hash is only
+//   compared with the hashes that are that close in some chunk, found
+//   through a table of each chunk's values.
+//
+// INPUT:
+// - hashes                     Hashes to group
+// - nMaxDist                   Largest distance between neighbours (at
+//                              most PHASH_MAX_CLUSTER_DIST)
+//
+// RETURN:
+// - The group of each hash, named by the index of its first hash
+//
+std::vector<uint32_t> PerceptualHashClusters(const std::vector<uint64_t> &hashes, uint32_t nMaxDist) {
+    nMaxDist = std::min(nMaxDist, PHASH_MAX_CLUSTER_DIST);
+
+    // Copies are grouped up front, so each value is searched once
+    std::vector<uint64_t> values(hashes);
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+
+    const auto nCount = static_cast<uint32_t>(values.size());
+
+    std::vector<uint32_t> parent(nCount);
+    std::iota(parent.begin(), parent.end(), 0);
+
+    const auto findRoot = [&parent](uint32_t nInd) {
+        while (parent[nInd] != nInd) {
+            parent[nInd] = parent[parent[nInd]];
+            nInd = parent[nInd];
+        }
+        return nInd;
+    };
+
+    // Every chunk difference with no more than nRadius bits set
+    const auto nRadius = nMaxDist / 4;
+    std::vector<uint16_t> masks;
+    for (uint32_t nMask = 0; nMask <= 0xFFFF; nMask++) {
+        if (PerceptualHashDistance(nMask, 0) <= nRadius) {
+            masks.push_back(static_cast<uint16_t>(nMask));
+        }
+    }
+
+    std::vector<uint32_t> bucketStart(0x10001);
+    std::vector<uint32_t> bucketIds(nCount);
+
+    for (uint32_t nChunk = 0; nChunk < 4; nChunk++) {
+        const auto chunkOf = [nChunk](uint64_t nHash) {
+            return static_cast<uint16_t>(nHash >> (nChunk * 16));
+        };
+
+        // Bucket the values by this chunk (counting sort)
+        std::fill(bucketStart.begin(), bucketStart.end(), 0);
+        for (const auto nHash : values) {
+            bucketStart[chunkOf(nHash) + 1]++;
+        }
+
+        std::partial_sum(bucketStart.begin(), bucketStart.end(), bucketStart.begin());
+
+        auto bucketFill = bucketStart;
+        for (uint32_t nInd = 0; nInd < nCount; nInd++) {
+            bucketIds[bucketFill[chunkOf(values[nInd])]++] = nInd;
+        }
+
+        for (uint32_t nInd = 0; nInd < nCount; nInd++) {
+            const auto nValue = chunkOf(values[nInd]);
+
+            for (const auto nMask : masks) {
+                const auto nProbe = static_cast<uint16_t>(nValue ^ nMask);
+
+                for (auto nPos = bucketStart[nProbe]; nPos < bucketStart[nProbe + 1]; nPos++) {
+                    const auto nOther = bucketIds[nPos];
+                    if (nOther <= nInd) continue;
+
+                    if (PerceptualHashDistance(values[nInd], values[nOther]) <= nMaxDist) {
+                        const auto nRootA = findRoot(nInd);
+                        const auto nRootB = findRoot(nOther);
+                        parent[std::max(nRootA, nRootB)] = std::min(nRootA, nRootB);
+                    }
+                }
+            }
+        }
+    }
+
+    // Name each group by its first hash in the caller's order
+    std::vector<uint32_t> groupName(nCount, UINT32_MAX);
+    std::vector<uint32_t> clusters(hashes.size());
+
+    for (uint32_t nInd = 0; nInd < hashes.size(); nInd++) {
+        const auto nValue = static_cast<uint32_t>(std::lower_bound(values.begin(), values.end(), hashes[nInd]) - values.begin());
+        auto &nName = groupName[findRoot(nValue)];
+
+        if (nName == UINT32_MAX) {
+            nName = nInd;
+        }
+
+        clusters[nInd] = nName;
+    }
+
+    return clusters;
+}
@@ -0,0 +1,59 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// DESCRIPTION:
+// - Perceptual hash of an image from the DC values of its 8x8 luminance
+//   blocks, which the scan decode recovers without any IDCT. The DC map
+//   is a 1/8 scale image of the luminance.
+// - The map is resampled to PHASH_SIZE x PHASH_SIZE, and a DCT of that
+//   taken. The 8x8 lowest frequencies after the zero frequency row and
+//   column each give a bit: whether they are above their median.
+// - Re-encoded, resized or lightly edited copies of an image get hashes
+//   a few bits apart; PerceptualHashDistance() counts the bits that
+//   differ
+// - PerceptualHashClusters() groups hashes within a distance of each
+//   other, using a multi-index search so that it doesn't compare every
+//   pair
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_PERCEPTUALHASH_H
+#define JPEGSNOOP_PERCEPTUALHASH_H
+
+#include <cstdint>
+#include <vector>
+
+// Side of the resampled DC map that the DCT is taken of
+static constexpr uint32_t PHASH_SIZE = 32;
+
+// Side of the low-frequency corner that gives the hash bits
+static constexpr uint32_t PHASH_LOW = 8;
+
+// Largest distance that PerceptualHashClusters() can search
+static constexpr uint32_t PHASH_MAX_CLUSTER_DIST = 15;
+
+bool PerceptualHashFromDc(const int16_t *pDc, uint32_t nStride, uint32_t nWidth, uint32_t nHeight, uint64_t &nHash);
+
+uint32_t PerceptualHashDistance(uint64_t nHashA, uint64_t nHashB);
+
+std::vector<uint32_t> PerceptualHashClusters(const std::vector<uint64_t> &hashes, uint32_t nMaxDist);
+
+#endif
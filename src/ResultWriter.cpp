@@ -0,0 +1,208 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ResultWriter.h"
+
+#include <cstdio>
+
+ResultWriter::ResultWriter(const QString &filePath) :
+    _out(filePath) {
+}
+
+bool ResultWriter::isOpen() const {
+    return _out.isOpen();
+}
+
+// Add the record of one exported image
+//
+// INPUT:
+// - srcPath                File the image was carved from
+// - outPath                Where it was exported to
+// - info                   Analysis of the image
+//
+void ResultWriter::write(const QString &srcPath, const QString &outPath, const ImageInfo &info) {
+    QByteArray record;
+    record.reserve(512);
+
+    record += '{';
+    addString(record, "source", srcPath);
+    addString(record, "output", outPath);
+    addImage(record, info);
+    record += "}\n";
+
+    _out.append(record);
+}
+
+// Add the record of an image that wasn't exported, as it is a copy of
+// one carved earlier
+//
+// INPUT:
+// - srcPath                File the copy was found in
+// - info                   Analysis of the copy
+// - origPath, origOffset   Where the exported copy was found
+//
+void ResultWriter::writeDuplicate(const QString &srcPath, const ImageInfo &info, const QString &origPath,
+                                  uint64_t origOffset) {
+    QByteArray record;
+    record.reserve(640);
+
+    record += '{';
+    addString(record, "source", srcPath);
+    addString(record, "output", QString());
+    addString(record, "duplicate_of", origPath);
+    addNumber(record, "duplicate_of_offset", origOffset);
+    addImage(record, info);
+    record += "}\n";
+
+    _out.append(record);
+}
+
+// Add the record of an image that wasn't exported, as its hash is in
+// the known-file hash set
+//
+// INPUT:
+// - srcPath                File the image was found in
+// - info                   Analysis of the image
+//
+void ResultWriter::writeKnown(const QString &srcPath, const ImageInfo &info) {
+    QByteArray record;
+    record.reserve(576);
+
+    record += '{';
+    addString(record, "source", srcPath);
+    addString(record, "output", QString());
+    addBool(record, "known", true);
+    addImage(record, info);
+    record += "}\n";
+
+    _out.append(record);
+}
+
+// Add the members that describe the image itself
+//
+void ResultWriter::addImage(QByteArray &record, const ImageInfo &info) {
+    addNumber(record, "offset", info.nPosStart);
+    addNumber(record, "end", info.nPosEnd);
+    addBool(record, "eoi", info.bEoiFound);
+    addNumber(record, "width", info.nWidth);
+    addNumber(record, "height", info.nHeight);
+    addNumber(record, "precision", info.nPrecision);
+    addNumber(record, "components", info.nNumComps);
+    addBool(record, "progressive", info.bProgressive);
+    addString(record, "subsampling", info.strSubsampling);
+    addQuality(record, "quality_lum", info.dQualLum);
+    addQuality(record, "quality_chr", info.dQualChr);
+    addNumber(record, "ps_quality_save_as", info.nQualPhotoshopSa);
+    addNumber(record, "ps_quality_save_for_web", info.nQualPhotoshopSfw);
+    addString(record, "make", info.strExifMake);
+    addString(record, "model", info.strExifModel);
+    addString(record, "maker_quality", info.strExifQual);
+    addString(record, "software", info.strSoftware);
+    addString(record, "hash", info.strHash);
+    addString(record, "hash_rot", info.strHashRot);
+    addNumber(record, "thumb_offset", info.nThumbOffset);
+    addNumber(record, "thumb_length", info.nThumbLength);
+    addNumber(record, "scan_length", info.nScanLength);
+    addHash(record, "identity", info.nIdentityHash, info.nIdentityLength > 0);
+    addHash(record, "phash", info.nPerceptualHash, info.bPerceptualHash);
+}
+
+// Write out the buffered records
+//
+void ResultWriter::flush() {
+    _out.flush();
+}
+
+// Start a member, with the comma that separates it from the one before
+//
+void ResultWriter::addKey(QByteArray &record, const char *key) {
+    if (record.size() > 1) {
+        record += ',';
+    }
+
+    record += '"';
+    record += key;
+    record += "\":";
+}
+
+// Add a string member, or null for an empty string
+//
+void ResultWriter::addString(QByteArray &record, const char *key, const QString &value) {
+    addKey(record, key);
+
+    if (value.isEmpty()) {
+        record += "null";
+        return;
+    }
+
+    const auto utf8 = value.toUtf8();
+
+    record += '"';
+    for (const char ch : utf8) {
+        const auto byte = static_cast<uint8_t>(ch);
+
+        if (ch == '"' || ch == '\\') {
+            record += '\\';
+            record += ch;
+        } else if (byte < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", byte);
+            record += escape;
+        } else {
+            record += ch;
+        }
+    }
+    record += '"';
+}
+
+void ResultWriter::addNumber(QByteArray &record, const char *key, uint64_t value) {
+    addKey(record, key);
+    record += QByteArray::number(static_cast<qulonglong>(value));
+}
+
+// Add a 64-bit hash as 16 hex digits, or null if there is none
+//
+void ResultWriter::addHash(QByteArray &record, const char *key, uint64_t value, bool valid) {
+    addKey(record, key);
+
+    if (!valid) {
+        record += "null";
+        return;
+    }
+
+    char acHex[20];
+    snprintf(acHex, sizeof(acHex), "\"%016llx\"", static_cast<unsigned long long>(value));
+    record += acHex;
+}
+
+// Add a quality factor, or null if it wasn't found (negative)
+//
+void ResultWriter::addQuality(QByteArray &record, const char *key, double value) {
+    addKey(record, key);
+
+    if (value < 0.0) {
+        record += "null";
+    } else {
+        record += QByteArray::number(value, 'f', 2);
+    }
+}
+
+void ResultWriter::addBool(QByteArray &record, const char *key, bool value) {
+    addKey(record, key);
+    record += value ? "true" : "false";
+}
@@ -0,0 +1,70 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Writes one NDJSON record (a JSON object on its own line) per carved
+//   image, for tools that index the results
+// - Records are built from JfifDecode::getImageInfo(), never from the
+//   text log, so they don't depend on the log levels
+// - An image skipped as a duplicate gets a record with a null output
+//   that names where the exported copy was found, and one skipped as a
+//   known file gets a record with a null output marked "known"
+// - Records are written through a LineWriter. write() may be called
+//   from several threads; each record is written whole.
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_RESULTWRITER_H
+#define JPEGSNOOP_RESULTWRITER_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "JfifDecode.h"
+#include "LineWriter.h"
+
+class ResultWriter {
+    Q_DISABLE_COPY(ResultWriter)
+public:
+    // Opened as by LineWriter
+    explicit ResultWriter(const QString &filePath);
+    ~ResultWriter() = default;
+
+    bool isOpen() const;
+
+    void write(const QString &srcPath, const QString &outPath, const ImageInfo &info);
+    void writeDuplicate(const QString &srcPath, const ImageInfo &info, const QString &origPath, uint64_t origOffset);
+    void writeKnown(const QString &srcPath, const ImageInfo &info);
+    void flush();
+
+private:
+    static void addImage(QByteArray &record, const ImageInfo &info);
+    static void addKey(QByteArray &record, const char *key);
+    static void addString(QByteArray &record, const char *key, const QString &value);
+    static void addNumber(QByteArray &record, const char *key, uint64_t value);
+    static void addHash(QByteArray &record, const char *key, uint64_t value, bool valid);
+    static void addQuality(QByteArray &record, const char *key, double value);
+    static void addBool(QByteArray &record, const char *key, bool value);
+
+    LineWriter _out;
+};
+
+#endif
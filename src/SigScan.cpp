@@ -0,0 +1,109 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "SigScan.h"
+
+// Signature byte strings. The pattern id is the teSigType value.
+static const uint8_t SIG_JPEG[] = {0xFF, 0xD8, 0xFF};
+static const uint8_t SIG_RIFF[] = {'R', 'I', 'F', 'F'};
+static const uint8_t SIG_PSD[] = {'8', 'B', 'P', 'S'};
+static const uint8_t SIG_TIFF_LE[] = {'I', 'I', 0x2A, 0x00};
+static const uint8_t SIG_TIFF_BE[] = {'M', 'M', 0x00, 0x2A};
+static const uint8_t SIG_PDF_DCT[] = {'/', 'D', 'C', 'T', 'D', 'e', 'c', 'o', 'd', 'e'};
+static const uint8_t SIG_JPEG_EOI[] = {0xFF, 0xD9};
+
+SigScan::SigScan(WindowBuf &wbuf) :
+    _wbuf(wbuf) {
+    _patterns.add(SIG_JPEG, sizeof(SIG_JPEG), SIG_T_JPEG);
+    _patterns.add(SIG_RIFF, sizeof(SIG_RIFF), SIG_T_AVI);
+    _patterns.add(SIG_PSD, sizeof(SIG_PSD), SIG_T_PSD);
+    _patterns.add(SIG_TIFF_LE, sizeof(SIG_TIFF_LE), SIG_T_TIFF);
+    _patterns.add(SIG_TIFF_BE, sizeof(SIG_TIFF_BE), SIG_T_TIFF);
+    _patterns.add(SIG_PDF_DCT, sizeof(SIG_PDF_DCT), SIG_T_PDF_DCT);
+
+    _patternsEoi = _patterns;
+    _patternsEoi.add(SIG_JPEG_EOI, sizeof(SIG_JPEG_EOI), SIG_T_JPEG_EOI);
+}
+
+// Scan a range of the file for all known container signatures
+//
+// INPUT:
+// - nStartPos                  First candidate position (inclusive)
+// - nEndPos                    End of the candidate range (exclusive)
+// - bEoi                       Also report JPEG EOI markers
+//
+// RETURN:
+// - Confirmed candidates sorted by file position
+//
+std::vector<SigCandidate> SigScan::scan(uint64_t nStartPos, uint64_t nEndPos, bool bEoi) {
+    std::vector<PatternHit> hits;
+    _wbuf.searchAll(nStartPos, nEndPos, bEoi ? _patternsEoi : _patterns, hits);
+
+    std::vector<SigCandidate> candidates;
+    candidates.reserve(hits.size());
+
+    for (const auto &hit: hits) {
+        if (confirm(hit)) {
+            candidates.push_back({hit.nPos, static_cast<teSigType>(hit.nId)});
+        }
+    }
+
+    return candidates;
+}
+
+QString SigScan::typeName(teSigType eType) {
+    switch (eType) {
+        case SIG_T_JPEG:
+            return "JPEG";
+        case SIG_T_AVI:
+            return "AVI";
+        case SIG_T_PSD:
+            return "PSD";
+        case SIG_T_TIFF:
+            return "TIFF";
+        case SIG_T_PDF_DCT:
+            return "PDF DCTDecode";
+        case SIG_T_JPEG_EOI:
+            return "JPEG EOI";
+    }
+
+    return "???";
+}
+
+// Check the header bytes that follow a raw signature match
+// - Only a handful of bytes are read, and only for the rare raw hits
+//
+bool SigScan::confirm(const PatternHit &hit) {
+    const auto nFileSize = static_cast<uint64_t>(_wbuf.fileSize());
+
+    switch (hit.nId) {
+        case SIG_T_AVI:
+            // RIFF chunk size, then the "AVI " form type
+            return hit.nPos + 12 <= nFileSize && _wbuf.getDataX(hit.nPos + 8, 4) == 0x41564920;
+
+        case SIG_T_PSD: {
+            // Version 1 for PSD, 2 for PSB
+            if (hit.nPos + 6 > nFileSize) return false;
+            const auto nVer = _wbuf.getDataX(hit.nPos + 4, 2);
+            return nVer == 1 || nVer == 2;
+        }
+
+        default:
+            return true;
+    }
+}
@@ -0,0 +1,73 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Locates container signatures (JPEG, AVI, PSD, TIFF, PDF DCT streams)
+//   in a single sequential pass over the file
+// - Raw matches are confirmed against a few header bytes to discard
+//   the most common false positives
+// - Candidates are only hints: each must still be decoded
+// - JPEG EOI markers can be collected in the same pass
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_SIGSCAN_H
+#define JPEGSNOOP_SIGSCAN_H
+
+#include <QString>
+
+#include <vector>
+
+#include "ByteScan.h"
+#include "WindowBuf.h"
+
+enum teSigType {
+    SIG_T_JPEG,             // SOI followed by a marker: FF D8 FF
+    SIG_T_AVI,              // "RIFF" .... "AVI "
+    SIG_T_PSD,              // "8BPS" version 1 (PSD) or 2 (PSB)
+    SIG_T_TIFF,             // "II*\0" or "MM\0*"
+    SIG_T_PDF_DCT,          // "/DCTDecode" filter name in a PDF stream dictionary
+    SIG_T_JPEG_EOI,         // EOI marker: FF D9 (only when asked for)
+};
+
+struct SigCandidate {
+    uint64_t nPos;          // File position of the signature
+    teSigType eType;
+};
+
+class SigScan {
+    Q_DISABLE_COPY(SigScan)
+public:
+    explicit SigScan(WindowBuf &wbuf);
+
+    std::vector<SigCandidate> scan(uint64_t nStartPos = 0, uint64_t nEndPos = UINT64_MAX, bool bEoi = false);
+
+    static QString typeName(teSigType eType);
+
+private:
+    bool confirm(const PatternHit &hit);
+
+    WindowBuf &_wbuf;
+    MultiPattern _patterns;
+    MultiPattern _patternsEoi;      // _patterns plus the EOI marker
+};
+
+#endif
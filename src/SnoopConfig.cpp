@@ -12,5 +12,18 @@ SnoopConfig::SnoopConfig() {
 
     _errMaxDecodeScan = 20;
 
+    _mapFile = true;              // Fall back to windowed reads if mapping fails
+    _readAhead = true;
+    _kernelCopy = true;           // Falls back to buffered writes where unsupported
+
+    _threadCount = 0;             // One batch worker per core
+    _chunkSize = 256 * 1024 * 1024;
+    _indexEoi = false;            // EOI markers are common in scan data
+    _skipValidated = false;       // Try every SOI, even inside a decoded image
+    _quickReject = true;          // Skip the full decode of broken marker chains
+    _dedup = false;               // Export every copy of an image
+    _dedupIdentity = false;       // Copies must match byte for byte
+    _perceptualHash = false;      // Costs a Huffman decode of the first scan
+
     // _decodeColorConvert = true;   // Perform color convert after scan decode
 }
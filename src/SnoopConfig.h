@@ -23,10 +23,43 @@ public:
 
     bool hideUnknownExif() const { return _exifHideUnknown; }
 
+    bool mapFile() const { return _mapFile; }
+    void setMapFile(bool map) { _mapFile = map; }
+
+    bool readAhead() const { return _readAhead; }
+    void setReadAhead(bool readAhead) { _readAhead = readAhead; }
+
+    bool kernelCopy() const { return _kernelCopy; }
+    void setKernelCopy(bool copy) { _kernelCopy = copy; }
+
     bool relaxedParsing() const { return _relaxedParsing; }
 
     bool scanDump() const { return _outputScanDump; }
 
+    uint32_t threadCount() const { return _threadCount; }
+    void setThreadCount(uint32_t count) { _threadCount = count; }
+
+    bool indexEoi() const { return _indexEoi; }
+    void setIndexEoi(bool index) { _indexEoi = index; }
+
+    bool skipValidated() const { return _skipValidated; }
+    void setSkipValidated(bool skip) { _skipValidated = skip; }
+
+    bool quickReject() const { return _quickReject; }
+    void setQuickReject(bool reject) { _quickReject = reject; }
+
+    bool dedup() const { return _dedup; }
+    void setDedup(bool dedup) { _dedup = dedup; }
+
+    bool dedupIdentity() const { return _dedupIdentity; }
+    void setDedupIdentity(bool identity) { _dedupIdentity = identity; }
+
+    bool perceptualHash() const { return _perceptualHash; }
+    void setPerceptualHash(bool hash) { _perceptualHash = hash; }
+
+    qint64 chunkSize() const { return _chunkSize; }
+    void setChunkSize(qint64 size) { _chunkSize = size; }
+
 private:
     int _errMaxDecodeScan;         // Max # errs to show in scan decode
     bool _decodeScanImg;           // Scan image decode enabled
@@ -35,6 +68,17 @@ private:
     bool _decodeMaker;
     bool _exifHideUnknown;         // Hide unknown exif tags?
     bool _relaxedParsing;          // Proceed despite bad marker / format?
+    bool _mapFile;                 // Memory-map input files when possible
+    bool _readAhead;               // Prefetch windows in the background when not mapped
+    bool _kernelCopy;              // Export image data with kernel-side file copies
+    uint32_t _threadCount;         // Batch worker threads (0 for one per core)
+    qint64 _chunkSize;             // Split larger files over workers (0 to disable)
+    bool _indexEoi;                // Record EOI markers in candidate indexes
+    bool _skipValidated;           // Resume searches after the EOI of a decoded image
+    bool _quickReject;             // Check the marker structure before a full decode
+    bool _dedup;                   // Export each distinct image content only once per run
+    bool _dedupIdentity;           // Dedup by identity (tables and scan data) instead of all bytes
+    bool _perceptualHash;          // Decode the scan DC values for a perceptual hash
 };
 
 #endif
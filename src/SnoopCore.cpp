@@ -1,15 +1,23 @@
 #include "SnoopCore.h"
 
+#include <cstring>
 #include <stdexcept>
 
+#include "Md5.h"
+
 SnoopCore::SnoopCore(ILog &log, SnoopConfig &appConfig) :
     _log(log),
     _appConfig(appConfig) {
 
     _wbuf = std::make_unique<WindowBuf>(_log);
+    _wbuf->setMapEnabled(_appConfig.mapFile());
+    _wbuf->setReadAheadEnabled(_appConfig.readAhead());
+    _wbuf->setKernelCopyEnabled(_appConfig.kernelCopy());
     // _dbSigs = std::make_unique<DbSigs>(_log, _appConfig);
     _imgDec = std::make_unique<ImgDecode>(_log, *_wbuf, _appConfig);
     _jfifDec = std::make_unique<JfifDecode>(_log, *_wbuf, *_imgDec, _appConfig);
+    _sigScan = std::make_unique<SigScan>(*_wbuf);
+    _hdrCheck = std::make_unique<HeaderCheck>(*_wbuf);
 }
 
 SnoopCore::~SnoopCore() {
@@ -31,13 +39,14 @@ void SnoopCore::setOffset(qint64 offset) {
 }
 
 bool SnoopCore::decodeStatus() const {
-    if (!_hasAnalysis) return false;
+    if (!_hasAnalysis || _quickRejected) return false;
 
     return _jfifDec->getDecodeStatus();
 }
 
 void SnoopCore::openFile(const QString &filePath, qint64 offset) {
     if (_filePath == filePath) return;
+    closeFile();
     _filePath = filePath;
 
     _file = internalOpenFile(filePath, offset);
@@ -47,32 +56,85 @@ void SnoopCore::openFile(const QString &filePath, qint64 offset) {
 }
 
 void SnoopCore::closeFile() {
+    // Detach the buffer first so that it releases any mapping of the file
+    _wbuf->unsetFile();
+
     _filePath.clear();
     _file = nullptr;
     _hasAnalysis = false;
     _offset = 0;
+
+    _jfifDec->setAviCheck(true);
 }
 
+// Whether analyses look for an AVI header at the start of the file
+// - Callers that have indexed the file (see indexCandidates()) know if
+//   there is one, and can spare every analysis the check
+// - Cleared by closeFile()
+//
+void SnoopCore::setAviCheck(bool check) {
+    _jfifDec->setAviCheck(check);
+}
+
+// Decode the image at the current offset
+// - With SnoopConfig::quickReject(), candidates that fail the header
+//   check are never passed to the full decoder
+//
 bool SnoopCore::analyze() {
     if (!_hasAnalysis) {
-        _jfifDec->processFile(_offset);
+        _quickRejected = _appConfig.quickReject()
+                         && _hdrCheck->check(_offset, _appConfig.relaxedParsing()) != HDR_PASS;
+
+        if (!_quickRejected) {
+            _jfifDec->processFile(_offset);
+        }
+
         _hasAnalysis = true;
     }
 
-    return _jfifDec->getDecodeStatus();
+    return decodeStatus();
 }
 
-bool SnoopCore::searchForward() {
-    const auto offset = _hasAnalysis ? _offset + 1 : _offset;
+// Where a search continues after the analysis at the current offset
+// - Normally the next byte, so that every SOI inside the image is tried
+// - BatchCarver skips the indexed candidates before this position
+// - With SnoopConfig::skipValidated(), the byte after the EOI of an image
+//   that decoded. Its embedded images are then listed by
+//   embeddedImages() instead of being found again by the search.
+//
+uint64_t SnoopCore::resumePosition() const {
+    const auto next = static_cast<uint64_t>(_offset) + 1;
+    if (!_appConfig.skipValidated() || !decodeStatus() || !_jfifDec->getEoiFound()) return next;
 
-    uint32_t foundPosition;
-    const auto found = _wbuf->search(offset, 0xFFD8FF, 3, true, foundPosition);
-    if (!found) return false;
+    return qMax(next, _jfifDec->getPosEmbedEnd());
+}
 
-    _offset = foundPosition;
-    _hasAnalysis = false;
+// The embedded images found by the analysis at the current offset
+// - Only images that resumePosition() skips over are listed
+//
+// RETURN:
+// - File positions of the embedded images, in file order
+//
+std::vector<uint64_t> SnoopCore::embeddedImages() const {
+    std::vector<uint64_t> positions;
+    if (!decodeStatus()) return positions;
 
-    return true;
+    const auto start = static_cast<uint64_t>(_offset);
+    const auto end = resumePosition();
+
+    uint64_t thumbOffset;
+    uint32_t thumbLength;
+    if (_jfifDec->getExifThumb(thumbOffset, thumbLength) && thumbOffset > start && thumbOffset < end) {
+        positions.push_back(thumbOffset);
+    }
+
+    return positions;
+}
+
+void SnoopCore::indexCandidates(CandidateIndex &index, uint64_t startPosition, uint64_t endPosition) {
+    if (!_file) return;
+
+    index.scan(*_sigScan, startPosition, endPosition, _appConfig.indexEoi());
 }
 
 bool SnoopCore::exportJpeg(const QString &outFilePath) {
@@ -80,7 +142,7 @@ bool SnoopCore::exportJpeg(const QString &outFilePath) {
 
     const auto forceSoi = false;
     const auto forceEoi = false;
-    if (_jfifDec->getDecodeStatus() && _jfifDec->exportJpegPrepare(forceSoi, forceEoi, true)) {
+    if (decodeStatus() && _jfifDec->exportJpegPrepare(forceSoi, forceEoi, true)) {
         if (_jfifDec->exportJpegDo(outFilePath, false, true, forceSoi, forceEoi)) {
             return true;
         }
@@ -89,6 +151,129 @@ bool SnoopCore::exportJpeg(const QString &outFilePath) {
     return false;
 }
 
+// Export the image into memory, eg. for a PackWriter
+//
+bool SnoopCore::exportJpeg(QByteArray &data) {
+    const auto forceSoi = false;
+    const auto forceEoi = false;
+
+    return decodeStatus() && _jfifDec->exportJpegPrepare(forceSoi, forceEoi, true)
+           && _jfifDec->exportJpegData(data, false, true, forceSoi, forceEoi);
+}
+
+// Export the image to a file through memory, leaving its bytes in data
+// - For callers that also need the exported bytes (eg. to hash them),
+//   without reading the file back
+//
+bool SnoopCore::exportJpeg(const QString &outFilePath, QByteArray &data) {
+    if (outFilePath.isEmpty() || !exportJpeg(data)) return false;
+
+    LOG_INFO(_log, QString("Exporting to: [%1]").arg(outFilePath));
+
+    QFile outFile(outFilePath);
+    if (!outFile.open(QIODevice::WriteOnly)) {
+        _log.error(QString("Couldn't open file for write [%1]: [%2]").arg(outFilePath, outFile.errorString()));
+        return false;
+    }
+
+    if (outFile.write(data) != data.size()) {
+        _log.error(QString("Couldn't write [%1]: [%2]").arg(outFilePath, outFile.errorString()));
+        return false;
+    }
+
+    return true;
+}
+
+// Summary of the image that the last analysis decoded
+//
+// RETURN:
+// - false if there is no decoded image to describe
+//
+bool SnoopCore::imageInfo(ImageInfo &info) const {
+    if (!decodeStatus()) return false;
+
+    _jfifDec->getImageInfo(info);
+    return true;
+}
+
+// Hash the bytes of the image that the last analysis decoded
+// - With content dedup on, the analysis hashes the scan data as it
+//   skips it (see JfifDecode::getContentKey())
+//
+// RETURN:
+// - false if there is no decoded image to hash
+//
+bool SnoopCore::contentKey(ContentKey &key) {
+    uint64_t start, end;
+    if (!imageRange(start, end)) return false;
+
+    return _jfifDec->getContentKey(end, key);
+}
+
+// Identity of the image that the last analysis decoded
+// - Matches copies that differ only in their metadata segments (see
+//   JfifDecode::getIdentity()). Computed during the analysis itself.
+//
+// RETURN:
+// - false if there is no decoded image, or it has no scan
+//
+bool SnoopCore::identityKey(ContentKey &key) const {
+    if (!decodeStatus()) return false;
+
+    key = _jfifDec->getIdentity();
+    return key.length > 0;
+}
+
+// MD5 of the bytes of the image that the last analysis decoded, as
+// known-file hash lists record it
+//
+// OUTPUT:
+// - md5                        The digest
+//
+// RETURN:
+// - false if there is no decoded image to hash
+//
+bool SnoopCore::imageMd5(uint8_t md5[16]) {
+    uint64_t start, end;
+    if (!imageRange(start, end)) return false;
+
+    MD5_CTX ctx;
+    MD5Init(&ctx);
+
+    for (auto pos = start; pos < end;) {
+        // MD5Update() takes at most 2 GiB at a time
+        const uint8_t *data;
+        const auto len = _wbuf->getSpan(pos, static_cast<uint32_t>(qMin<uint64_t>(end - pos, INT32_MAX)), data, true);
+        if (len == 0) return false;
+
+        MD5Update(&ctx, const_cast<uint8_t *>(data), static_cast<int32_t>(len));
+        pos += len;
+    }
+
+    MD5Final(&ctx);
+    memcpy(md5, ctx.digest, 16);
+    return true;
+}
+
+// The header check, and its counts of the candidates it passed and rejected
+//
+HeaderCheck &SnoopCore::headerCheck() {
+    return *_hdrCheck;
+}
+
+// Bytes of the decoded image: the SOI through the EOI, or through the
+// end of the file if the EOI is missing
+//
+bool SnoopCore::imageRange(uint64_t &start, uint64_t &end) const {
+    if (!decodeStatus()) return false;
+
+    const auto fileSize = static_cast<uint64_t>(_wbuf->fileSize());
+    start = _jfifDec->getPosEmbedStart();
+    end = _jfifDec->getEoiFound() ? qMin(_jfifDec->getPosEmbedEnd(), fileSize) : fileSize;
+
+    return end > start;
+}
+
 std::unique_ptr<QFile> SnoopCore::internalOpenFile(const QString &filePath, qint64 offset) {
     if (filePath.isEmpty()) throw std::logic_error("File path is empty.");
 
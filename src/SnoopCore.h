@@ -10,8 +10,12 @@
 
 // #include "DbSigs.h"
 #include "log/ILog.h"
+#include "CandidateIndex.h"
+#include "ContentHash.h"
+#include "HeaderCheck.h"
 #include "ImgDecode.h"
 #include "JfifDecode.h"
+#include "SigScan.h"
 #include "SnoopConfig.h"
 #include "WindowBuf.h"
 #include "log/ILog.h"
@@ -29,10 +33,21 @@ public:
 
     void openFile(const QString &filePath, qint64 offset = 0);
     void closeFile();
+    void setAviCheck(bool check);
 
     bool analyze();
-    bool searchForward();
+    uint64_t resumePosition() const;
+    std::vector<uint64_t> embeddedImages() const;
+    void indexCandidates(CandidateIndex &index, uint64_t startPosition = 0, uint64_t endPosition = UINT64_MAX);
     bool exportJpeg(const QString &outFilePath);
+    bool exportJpeg(QByteArray &data);
+    bool exportJpeg(const QString &outFilePath, QByteArray &data);
+    bool imageInfo(ImageInfo &info) const;
+    bool contentKey(ContentKey &key);
+    bool identityKey(ContentKey &key) const;
+    bool imageMd5(uint8_t md5[16]);
+
+    HeaderCheck &headerCheck();
 
 private:
     ILog &_log;
@@ -42,11 +57,16 @@ private:
     // std::unique_ptr<DbSigs> _dbSigs;
     std::unique_ptr<ImgDecode> _imgDec;
     std::unique_ptr<JfifDecode> _jfifDec;
+    std::unique_ptr<SigScan> _sigScan;
+    std::unique_ptr<HeaderCheck> _hdrCheck;
 
     QString _filePath;
     std::unique_ptr<QFile> _file;
     qint64 _offset = 0;
     bool _hasAnalysis = false;
+    bool _quickRejected = false;  // The last analysis stopped at the header check
+
+    bool imageRange(uint64_t &start, uint64_t &end) const;
 
     static std::unique_ptr<QFile> internalOpenFile(const QString &filePath, qint64 offset);
 };
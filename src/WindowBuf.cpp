@@ -16,41 +16,64 @@
 //    along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <stdexcept>
+#include <utility>
 
+#include "FileCopy.h"
 #include "WindowBuf.h"
 
-WindowBuf::WindowBuf(ILog &log) :
-    _log(log) {
+// Hash scan data with its byte stuffing removed (0xFF 0x00 -> 0xFF)
+// - Every 0xFF in the range must have its next byte in the range too
+//
+static void HashUnstuffed(ContentHash &hash, const uint8_t *pData, size_t nLen) {
+    size_t nInd = 0;
 
-    _buf = new unsigned char[MAX_BUF];
+    while (nInd < nLen) {
+        const auto pFf = static_cast<const uint8_t *>(memchr(pData + nInd, 0xFF, nLen - nInd));
+        const auto nEnd = pFf ? static_cast<size_t>(pFf - pData) + 1 : nLen;
 
-    reset();
+        hash.update(pData + nInd, nEnd - nInd);
+        nInd = nEnd;
 
-    // Initialize all overlays as not defined.
-    // Only create space for them as required
-    _overlayNum = 0;
-    _overlayMax = 0;
+        if (pFf && nInd < nLen && pData[nInd] == 0x00) {
+            nInd++;
+        }
+    }
+}
 
-    for (uint32_t nInd = 0; nInd < NUM_OVERLAYS; nInd++) {
-        _overlays[nInd] = nullptr;
+WindowBuf::WindowBuf(ILog &log) :
+    _log(log) {
+
+    for (auto &window : _windows) {
+        window.buf = new unsigned char[MAX_BUF];
     }
+
+    _aheadBuf = new unsigned char[MAX_BUF];
+    _win = _windows[_curWindow].buf;
+
+    reset();
 }
 
 WindowBuf::~WindowBuf() {
-    delete[] _buf;
-    _buf = nullptr;
+    // The read-ahead thread must be finished before its buffer goes away
+    closeReadAhead();
 
-    _bufOk = false;
-
-    // Clear up overlays
-    for (uint32_t nInd = 0; nInd < NUM_OVERLAYS; nInd++) {
-        if (_overlays[nInd]) {
-            delete _overlays[nInd];
+    // Any mapping is released by the QFile itself when it is closed
+    _map = nullptr;
+    _win = nullptr;
 
-            _overlays[nInd] = nullptr;
-        }
+    for (auto &window : _windows) {
+        delete[] window.buf;
+        window.buf = nullptr;
     }
+
+    delete[] _aheadBuf;
+    _aheadBuf = nullptr;
+
+    _bufOk = false;
 }
 
 void WindowBuf::reset() {
@@ -70,40 +93,371 @@ qint64 WindowBuf::position() const {
     return _position;
 }
 
+bool WindowBuf::isMapEnabled() const {
+    return _mapEnabled;
+}
+
+// Select whether files are memory-mapped when assigned with setFile()
+// - Takes effect on the next setFile()
+//
+void WindowBuf::setMapEnabled(bool enabled) {
+    _mapEnabled = enabled;
+}
+
+bool WindowBuf::isMapped() const {
+    return _map != nullptr;
+}
+
+bool WindowBuf::isReadAheadEnabled() const {
+    return _readAheadEnabled;
+}
+
+// Select whether sequential reads prefetch the next window in the
+// background. Only applies to files that are not memory-mapped.
+// - Takes effect on the next setFile()
+//
+void WindowBuf::setReadAheadEnabled(bool enabled) {
+    _readAheadEnabled = enabled;
+}
+
+bool WindowBuf::isKernelCopyEnabled() const {
+    return _kernelCopyEnabled;
+}
+
+// Select whether copyToFile() may copy file content inside the kernel
+// instead of writing it out of the buffer windows
+//
+void WindowBuf::setKernelCopyEnabled(bool enabled) {
+    _kernelCopyEnabled = enabled;
+}
+
+// Number of bytes that the next cache miss will load
+//
+qint64 WindowBuf::windowSize() const {
+    return _winLoadSize;
+}
+
+uint64_t WindowBuf::cacheHits() const {
+    return _cacheHits;
+}
+
+uint64_t WindowBuf::cacheMisses() const {
+    return _cacheMisses;
+}
+
+void WindowBuf::resetCacheStats() {
+    _cacheHits = 0;
+    _cacheMisses = 0;
+}
+
 void WindowBuf::setFile(QFile *file) {
     if (_file == file) return;
-    _file = file;
+    unsetFile();
 
+    _file = file;
     _fileSize = _file->size();
-    _bufOk = false;
+
+    if (_mapEnabled) {
+        mapFile();
+    }
+
+    if (!_map && _readAheadEnabled) {
+        openReadAhead();
+    }
 }
 
 void WindowBuf::unsetFile() {
+    closeReadAhead();
+    unmapFile();
+
     _file = nullptr;
     _fileSize = 0;
+    _position = 0;
     _bufOk = false;
+    _bufWinSize = 0;
+    _bufWinStart = 0;
+}
+
+// Map the entire file into memory and expose the mapping as the window
+// - On failure (eg. pipes, devices or files too large for the address
+//   space) we silently fall back to the copying window
+//
+// RETURN:
+// - Success in mapping the file
+//
+bool WindowBuf::mapFile() {
+    if (!_file || _fileSize <= 0) return false;
+
+    _map = _file->map(0, _fileSize);
+    if (!_map) return false;
+
+    _win = _map;
+    _position = 0;
+    _bufOk = true;
+    _bufWinStart = 0;
+    _bufWinSize = _fileSize;
+    updateWindowOverlay();
+
+    return true;
+}
+
+void WindowBuf::unmapFile() {
+    if (_map && _file) {
+        _file->unmap(_map);
+    }
+
+    _map = nullptr;
+    clearWindows();
+}
+
+// Forget the content of all cache windows
+// - The first window becomes current (and empty)
+//
+void WindowBuf::clearWindows() {
+    for (auto &window : _windows) {
+        window.start = 0;
+        window.size = 0;
+        window.lastUse = 0;
+    }
+
+    _curWindow = 0;
+    _useClock = 0;
+    _winLoadSize = MAX_BUF_WINDOW;
+
+    _win = _windows[_curWindow].buf;
+    _bufOk = false;
+    _bufWinSize = 0;
+    _bufWinStart = 0;
+    _winOverlayFree = true;
+}
+
+// Make a cache window the current one
+//
+void WindowBuf::selectWindow(uint32_t nInd) {
+    auto &window = _windows[nInd];
+    window.lastUse = ++_useClock;
+
+    _curWindow = nInd;
+    _win = window.buf;
+    _position = window.start;
+    _bufOk = true;
+    _bufWinStart = window.start;
+    _bufWinSize = window.size;
+    updateWindowOverlay();
+}
+
+// Locate a cache window that holds [position, position+len)
+// - The range is clipped to the end of the file
+//
+// RETURN:
+// - Index of the window, or NUM_WINDOWS if none holds the range
+//
+uint32_t WindowBuf::findWindow(qint64 position, qint64 len) const {
+    const auto end = qMin(position + len, _fileSize);
+
+    for (uint32_t nInd = 0; nInd < NUM_WINDOWS; nInd++) {
+        const auto &window = _windows[nInd];
+
+        if (window.size > 0 && position >= window.start && end <= window.start + window.size) {
+            return nInd;
+        }
+    }
+
+    return NUM_WINDOWS;
+}
+
+// Pick the cache window to replace: an unused one, else the least
+// recently used one
+//
+uint32_t WindowBuf::victimWindow() const {
+    uint32_t nVictim = 0;
+
+    for (uint32_t nInd = 0; nInd < NUM_WINDOWS; nInd++) {
+        if (_windows[nInd].size == 0) return nInd;
+
+        if (_windows[nInd].lastUse < _windows[nVictim].lastUse) {
+            nVictim = nInd;
+        }
+    }
+
+    return nVictim;
+}
+
+// Adapt the load size to the access pattern on a cache miss
+// - A miss next to the current window means the file is being walked,
+//   so larger windows save file reads
+// - A miss far away from it means the parser is jumping around (eg.
+//   following IFD offsets), so smaller windows save wasted bytes
+//
+void WindowBuf::adaptWindowSize(qint64 position, qint64 len) {
+    if (!_bufOk || _bufWinSize == 0) return;
+
+    const auto adjacent = position + len >= _bufWinStart - MAX_BUF_WINDOW_REV &&
+                          position <= _bufWinStart + _bufWinSize + MAX_BUF_WINDOW_REV;
+
+    if (adjacent) {
+        _winLoadSize = qMin<qint64>(_winLoadSize * 2, MAX_BUF);
+    } else {
+        _winLoadSize = qMax<qint64>(_winLoadSize / 2, MIN_BUF_WINDOW);
+    }
+}
+
+// Open a second handle on the file for the read-ahead thread
+// - QFile is not thread-safe, so the thread never touches _file
+// - Read-ahead is silently skipped if the file can't be reopened
+//
+void WindowBuf::openReadAhead() {
+    if (!_file || _file->fileName().isEmpty()) return;
+
+    _aheadFile = std::make_unique<QFile>(_file->fileName());
+    if (!_aheadFile->open(QFile::OpenModeFlag::ReadOnly)) {
+        _aheadFile = nullptr;
+    }
+}
+
+// Wait for any pending read-ahead and release its file handle
+//
+void WindowBuf::closeReadAhead() {
+    if (_ahead.valid()) {
+        _ahead.wait();
+    }
+
+    _ahead = std::future<qint64>();
+    _aheadFile = nullptr;
+    _aheadStart = 0;
+}
+
+// Prefetch the window that follows the current one
+// - The new window overlaps the current one by MAX_BUF_WINDOW_REV,
+//   matching where loadWindow() would place it
+// - Nothing is started while a previous read-ahead is still running
+//
+void WindowBuf::startReadAhead() {
+    if (!_aheadFile || !_bufOk) return;
+
+    const auto winEnd = _bufWinStart + _bufWinSize;
+    if (winEnd >= _fileSize) return;
+
+    if (_ahead.valid() && _ahead.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+    const auto nextStart = winEnd > MAX_BUF_WINDOW_REV ? winEnd - MAX_BUF_WINDOW_REV : 0;
+    if (_ahead.valid() && _aheadStart == nextStart) return;
+
+    const auto file = _aheadFile.get();
+    const auto buf = _aheadBuf;
+    const auto size = _winLoadSize;
+
+    _aheadStart = nextStart;
+    _ahead = std::async(std::launch::async, [file, buf, nextStart, size]() -> qint64 {
+        if (!file->seek(nextStart)) return 0;
+        return file->read(reinterpret_cast<char *>(buf), size);
+    });
+}
+
+// Make the prefetched window current if it serves the requested range
+// - The position must lie no further into the window than a fresh
+//   loadWindow() would place it, so callers see the same look-ahead
+// - The back buffer replaces the least recently used cache window
+//
+// RETURN:
+// - Success in switching to the prefetched window
+//
+bool WindowBuf::takeReadAhead(qint64 position, qint64 len) {
+    if (!_ahead.valid()) return false;
+    if (position < _aheadStart || position > _aheadStart + MAX_BUF_WINDOW_REV) return false;
+
+    const auto readBytes = _ahead.get();
+    if (readBytes <= 0 || qMin(position + len, _fileSize) > _aheadStart + readBytes) return false;
+
+    // The thread has finished with the back buffer, so swap it in
+    const auto nInd = victimWindow();
+    auto &window = _windows[nInd];
+
+    std::swap(window.buf, _aheadBuf);
+    window.start = _aheadStart;
+    window.size = readBytes;
+
+    selectWindow(nInd);
+
+    return true;
 }
 
 bool WindowBuf::loadWindow(qint64 position) {
+    return loadWindow(position, MIN_WINDOW_AHEAD);
+}
+
+// Make current a window that holds [position, position+len)
+// - Served from the cache windows when possible
+// - Otherwise the least recently used window is refilled from the
+//   file, starting MAX_BUF_WINDOW_REV bytes before the position
+//
+// RETURN:
+// - Success in loading the window
+//
+bool WindowBuf::loadWindow(qint64 position, qint64 len) {
+    // The mapping already spans the whole file, so a load only has to
+    // clear any earlier failed read
+    if (_map) {
+        if (position < 0 || position >= _fileSize) return false;
+
+        _bufOk = true;
+        return true;
+    }
+
+    if (!_file || position < 0 || position >= _fileSize) return false;
+
+    const auto nHit = findWindow(position, len);
+    if (nHit < NUM_WINDOWS) {
+        _cacheHits++;
+        selectWindow(nHit);
+        return true;
+    }
+
+    // A request that runs on from the second half of the current window
+    // is taken as a sequential scan and keeps the read-ahead going
+    const auto sequential = _bufOk && position >= _bufWinStart + _bufWinSize / 2 &&
+                            position <= _bufWinStart + _bufWinSize + MAX_BUF_WINDOW_REV;
+
+    adaptWindowSize(position, len);
+
+    if (takeReadAhead(position, len)) {
+        _cacheHits++;
+        startReadAhead();
+        return true;
+    }
+
+    _cacheMisses++;
+
     const qint64 positionAdj = position >= MAX_BUF_WINDOW_REV ? position - MAX_BUF_WINDOW_REV : 0;
-    if (_position == positionAdj && _bufOk) return true;
+    const auto loadSize = qMin<qint64>(qMax(_winLoadSize, position - positionAdj + len), MAX_BUF);
 
-    if (!_file) return false;
+    const auto nInd = victimWindow();
+    auto &window = _windows[nInd];
+
+    // The victim's content is about to be overwritten
+    window.size = 0;
+    if (nInd == _curWindow) {
+        _bufWinStart = 0;
+        _bufWinSize = 0;
+        _winOverlayFree = true;
+    }
 
     _position = positionAdj;
     _bufOk = false;
-    _bufWinSize = 0;
-    _bufWinStart = 0;
 
-    if (positionAdj >= _fileSize) return false;
     if (!_file->seek(positionAdj)) return false;
-    const auto readBytes = _file->read(reinterpret_cast<char *>(_buf), MAX_BUF_WINDOW);
+    const auto readBytes = _file->read(reinterpret_cast<char *>(window.buf), loadSize);
 
-    if (readBytes == 0) return false;
+    if (readBytes <= 0) return false;
 
-    _bufOk = true;
-    _bufWinStart = positionAdj;
-    _bufWinSize = readBytes;
+    window.start = positionAdj;
+    window.size = readBytes;
+
+    selectWindow(nInd);
+
+    if (sequential) {
+        startReadAhead();
+    }
 
     return true;
 }
@@ -118,6 +472,7 @@ bool WindowBuf::loadWindow(qint64 position) {
 // - nSearchVal                 Value to search for (up to 32-bit unsigned)
 // - nSearchLen                 Maximum number of bytes to search
 // - bDirFwd                    TRUE for forward, FALSE for backwards
+// - nLastPos                   Highest candidate position for forward searches
 //
 // PRE:
 // - m_nPosEof
@@ -128,251 +483,460 @@ bool WindowBuf::loadWindow(qint64 position) {
 // RETURN:
 // - Success in finding the value
 //
-bool WindowBuf::search(uint32_t startPosition, uint32_t searchValue, uint32_t searchLength, bool forward, uint32_t &foundPosition) {
+bool WindowBuf::search(uint64_t startPosition, uint32_t searchValue, uint32_t searchLength, bool forward, uint64_t &foundPosition,
+                       uint64_t lastPosition) {
     if (searchLength < 1 || searchLength > 4) throw std::logic_error("SearchLength out of range.");
 
-    auto currentPos = startPosition;
-
-    uint32_t currentValue;
-    while (currentPos + searchLength < _fileSize) {
-        // Update progress in status bar
-        // - Note that we only check timer when step counter has
-        //   reached a certain threshold. This limits the overhead
-        //   associated with the timer comparison
-        // if (((curPos % (16 * 1024)) == 0)) {
-        //     time_t tmNow = clock();
-        //
-        //     if ((tmNow - tmLast) > (CLOCKS_PER_SEC / 8)) {
-        //         tmLast = tmNow;
-        //         // const auto fProgress = (curPos * 100.0f) / _posEof;
-        //         // strStatus = QString("Searching %3.f%% (%lu of %lu)...").arg(fProgress).arg(nCurPos).arg(_posEof);
-        //         // m_pStatBar->showMessage(strStatus);
-        //     }
-        // }
-
-        if (searchLength == 4) {
-            currentValue = (getByte(currentPos + 0) << 24) + (getByte(currentPos + 1) << 16) + (getByte(currentPos + 2) << 8) + getByte(currentPos + 3);
-        } else if (searchLength == 3) {
-            currentValue = (getByte(currentPos + 0) << 16) + (getByte(currentPos + 1) << 8) + getByte(currentPos + 2);
-        } else if (searchLength == 2) {
-            currentValue = (getByte(currentPos + 0) << 8) + getByte(currentPos + 1);
-        } else {
-            currentValue = getByte(currentPos + 0);
-        }
+    // Candidate positions must satisfy (pos + searchLength < fileSize)
+    if (_fileSize <= static_cast<qint64>(searchLength)) return false;
+    const uint64_t lastPos = forward ? qMin<uint64_t>(_fileSize - searchLength - 1, lastPosition) : _fileSize - searchLength - 1;
+    if (startPosition > lastPos) return false;
 
-        if (currentValue == searchValue) {
-            foundPosition = currentPos;
-            return true;
-        }
+    // A value wider than the search length can never match
+    if (searchLength < 4 && (searchValue >> (8 * searchLength)) != 0) return false;
 
-        if (forward) {
-            if (currentPos < _fileSize) currentPos++;
-            else return false;
-        } else {
-            if (currentPos > 0) currentPos--;
-            else return false;
-        }
+    // Break the value into its big-endian byte pattern
+    uint8_t anPattern[4];
+    for (uint32_t ind = 0; ind < searchLength; ind++) {
+        anPattern[ind] = static_cast<uint8_t>(searchValue >> (8 * (searchLength - 1 - ind)));
     }
 
-    return false;
+    const SearchPattern pattern(anPattern, searchLength);
+    return searchPattern(startPosition, lastPos, pattern, forward, foundPosition);
 }
 
 // Search for a variable-length byte string in the buffer from a given starting position
-// and direction, limited to a maximum search depth
+// and direction
 // - Search string is array of unsigned bytes
-// - Update progress in lengthy searches
+// - Compiles the search string on each call. Use the SearchPattern
+//   overload when searching repeatedly for the same string.
 //
 // INPUT:
-// - nStartPos                  Starting byte offset for search
+// - nStartPos                  Starting byte offset for search (not itself a candidate)
 // - anSearchVal                Byte array to search for
-// - nSearchLen                 Maximum number of bytes to search
+// - nSearchLen                 Number of bytes in anSearchVal
 // - bDirFwd                    TRUE for forward, FALSE for backwards
 //
-// PRE:
-// - m_nPosEof
-// - m_pStatBar
-//
 // OUTPUT:
 // - nFoundPos                  Byte offset in buffer for start of search match
 //
 // RETURN:
 // - Success in finding the value
 //
-bool WindowBuf::searchX(uint32_t nStartPos, unsigned char *anSearchVal, uint32_t nSearchLen, bool bDirFwd, uint32_t &nFoundPos) {
-    // Save the current position
-    uint32_t nCurPos;
-
-    uint32_t nByteCur;
-    uint32_t nByteSearch;
+bool WindowBuf::searchX(uint64_t nStartPos, unsigned char *anSearchVal, uint32_t nSearchLen, bool bDirFwd, uint64_t &nFoundPos) {
+    const SearchPattern pattern(anSearchVal, nSearchLen);
+    return searchX(nStartPos, pattern, bDirFwd, nFoundPos);
+}
 
-    uint32_t nCurPosOffset;
-    uint32_t nMatchStartPos = 0;
+// Search for a precompiled byte string in the buffer from a given starting position
+// and direction
+// - The match must lie entirely within the file
+//
+// INPUT:
+// - nStartPos                  Starting byte offset for search (not itself a candidate)
+// - pattern                    Compiled byte string to search for
+// - bDirFwd                    TRUE for forward, FALSE for backwards
+//
+// OUTPUT:
+// - nFoundPos                  Byte offset in buffer for start of search match
+//
+// RETURN:
+// - Success in finding the value
+//
+bool WindowBuf::searchX(uint64_t nStartPos, const SearchPattern &pattern, bool bDirFwd, uint64_t &nFoundPos) {
+    const auto nSearchLen = pattern.length();
+    if (nSearchLen < 1 || _fileSize < static_cast<qint64>(nSearchLen)) return false;
 
-    //bool                  bMatchStart = false;
-    bool bMatchOn = false;
+    const uint64_t nLastPos = _fileSize - nSearchLen;
 
-    // QString strStatus;
-    // time_t tmLast = clock();
+    if (bDirFwd) {
+        if (nStartPos >= nLastPos) return false;
+        return searchPattern(nStartPos + 1, nLastPos, pattern, true, nFoundPos);
+    } else {
+        if (nStartPos == 0) return false;
+        return searchPattern(qMin(nStartPos - 1, nLastPos), nLastPos, pattern, false, nFoundPos);
+    }
+}
 
-    nCurPosOffset = 0;
-    nCurPos = nStartPos;
-    bool bDone = false;
+// Common search engine for search() and searchX()
+// - Walks the file one window at a time and hands each window to the
+//   compiled pattern, so that no byte is fetched through getByte()
+// - Windows that intersect an enabled overlay fall back to getByte()
+//
+// INPUT:
+// - nStartPos                  First candidate position (inclusive)
+// - nLastPos                   Highest permitted candidate position
+// - pattern                    Compiled byte string to search for
+// - bDirFwd                    TRUE for forward, FALSE for backwards
+//
+// OUTPUT:
+// - nFoundPos                  Byte offset in buffer for start of search match
+//
+// RETURN:
+// - Success in finding the value
+//
+bool WindowBuf::searchPattern(uint64_t nStartPos, uint64_t nLastPos, const SearchPattern &pattern, bool bDirFwd, uint64_t &nFoundPos) {
+    const auto nSearchLen = pattern.length();
+    auto nCurPos = nStartPos;
+
+    while (true) {
+        if (!loadSearchWindow(nCurPos, nSearchLen, bDirFwd)) return false;
+
+        // Determine the range of candidate positions [nLo,nHi] that can be
+        // verified entirely from the current window
+        const auto nWinStart = static_cast<uint64_t>(_bufWinStart);
+        const auto nWinLast = nWinStart + static_cast<uint64_t>(_bufWinSize) - nSearchLen;
+
+        const auto nLo = bDirFwd ? nCurPos : nWinStart;
+        const auto nHi = bDirFwd ? qMin(nLastPos, nWinLast) : nCurPos;
+
+        if (overlayInRange(nLo, nHi + nSearchLen)) {
+            // Overlays cover part of this range, so fall back to
+            // fetching every byte through getByte()
+            for (auto nPos = nCurPos; nPos >= nLo && nPos <= nHi; bDirFwd ? nPos++ : nPos--) {
+                if (matchAt(nPos, pattern.data(), nSearchLen)) {
+                    nFoundPos = nPos;
+                    return true;
+                }
 
-    bool bFound = false;          // Matched entire search string
+                if (!bDirFwd && nPos == 0) break;
+            }
+        } else {
+            const auto pBase = _win + (nLo - nWinStart);
+            const auto nSpan = static_cast<size_t>(nHi - nLo) + nSearchLen;
+            const auto nRel = bDirFwd ? pattern.findFwd(pBase, nSpan) : pattern.findRev(pBase, nSpan);
 
-    while (!bDone) {
+            if (nRel < nSpan) {
+                nFoundPos = nLo + nRel;
+                return true;
+            }
+        }
 
+        // Move on to the next window
         if (bDirFwd) {
-            nCurPos++;
+            if (nHi >= nLastPos) return false;
+            nCurPos = nHi + 1;
+        } else {
+            if (nLo == 0) return false;
+            nCurPos = nLo - 1;
+        }
+    }
+}
 
-            if (nCurPos + (nSearchLen - 1) >= _fileSize) {
-                bDone = true;
+// Find every occurrence of a set of byte strings in one forward pass
+// - Each window is handed to the pattern set once, so the file is read
+//   only once however many patterns there are
+// - Windows that intersect an enabled overlay fall back to getByte()
+//
+// INPUT:
+// - nStartPos                  First candidate position (inclusive)
+// - nEndPos                    End of the candidate range (exclusive)
+// - patterns                   Byte strings to search for
+//
+// OUTPUT:
+// - hits                       Matches appended in position order. Each
+//                              match lies entirely within the file.
+//
+void WindowBuf::searchAll(uint64_t nStartPos, uint64_t nEndPos, const MultiPattern &patterns, std::vector<PatternHit> &hits) {
+    if (patterns.isEmpty()) return;
+
+    const auto nFileSize = static_cast<uint64_t>(_fileSize);
+    const auto nMinLen = patterns.minLength();
+    const auto nMaxLen = patterns.maxLength();
+    if (nFileSize < nMinLen) return;
+
+    nEndPos = qMin(nEndPos, nFileSize - nMinLen + 1);
+    auto nCurPos = nStartPos;
+
+    while (nCurPos < nEndPos) {
+        // Ask for room for the longest pattern, except near the end of
+        // the file where only the shorter ones can still fit
+        const auto nNeed = static_cast<uint32_t>(qMin<uint64_t>(nMaxLen, nFileSize - nCurPos));
+        if (!loadSearchWindow(nCurPos, nNeed, true)) return;
+
+        const auto nWinStart = static_cast<uint64_t>(_bufWinStart);
+        const auto nWinEnd = nWinStart + static_cast<uint64_t>(_bufWinSize);
+
+        // Candidates that the longest pattern would run past the window
+        // for are left to the next window, unless this one reaches EOF
+        auto nCandEnd = nWinEnd >= nFileSize ? nWinEnd : nWinEnd - nMaxLen + 1;
+        nCandEnd = qMin(nCandEnd, nEndPos);
+
+        if (overlayInRange(nCurPos, nCandEnd - 1 + nMaxLen)) {
+            for (auto nPos = nCurPos; nPos < nCandEnd; nPos++) {
+                for (uint32_t nInd = 0; nInd < patterns.count(); nInd++) {
+                    const auto nLen = patterns.length(nInd);
+
+                    if (nPos + nLen <= nFileSize && matchAt(nPos, patterns.data(nInd), nLen)) {
+                        hits.push_back({nPos, patterns.id(nInd)});
+                    }
+                }
             }
         } else {
-            if (nCurPos > 0) {
-                nCurPos--;
-            } else {
-                bDone = true;
-            }
+            const auto nRel = static_cast<size_t>(nCurPos - nWinStart);
+            patterns.findAll(_win + nRel, static_cast<size_t>(nWinEnd - nCurPos),
+                             static_cast<size_t>(nCandEnd - nCurPos), nCurPos, hits);
         }
 
-        // Update progress in status bar
-        // - Note that we only check timer when step counter has
-        //   reached a certain threshold. This limits the overhead
-        //   associated with the timer comparison
-        // if (((nCurPos % (16 * 1024)) == 0)) {
-        //     time_t tmNow = clock();
-        //
-        //     if ((tmNow - tmLast) > (CLOCKS_PER_SEC / 8)) {
-        //         tmLast = tmNow;
-        //         const auto fProgress = (nCurPos * 100.0f) / _fileSize;
-        //
-        //         // strStatus = QString("Searching %3.f%% (%lu of %lu)...").arg(fProgress).arg(nCurPos).arg(_fileSize);
-        //         // m_pStatBar->showMessage(strStatus);
-        //     }
-        // }
-
-        nByteSearch = anSearchVal[nCurPosOffset];
-        nByteCur = getByte(nCurPos);
-
-        if (nByteSearch == nByteCur) {
-            if (!bMatchOn) {
-                // Since we aren't in match mode, we are beginning a new
-                // sequence, so save the starting position in case we
-                // have to rewind
-                nMatchStartPos = nCurPos;
-                bMatchOn = true;
+        nCurPos = nCandEnd;
+    }
+}
+
+// Skip over JPEG entropy-coded scan data to the marker that ends it
+// - Byte stuffing (0xFF 0x00) and RSTn markers are part of the scan
+// - Whole windows are scanned for 0xFF, and only those bytes are looked
+//   at more closely. Windows that intersect an enabled overlay fall back
+//   to getByte().
+//
+// INPUT:
+// - nStartPos                  First byte of the scan data
+//
+// OUTPUT:
+// - nMarkerPos                 Position of the 0xFF of the marker, or the
+//                              file size if the file ends first
+// - pRstPos                    If not null, positions of the RSTn markers
+//                              in the scan are appended
+// - pHash                      If not null, fed the scan data with its
+//                              byte stuffing removed (RSTn markers kept)
+// - pRawHash                   If not null, fed the scan data as it is in
+//                              the file, up to nMarkerPos
+//
+// RETURN:
+// - Whether a marker was found
+//
+bool WindowBuf::skipScanData(uint64_t nStartPos, uint64_t &nMarkerPos, std::vector<uint64_t> *pRstPos,
+                             ContentHash *pHash, ContentHash *pRawHash) {
+    const auto nFileSize = static_cast<uint64_t>(_fileSize);
+    auto nCurPos = nStartPos;
+
+    // A marker needs its 0xFF and the code byte after it
+    while (nCurPos + 1 < nFileSize) {
+        if (!loadSearchWindow(nCurPos, 2, true)) break;
+
+        const auto nWinStart = static_cast<uint64_t>(_bufWinStart);
+        const auto nWinEnd = nWinStart + static_cast<uint64_t>(_bufWinSize);
+
+        if (overlayInRange(nCurPos, nWinEnd)) {
+            const auto nByte = static_cast<uint8_t>(getByte(nCurPos));
+
+            if (nByte != 0xFF) {
+                if (pHash) {
+                    pHash->update(&nByte, 1);
+                }
+
+                if (pRawHash) {
+                    pRawHash->update(&nByte, 1);
+                }
+
+                nCurPos++;
+                continue;
             }
 
-            nCurPosOffset++;
-        } else {
-            if (bMatchOn) {
-                // Since we were in a sequence of matches, but ended early,
-                // we now need to reset our position to just after the start
-                // of the previous 1st match.
-                nCurPos = nMatchStartPos;
-                bMatchOn = false;
+            const auto nCode = static_cast<uint8_t>(getByte(nCurPos + 1));
+
+            if ((nCode >= 0xD0) && (nCode <= 0xD7)) {
+                if (pRstPos) {
+                    pRstPos->push_back(nCurPos);
+                }
+            } else if (nCode != 0x00) {
+                nMarkerPos = nCurPos;
+                return true;
+            }
+
+            if (pHash) {
+                pHash->update(&nByte, 1);
+                if (nCode != 0x00) {
+                    pHash->update(&nCode, 1);
+                }
+            }
+
+            if (pRawHash) {
+                pRawHash->update(&nByte, 1);
+                pRawHash->update(&nCode, 1);
             }
 
-            nCurPosOffset = 0;
+            nCurPos += 2;
+            continue;
         }
 
-        if (nCurPosOffset >= nSearchLen) {
-            // We matched the entire length of our search string!
-            bFound = true;
-            bDone = true;
+        const auto pWin = _win + (nCurPos - nWinStart);
+
+        size_t nInd;
+        const auto bFound = ScanMarkerFwd(pWin, static_cast<size_t>(nWinEnd - nCurPos), nInd, nCurPos, pRstPos);
+
+        // The window bytes are still in cache from the marker search
+        if (pHash) {
+            HashUnstuffed(*pHash, pWin, nInd);
         }
+
+        if (pRawHash) {
+            pRawHash->update(pWin, nInd);
+        }
+
+        if (bFound) {
+            nMarkerPos = nCurPos + nInd;
+            return true;
+        }
+
+        nCurPos += nInd;
     }
 
-    // if (m_pStatBar) {
-    //     m_pStatBar->showMessage("Done");
-    // }
+    nMarkerPos = nFileSize;
+    return false;
+}
+
+// Ensure that the window holds [nPos, nPos+nLen), placing it so that
+// as much of the remaining search range as possible is covered
+// - Forward searches keep the position near the start of the window
+// - Reverse searches keep the position near the end of the window
+//
+// RETURN:
+// - Success in loading the window
+//
+bool WindowBuf::loadSearchWindow(uint64_t nPos, uint32_t nLen, bool bDirFwd) {
+    const auto nEnd = nPos + nLen;
+
+    if (_bufOk && static_cast<qint64>(nPos) >= _bufWinStart && static_cast<qint64>(nEnd) <= _bufWinStart + _bufWinSize) {
+        return true;
+    }
 
-    if (bFound) {
-        nFoundPos = nMatchStartPos;
+    qint64 nLoadPos = nPos;
+    if (!bDirFwd) {
+        // loadWindow() backs off by MAX_BUF_WINDOW_REV, so compensate so
+        // that the window ends just after the requested range
+        const qint64 nTarget = nEnd + MAX_BUF_WINDOW_REV;
+        nLoadPos = qMin<qint64>(nTarget > _winLoadSize ? nTarget - _winLoadSize : 0, nPos);
     }
 
-    return bFound;
+    if (!loadWindow(nLoadPos, nEnd - nLoadPos)) return false;
+
+    return static_cast<qint64>(nPos) >= _bufWinStart && static_cast<qint64>(nEnd) <= _bufWinStart + _bufWinSize;
 }
 
-// Allocate a new buffer overlay into the array
-// over overlays. Limits the number of overlays
-// to NUM_OVERLAYS.
-// - If the indexed overlay already exists, no changes are made
-// - TODO: Replace with vector
+// Compare a byte pattern against the buffer (with overlays)
 //
-// INPUT:
-// - nInd               Overlay index to allocate
+bool WindowBuf::matchAt(uint64_t nPos, const uint8_t *anPattern, uint32_t nLen) {
+    for (uint32_t ind = 0; ind < nLen; ind++) {
+        if (getByte(nPos + ind) != anPattern[ind]) return false;
+    }
+
+    return true;
+}
+
+// Determine whether any overlay covers part of [nStart, nEnd)
 //
-// POST:
-// - m_psOverlay[]
+bool WindowBuf::overlayInRange(uint64_t nStart, uint64_t nEnd) const {
+    if (_overlaySpans.empty() || nStart >= nEnd) return false;
+
+    // First span that ends after nStart
+    const auto it = std::upper_bound(_overlaySpans.begin(), _overlaySpans.end(), nStart,
+                                     [](uint64_t nPos, const OverlaySpan &span) { return nPos < span.end; });
+
+    return it != _overlaySpans.end() && it->start < nEnd;
+}
+
+// Locate the overlay span that covers a file position
 //
-bool WindowBuf::overlayAlloc(uint32_t nInd) {
-    if (nInd >= NUM_OVERLAYS) {
-        _log.error("ERROR: Maximum number of overlays reached");
-        return false;
+// RETURN:
+// - The span, or nullptr if no overlay covers the position
+//
+const OverlaySpan *WindowBuf::overlayFind(uint64_t nPos) const {
+    if (_overlaySpans.empty()) return nullptr;
 
-    } else if (_overlays[nInd]) {
-        // Already allocated, move on
-        return true;
+    const auto it = std::upper_bound(_overlaySpans.begin(), _overlaySpans.end(), nPos,
+                                     [](uint64_t nPos, const OverlaySpan &span) { return nPos < span.end; });
 
-    } else {
-        _overlays[nInd] = new Overlay();
+    if (it == _overlaySpans.end() || it->start > nPos) return nullptr;
 
-        if (!_overlays[nInd]) {
-            _log.error("NOTE: Out of memory for extra file overlays");
-            return false;
-        } else {
-            memset(_overlays[nInd], 0, sizeof(Overlay));
-            // FIXME: may not be necessary
-            _overlays[nInd]->enabled = false;
-            _overlays[nInd]->start = 0;
-            _overlays[nInd]->len = 0;
-
-            _overlays[nInd]->mcuX = 0;
-            _overlays[nInd]->mcuY = 0;
-            _overlays[nInd]->mcuLen = 0;
-            _overlays[nInd]->mcuLenIns = 0;
-            _overlays[nInd]->dcAdjustY = 0;
-            _overlays[nInd]->dcAdjustCb = 0;
-            _overlays[nInd]->dcAdjustCr = 0;
-
-            // FIXME: Need to ensure that this is right
-            if (nInd + 1 >= _overlayMax) {
-                _overlayMax = nInd + 1;
+    return &*it;
+}
+
+// Lay an overlay on top of the resolved spans
+// - Existing spans are trimmed (or split) where the new overlay covers them
+//
+void WindowBuf::overlayAddSpans(const Overlay &overlay) {
+    if (overlay.data.empty()) return;
+
+    const auto nStart = overlay.start;
+    const auto nEnd = overlay.start + overlay.data.size();
+
+    std::vector<OverlaySpan> spans;
+    spans.reserve(_overlaySpans.size() + 2);
+
+    auto bAdded = false;
+    for (const auto &span : _overlaySpans) {
+        if (span.end <= nStart || span.start >= nEnd) {
+            if (!bAdded && span.start >= nEnd) {
+                spans.push_back({nStart, nEnd, overlay.data.data()});
+                bAdded = true;
             }
-            //m_nOverlayMax++;
 
-            return true;
+            spans.push_back(span);
+            continue;
+        }
+
+        // Keep whatever sticks out on either side of the new overlay
+        if (span.start < nStart) {
+            spans.push_back({span.start, nStart, span.data});
+        }
+
+        if (!bAdded) {
+            spans.push_back({nStart, nEnd, overlay.data.data()});
+            bAdded = true;
+        }
+
+        if (span.end > nEnd) {
+            spans.push_back({nEnd, span.end, span.data + (nEnd - span.start)});
         }
     }
+
+    if (!bAdded) {
+        spans.push_back({nStart, nEnd, overlay.data.data()});
+    }
+
+    _overlaySpans.swap(spans);
+}
+
+// Resolve the spans again from all installed overlays
+//
+void WindowBuf::overlayRebuildSpans() {
+    _overlaySpans.clear();
+
+    for (const auto &overlay : _overlays) {
+        overlayAddSpans(*overlay);
+    }
+
+    updateWindowOverlay();
+}
+
+// Refresh the cached "no overlay in the current window" flag
+//
+void WindowBuf::updateWindowOverlay() {
+    _winOverlayFree = !overlayInRange(_bufWinStart, _bufWinStart + _bufWinSize);
 }
 
 // Report out the list of overlays thave have been allocated
 //
 // PRE:
-// - m_nOverlayNum
-// - m_psOverlay[]
+// - _overlays
 //
 void WindowBuf::reportOverlays(ILog &pLog) {
     QString strTmp;
 
-    if (_overlayNum > 0) {
-        strTmp = QString("  Buffer Overlays active: %1").arg(_overlayNum);
+    if (!_overlays.empty()) {
+        strTmp = QString("  Buffer Overlays active: %1").arg(_overlays.size());
         pLog.info(strTmp);
 
-        for (uint32_t ind = 0; ind < _overlayNum; ind++) {
-            if (_overlays[ind]) {
-                strTmp =
-                    QString(
-                        "    %03u: MCU[%4u,%4u] MCU DelLen=[%2u] InsLen=[%2u] DC Offset YCC=[%5d,%5d,%5d] Overlay Byte Len=[%4u]").
-                        arg(ind).arg(_overlays[ind]->mcuX).arg(_overlays[ind]->mcuY).arg(_overlays[ind]->mcuLen).arg(
-                        _overlays[ind]->
-                            mcuLenIns).
-                        arg(_overlays[ind]->dcAdjustY).arg(_overlays[ind]->dcAdjustCb).arg(_overlays[ind]->dcAdjustCr).
-                        arg(_overlays[ind]->len);
-                pLog.info(strTmp);
-            }
+        for (uint32_t ind = 0; ind < _overlays.size(); ind++) {
+            const auto &overlay = *_overlays[ind];
+
+            strTmp =
+                QString(
+                    "    %03u: MCU[%4u,%4u] MCU DelLen=[%2u] InsLen=[%2u] DC Offset YCC=[%5d,%5d,%5d] Overlay Byte Len=[%4u]").
+                    arg(ind).arg(overlay.mcuX).arg(overlay.mcuY).arg(overlay.mcuLen).arg(overlay.mcuLenIns).
+                    arg(overlay.dcAdjustY).arg(overlay.dcAdjustCb).arg(overlay.dcAdjustCr).
+                    arg(overlay.data.size());
+            pLog.info(strTmp);
         }
 
         pLog.info("");
@@ -380,6 +944,7 @@ void WindowBuf::reportOverlays(ILog &pLog) {
 }
 
 // Define the content of an overlay
+// - The overlay is added on top of any earlier ones
 //
 // INPUT:
 // - nOvrInd                    The overlay index to update/replace
@@ -394,42 +959,29 @@ void WindowBuf::reportOverlays(ILog &pLog) {
 // - nAdjCb                             Additional info for this overlay
 // - nAdjCr                             Additional info for this overlay
 //
-bool WindowBuf::overlayInstall(uint32_t nOvrInd, unsigned char *pOverlay, uint32_t nLen, uint32_t nBegin,
+bool WindowBuf::overlayInstall(uint32_t nOvrInd, unsigned char *pOverlay, uint32_t nLen, uint64_t nBegin,
                                uint32_t nMcuX, uint32_t nMcuY, uint32_t nMcuLen, uint32_t nMcuLenIns,
                                int nAdjY, int nAdjCb, int nAdjCr) {
     nOvrInd;                      // Unreferenced param
 
-    // Ensure that the overlay is allocated, and allocate it
-    // if required. Fail out if we can't add (or run out of space)
-    if (!overlayAlloc(_overlayNum)) {
-        return false;
-    }
-
-    if (nLen < MAX_OVERLAY) {
-        _overlays[_overlayNum]->enabled = true;
-        _overlays[_overlayNum]->len = nLen;
+    auto overlay = std::make_unique<Overlay>();
 
-        // Copy the overlay content, but clip to maximum size and pad if shorter
-        for (uint32_t i = 0; i < MAX_OVERLAY; i++) {
-            _overlays[_overlayNum]->data[i] = (i < nLen) ? pOverlay[i] : 0x00;
-        }
+    overlay->start = nBegin;
+    overlay->data.assign(pOverlay, pOverlay + nLen);
 
-        _overlays[_overlayNum]->start = nBegin;
+    // For reporting, save the extra data
+    overlay->mcuX = nMcuX;
+    overlay->mcuY = nMcuY;
+    overlay->mcuLen = nMcuLen;
+    overlay->mcuLenIns = nMcuLenIns;
+    overlay->dcAdjustY = nAdjY;
+    overlay->dcAdjustCb = nAdjCb;
+    overlay->dcAdjustCr = nAdjCr;
 
-        // For reporting, save the extra data
-        _overlays[_overlayNum]->mcuX = nMcuX;
-        _overlays[_overlayNum]->mcuY = nMcuY;
-        _overlays[_overlayNum]->mcuLen = nMcuLen;
-        _overlays[_overlayNum]->mcuLenIns = nMcuLenIns;
-        _overlays[_overlayNum]->dcAdjustY = nAdjY;
-        _overlays[_overlayNum]->dcAdjustCb = nAdjCb;
-        _overlays[_overlayNum]->dcAdjustCr = nAdjCr;
+    overlayAddSpans(*overlay);
+    _overlays.push_back(std::move(overlay));
 
-        _overlayNum++;
-    } else {
-        _log.error("ERROR: CwindowBuf:overlayInstall() overlay too large");
-        return false;
-    }
+    updateWindowOverlay();
 
     return true;
 }
@@ -437,39 +989,27 @@ bool WindowBuf::overlayInstall(uint32_t nOvrInd, unsigned char *pOverlay, uint32
 // Remove latest overlay entry
 //
 // POST:
-// - m_nOverlayNum
-// - m_psOverlay[]
+// - _overlays
+// - _overlaySpans
 //
 void WindowBuf::overlayRemove() {
-    if (_overlayNum <= 0) {
+    if (_overlays.empty()) {
         return;
     }
 
-    _overlayNum--;
-
-    // Note that we've already decremented the m_nOverlayNum
-    if (_overlays[_overlayNum]) {
-        // Don't need to delete the overlay struct as we might as well reuse it
-        _overlays[_overlayNum]->enabled = false;
-        //delete m_psOverlay[m_nOverlayNum];
-        //m_psOverlay[m_nOverlayNum] = nullptr;
-    }
+    _overlays.pop_back();
+    overlayRebuildSpans();
 }
 
 // Disable all buffer overlays
 //
 // POST:
-// - m_nOverlayNum
-// - m_psOverlay[]
+// - _overlays
+// - _overlaySpans
 //
 void WindowBuf::overlayRemoveAll() {
-    _overlayNum = 0;
-
-    for (uint32_t nInd = 0; nInd < _overlayMax; nInd++) {
-        if (_overlays[nInd]) {
-            _overlays[nInd]->enabled = false;
-        }
-    }
+    _overlays.clear();
+    overlayRebuildSpans();
 }
 
 // Fetch the indexed buffer overlay
@@ -483,23 +1023,23 @@ void WindowBuf::overlayRemoveAll() {
 // - nBegin                     Starting file offset for the overlay
 //
 // RETURN:
-// - Success if overlay index was allocated and enabled
-//
-bool WindowBuf::overlayGet(uint32_t nOvrInd, unsigned char *&pOverlay, uint32_t &nLen, uint32_t &nBegin) {
-    if ((_overlays[nOvrInd]) && (_overlays[nOvrInd]->enabled)) {
-        pOverlay = _overlays[nOvrInd]->data;
-        nLen = _overlays[nOvrInd]->len;
-        nBegin = _overlays[nOvrInd]->start;
-        return _overlays[nOvrInd]->enabled;
-    } else {
-        return false;
-    }
+// - Success if overlay index is installed
+//
+bool WindowBuf::overlayGet(uint32_t nOvrInd, unsigned char *&pOverlay, uint32_t &nLen, uint64_t &nBegin) {
+    if (nOvrInd >= _overlays.size()) return false;
+
+    auto &overlay = *_overlays[nOvrInd];
+    pOverlay = overlay.data.data();
+    nLen = static_cast<uint32_t>(overlay.data.size());
+    nBegin = overlay.start;
+
+    return true;
 }
 
-// Get the number of buffer overlays allocated
+// Get the number of buffer overlays installed
 //
 uint32_t WindowBuf::overlayGetNum() {
-    return _overlayNum;
+    return static_cast<uint32_t>(_overlays.size());
 }
 
 // Replaces the direct buffer access with a managed refillable window/cache.
@@ -514,39 +1054,36 @@ uint32_t WindowBuf::overlayGetNum() {
 //
 // RETURN:
 // - Byte from the desired address
-uint8_t WindowBuf::getByte(uint32_t offset, bool clean) {
+uint8_t WindowBuf::getByte(uint64_t offset, bool clean) {
     // We are requesting address "nOffset"
     // Our current window runs from "m_nBufWinStart...buf_win_end" (m_nBufWinSize)
     // Therefore, our relative addr is nOffset-m_nBufWinStart
 
-    long nWinRel;
+    qint64 nWinRel;
 
     unsigned char currentValue = 0;
 
     Q_ASSERT(_file);
 
     // Allow for overlay buffer capability (if not in "clean" mode)
-    if (!clean) {
+    // - Skipped outright when no overlay touches the current window
+    nWinRel = static_cast<qint64>(offset) - _bufWinStart;
+
+    if (!clean && !(_winOverlayFree && nWinRel >= 0 && nWinRel < _bufWinSize)) {
         auto inOverlayWindow = false;
 
         // Now handle any overlays
-        for (uint32_t nInd = 0; nInd < _overlayNum; nInd++) {
-            if (_overlays[nInd]) {
-                if (_overlays[nInd]->enabled) {
-                    if ((offset >= _overlays[nInd]->start) &&
-                        (offset < _overlays[nInd]->start + _overlays[nInd]->len)) {
-                        currentValue = _overlays[nInd]->data[offset - _overlays[nInd]->start];
-                        inOverlayWindow = true;
-                    }
-                }
-            }
+        const auto span = overlayFind(offset);
+        if (span) {
+            currentValue = span->data[offset - span->start];
+            inOverlayWindow = true;
         }
 
         if (inOverlayWindow) {
             // Before we return, make sure that the real buffer handles this region!
-            nWinRel = offset - _bufWinStart;
+            nWinRel = static_cast<qint64>(offset) - _bufWinStart;
 
-            if ((nWinRel >= 0) && (nWinRel < (long) _bufWinSize)) {
+            if ((nWinRel >= 0) && (nWinRel < _bufWinSize)) {
             } else {
                 // Address is outside of current window
                 if (!loadWindow(offset)) {
@@ -563,11 +1100,11 @@ uint8_t WindowBuf::getByte(uint32_t offset, bool clean) {
 
     // Determine if the offset is within the current cache
     // If not, reload a new cache around the desired address
-    nWinRel = offset - _bufWinStart;
+    nWinRel = static_cast<qint64>(offset) - _bufWinStart;
 
-    if ((nWinRel >= 0) && (nWinRel < (long) _bufWinSize)) {
+    if ((nWinRel >= 0) && (nWinRel < _bufWinSize)) {
         // Address is within current window
-        return _buf[nWinRel];
+        return _win[nWinRel];
     } else {
         // Address is outside of current window
         if (!loadWindow(offset)) {
@@ -578,12 +1115,12 @@ uint8_t WindowBuf::getByte(uint32_t offset, bool clean) {
         // Now we assume that the address is in range
         // m_nBufWinStart has now been updated
         // TODO: check this
-        nWinRel = offset - _bufWinStart;
+        nWinRel = static_cast<qint64>(offset) - _bufWinStart;
 
         // Now recheck the window
         // TODO: Rewrite the following in a cleaner manner
-        if ((nWinRel >= 0) && (nWinRel < (long) _bufWinSize)) {
-            return _buf[nWinRel];
+        if ((nWinRel >= 0) && (nWinRel < _bufWinSize)) {
+            return _win[nWinRel];
         } else {
             // Still bad after refreshing window, so it must be bad addr
             _bufOk = false;
@@ -606,36 +1143,36 @@ uint8_t WindowBuf::getByte(uint32_t offset, bool clean) {
 // RETURN:
 // - 1/2/4 unsigned bytes from the desired address
 //
-uint32_t WindowBuf::getDataX(uint32_t offset, uint32_t size, bool byteSwap) {
-    long nWinRel;
+uint32_t WindowBuf::getDataX(uint64_t offset, uint32_t size, bool byteSwap) {
+    qint64 nWinRel;
 
     Q_ASSERT(_file);
 
-    nWinRel = offset - _bufWinStart;
+    nWinRel = static_cast<qint64>(offset) - _bufWinStart;
     if ((nWinRel >= 0) && (nWinRel + size < _bufWinSize)) {
         // Address is within current window
         if (!byteSwap) {
             if (size == 4) {
-                return ((_buf[nWinRel + 0] << 24) + (_buf[nWinRel + 1] << 16) +
-                        (_buf[nWinRel + 2] << 8) +
-                        (_buf[nWinRel + 3]));
+                return ((_win[nWinRel + 0] << 24) + (_win[nWinRel + 1] << 16) +
+                        (_win[nWinRel + 2] << 8) +
+                        (_win[nWinRel + 3]));
             } else if (size == 2) {
-                return ((_buf[nWinRel + 0] << 8) + (_buf[nWinRel + 1]));
+                return ((_win[nWinRel + 0] << 8) + (_win[nWinRel + 1]));
             } else if (size == 1) {
-                return (_buf[nWinRel + 0]);
+                return (_win[nWinRel + 0]);
             } else {
                 _log.error("ERROR: getDataX() with bad size");
                 return 0;
             }
         } else {
             if (size == 4) {
-                return ((_buf[nWinRel + 3] << 24) + (_buf[nWinRel + 2] << 16) +
-                        (_buf[nWinRel + 1] << 8) +
-                        (_buf[nWinRel + 0]));
+                return ((_win[nWinRel + 3] << 24) + (_win[nWinRel + 2] << 16) +
+                        (_win[nWinRel + 1] << 8) +
+                        (_win[nWinRel + 0]));
             } else if (size == 2) {
-                return ((_buf[nWinRel + 1] << 8) + (_buf[nWinRel + 0]));
+                return ((_win[nWinRel + 1] << 8) + (_win[nWinRel + 0]));
             } else if (size == 1) {
-                return (_buf[nWinRel + 0]);
+                return (_win[nWinRel + 0]);
             } else {
                 _log.error("ERROR: getDataX() with bad size");
                 return 0;
@@ -651,33 +1188,33 @@ uint32_t WindowBuf::getDataX(uint32_t offset, uint32_t size, bool byteSwap) {
         // Now we assume that the address is in range
         // m_nBufWinStart has now been updated
         // TODO: Check this
-        nWinRel = offset - _bufWinStart;
+        nWinRel = static_cast<qint64>(offset) - _bufWinStart;
 
         // Now recheck the window
         // TODO: Rewrite the following in a cleaner manner
         if ((nWinRel >= 0) && (nWinRel + size < _bufWinSize)) {
             if (!byteSwap) {
                 if (size == 4) {
-                    return ((_buf[nWinRel + 0] << 24) + (_buf[nWinRel + 1] << 16) +
-                            (_buf[nWinRel + 2] << 8) +
-                            (_buf[nWinRel + 3]));
+                    return ((_win[nWinRel + 0] << 24) + (_win[nWinRel + 1] << 16) +
+                            (_win[nWinRel + 2] << 8) +
+                            (_win[nWinRel + 3]));
                 } else if (size == 2) {
-                    return ((_buf[nWinRel + 0] << 8) + (_buf[nWinRel + 1]));
+                    return ((_win[nWinRel + 0] << 8) + (_win[nWinRel + 1]));
                 } else if (size == 1) {
-                    return (_buf[nWinRel + 0]);
+                    return (_win[nWinRel + 0]);
                 } else {
                     _log.error("ERROR: getDataX() with bad size");
                     return 0;
                 }
             } else {
                 if (size == 4) {
-                    return ((_buf[nWinRel + 3] << 24) + (_buf[nWinRel + 2] << 16) +
-                            (_buf[nWinRel + 1] << 8) +
-                            (_buf[nWinRel + 0]));
+                    return ((_win[nWinRel + 3] << 24) + (_win[nWinRel + 2] << 16) +
+                            (_win[nWinRel + 1] << 8) +
+                            (_win[nWinRel + 0]));
                 } else if (size == 2) {
-                    return ((_buf[nWinRel + 1] << 8) + (_buf[nWinRel + 0]));
+                    return ((_win[nWinRel + 1] << 8) + (_win[nWinRel + 0]));
                 } else if (size == 1) {
-                    return (_buf[nWinRel + 0]);
+                    return (_win[nWinRel + 0]);
                 } else {
                     _log.error("ERROR: getDataX() with bad size");
                     return 0;
@@ -693,21 +1230,159 @@ uint32_t WindowBuf::getDataX(uint32_t offset, uint32_t size, bool byteSwap) {
     }
 }
 
-unsigned char WindowBuf::getData1(uint32_t &offset, bool byteSwap) {
+// Fetch a read-only pointer to a contiguous run of bytes
+// - Avoids the per-byte window and overlay checks of getByte()
+// - The run ends early at the end of the window that holds it, at the
+//   edge of an overlay or at the end of the file, so callers wanting the
+//   whole range must call again from offset + returned length
+// - The pointer is only valid until the next call that may load a window
+//
+// INPUT:
+// - offset                     File offset of the first byte
+// - len                        Number of bytes wanted
+// - clean                      If FALSE, bytes covered by overlays are
+//                              returned instead of the file content
+//
+// OUTPUT:
+// - data                       Pointer to the first byte
+//
+// RETURN:
+// - Number of bytes available at data (0 if offset is not readable)
+//
+uint32_t WindowBuf::getSpan(uint64_t offset, uint32_t len, const uint8_t *&data, bool clean) {
+    if (len == 0 || static_cast<qint64>(offset) >= _fileSize) return 0;
+
+    uint64_t end = qMin<uint64_t>(offset + len, _fileSize);
+
+    if (!clean) {
+        // Stop at the edge of the overlay that covers the offset, or at
+        // the start of the next one
+        const auto span = overlayFind(offset);
+
+        if (span) {
+            end = qMin(end, span->end);
+            data = span->data + (offset - span->start);
+            return static_cast<uint32_t>(end - offset);
+        }
+
+        const auto it = std::upper_bound(_overlaySpans.begin(), _overlaySpans.end(), offset,
+                                         [](uint64_t nPos, const OverlaySpan &span) { return nPos < span.start; });
+        if (it != _overlaySpans.end()) {
+            end = qMin(end, it->start);
+        }
+    }
+
+    // Reuse the current window if it holds the offset, otherwise load one
+    // with room for as much of the range as a window can take
+    auto nWinRel = static_cast<qint64>(offset) - _bufWinStart;
+
+    if (nWinRel < 0 || nWinRel >= _bufWinSize) {
+        if (!loadWindow(offset, qMin<qint64>(end - offset, MAX_BUF - MAX_BUF_WINDOW_REV))) {
+            _bufOk = false;
+            return 0;
+        }
+
+        nWinRel = static_cast<qint64>(offset) - _bufWinStart;
+        if (nWinRel < 0 || nWinRel >= _bufWinSize) {
+            _bufOk = false;
+            return 0;
+        }
+    }
+
+    end = qMin<uint64_t>(end, _bufWinStart + _bufWinSize);
+    data = _win + nWinRel;
+
+    return static_cast<uint32_t>(end - offset);
+}
+
+// Copy a range of bytes out of the buffer
+// - Built on getSpan(), so bytes are copied a run at a time
+//
+// INPUT:
+// - offset                     File offset of the first byte
+// - len                        Number of bytes to copy
+// - clean                      If FALSE, bytes covered by overlays are
+//                              returned instead of the file content
+//
+// OUTPUT:
+// - dest                       Receives the bytes
+//
+// RETURN:
+// - Number of bytes copied (less than len if the file ends first)
+//
+uint32_t WindowBuf::readBytes(uint64_t offset, uint8_t *dest, uint32_t len, bool clean) {
+    uint32_t nDone = 0;
+
+    while (nDone < len) {
+        const uint8_t *pData;
+        const auto nLen = getSpan(offset + nDone, len - nDone, pData, clean);
+        if (nLen == 0) break;
+
+        memcpy(dest + nDone, pData, nLen);
+        nDone += nLen;
+    }
+
+    return nDone;
+}
+
+// Write a range of bytes to another file
+// - Ranges without overlay bytes are copied inside the kernel when
+//   possible (see CopyFileRange()), so the data never enters user space
+// - Anything the kernel can't copy is written out of the buffer windows
+//   a run at a time
+// - Writes at, and advances, the current position of outFile
+//
+// INPUT:
+// - offset                     File offset of the first byte
+// - len                        Number of bytes to copy
+// - clean                      If FALSE, bytes covered by overlays are
+//                              written instead of the file content
+//
+// RETURN:
+// - Number of bytes written (less than len if the file ends first)
+//
+uint64_t WindowBuf::copyToFile(QFile &outFile, uint64_t offset, uint64_t len, bool clean) {
+    if (!_file || static_cast<qint64>(offset) >= _fileSize) return 0;
+
+    len = qMin<uint64_t>(len, _fileSize - offset);
+    uint64_t nDone = 0;
+
+    if (_kernelCopyEnabled && (clean || !overlayInRange(offset, offset + len)) && outFile.flush()) {
+        const auto nOutPos = static_cast<uint64_t>(outFile.pos());
+
+        nDone = CopyFileRange(_file->handle(), offset, outFile.handle(), nOutPos, len);
+
+        // Bring the file's own position past the copied bytes
+        if (nDone > 0 && !outFile.seek(static_cast<qint64>(nOutPos + nDone))) return nDone;
+    }
+
+    while (nDone < len) {
+        const uint8_t *pData;
+        const auto nLen = getSpan(offset + nDone, static_cast<uint32_t>(qMin<uint64_t>(len - nDone, UINT32_MAX)), pData, clean);
+        if (nLen == 0) break;
+
+        if (outFile.write(reinterpret_cast<const char *>(pData), nLen) != nLen) break;
+        nDone += nLen;
+    }
+
+    return nDone;
+}
+
+unsigned char WindowBuf::getData1(uint64_t &offset, bool byteSwap) {
     const auto result = static_cast<unsigned char>(getDataX(offset, 1, byteSwap));
     offset += 1;
 
     return result;
 }
 
-uint16_t WindowBuf::getData2(uint32_t &offset, bool byteSwap) {
+uint16_t WindowBuf::getData2(uint64_t &offset, bool byteSwap) {
     const auto result = static_cast<uint16_t>(getDataX(offset, 2, byteSwap));
     offset += 2;
 
     return result;
 }
 
-uint32_t WindowBuf::getData4(uint32_t &offset, bool byteSwap) {
+uint32_t WindowBuf::getData4(uint64_t &offset, bool byteSwap) {
     const auto result = getDataX(offset, 4, byteSwap);
     offset += 4;
 
@@ -726,7 +1401,7 @@ uint32_t WindowBuf::getData4(uint32_t &offset, bool byteSwap) {
 // RETURN:
 // - String fetched from file
 //
-QString WindowBuf::readStr(uint32_t nPosition) {
+QString WindowBuf::readStr(uint64_t nPosition) {
     // Try to read a NULL-terminated string from file offset "nPosition"
     // up to a maximum of MAX_BUF_READ_STR bytes. Result is max length MAX_BUF_READ_STR
     QString strRd = "";
@@ -768,7 +1443,7 @@ QString WindowBuf::readStr(uint32_t nPosition) {
 // RETURN:
 // - String fetched from file
 //
-QString WindowBuf::readUniStr(uint32_t nPosition) {
+QString WindowBuf::readUniStr(uint64_t nPosition) {
     // Try to read a NULL-terminated string from file offset "nPosition"
     // up to a maximum of MAX_BUF_READ_STR bytes. Result is max length MAX_BUF_READ_STR
     QString strRd;
@@ -807,7 +1482,7 @@ QString WindowBuf::readUniStr(uint32_t nPosition) {
 // Wrapper for ByteStr2Unicode that uses local Window Buffer
 #define MAX_UNICODE_STRLEN    255
 
-QString WindowBuf::readUniStr2(uint32_t nPos, uint32_t nBufLen) {
+QString WindowBuf::readUniStr2(uint64_t nPos, uint32_t nBufLen) {
     // Convert byte array into unicode string
     // TODO: Replace with call to ByteStr2Unicode()
 
@@ -872,7 +1547,7 @@ QString WindowBuf::readUniStr2(uint32_t nPos, uint32_t nBufLen) {
 // RETURN:
 // - String fetched from file
 //
-QString WindowBuf::readStrN(uint32_t nPosition, uint32_t nLen) {
+QString WindowBuf::readStrN(uint64_t nPosition, uint32_t nLen) {
     // Try to read a fixed-length string from file offset "nPosition"
     // up to a maximum of "nLen" bytes. Result is length "nLen"
     QString strRd;
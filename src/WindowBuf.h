@@ -21,7 +21,14 @@
 // - Provides a cache for file access
 // - Allows random access to a file but only issues new file I/O if
 //   the requested address is outside of the current cache window
+// - Keeps a few independently positioned windows with LRU replacement
+//   so that parsing can alternate between distant regions of the file
+// - Optionally memory-maps the whole file, in which case the mapping
+//   acts as a single window spanning the file and no copies are made
+// - When not mapped, sequential access prefetches the next window on a
+//   background thread (read-ahead) through a separate file handle
 // - Provides an overlay for temporary (local) buffer overwrites
+// - Copies ranges to other files, inside the kernel where possible
 // - Buffer search methods
 //
 // ==========================================================================
@@ -34,28 +41,33 @@
 #include <QFile>
 #include <QString>
 
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "ByteScan.h"
+#include "ContentHash.h"
 #include "log/ILog.h"
 
-// For now, we only ever use MAX_BUF_WINDOW bytes, even though we
-// have allocated MAX_BUF bytes up front. I might change this
-// later. We don't want the window size to be too large as it
-// could have an impact on performance.
+// Each cache window allocates MAX_BUF bytes up front. The number of
+// bytes actually loaded adapts to the access pattern: it starts at
+// MAX_BUF_WINDOW, grows towards MAX_BUF while the file is read
+// sequentially and shrinks towards MIN_BUF_WINDOW on random jumps.
 #define MAX_BUF            262144
 #define MAX_BUF_WINDOW     131072
+#define MIN_BUF_WINDOW     32768
 #define MAX_BUF_WINDOW_REV 16384  //1024L
 
-#define NUM_OVERLAYS       500
-#define MAX_OVERLAY        500     // 500 bytes
+#define NUM_WINDOWS        4       // Independently positioned cache windows
+#define MIN_WINDOW_AHEAD   16      // Bytes past a position a cached window must hold
 
 #define NUM_HOLES          10
 
 #define    MAX_BUF_READ_STR 255     // Max number of bytes to fetch in BufReadStr()
 
 struct Overlay {
-    bool enabled;               // Enabled? -- not used currently
-    uint32_t start;             // File position
-    uint32_t len;               // MCU Length
-    uint8_t data[MAX_OVERLAY];  // Byte data
+    uint64_t start;             // File position
+    std::vector<uint8_t> data;  // Byte data (any length)
 
     // For reporting purposes:
     uint32_t mcuX;               // Starting MCU X
@@ -67,6 +79,22 @@ struct Overlay {
     int dcAdjustCr;
 };
 
+// A run of file positions whose bytes come from a single overlay
+// - Kept sorted and non-overlapping, with the most recently installed
+//   overlay winning wherever overlays overlap
+struct OverlaySpan {
+    uint64_t start;             // First file position covered
+    uint64_t end;               // One past the last file position covered
+    const uint8_t *data;        // Overlay byte for file position start
+};
+
+struct CacheWindow {
+    unsigned char *buf;         // MAX_BUF bytes
+    qint64 start;               // File position of buf[0]
+    qint64 size;                // Bytes loaded (0 if unused)
+    uint64_t lastUse;           // LRU stamp
+};
+
 class WindowBuf {
     Q_DISABLE_COPY(WindowBuf)
 public:
@@ -77,52 +105,111 @@ public:
     qint64 fileSize() const;
     qint64 position() const;
 
+    bool isMapEnabled() const;
+    void setMapEnabled(bool enabled);
+    bool isMapped() const;
+
+    bool isReadAheadEnabled() const;
+    void setReadAheadEnabled(bool enabled);
+
+    bool isKernelCopyEnabled() const;
+    void setKernelCopyEnabled(bool enabled);
+
+    qint64 windowSize() const;
+    uint64_t cacheHits() const;
+    uint64_t cacheMisses() const;
+    void resetCacheStats();
+
     void setFile(QFile *file);
     void unsetFile();
     bool loadWindow(qint64 position);
 
-    uint8_t getByte(uint32_t offset, bool clean = false);
-    uint32_t getDataX(uint32_t offset, uint32_t size, bool byteSwap = false);
+    uint8_t getByte(uint64_t offset, bool clean = false);
+    uint32_t getDataX(uint64_t offset, uint32_t size, bool byteSwap = false);
 
-    unsigned char getData1(uint32_t &offset, bool byteSwap);
-    uint16_t getData2(uint32_t &offset, bool byteSwap);
-    uint32_t getData4(uint32_t &offset, bool byteSwap);
+    uint32_t getSpan(uint64_t offset, uint32_t len, const uint8_t *&data, bool clean = false);
+    uint32_t readBytes(uint64_t offset, uint8_t *dest, uint32_t len, bool clean = false);
+    uint64_t copyToFile(QFile &outFile, uint64_t offset, uint64_t len, bool clean = false);
 
-    QString readStr(uint32_t nPosition);
-    QString readUniStr(uint32_t nPosition);
-    QString readUniStr2(uint32_t nPos, uint32_t nBufLen);
-    QString readStrN(uint32_t nPosition, uint32_t nLen);
+    unsigned char getData1(uint64_t &offset, bool byteSwap);
+    uint16_t getData2(uint64_t &offset, bool byteSwap);
+    uint32_t getData4(uint64_t &offset, bool byteSwap);
 
-    bool search(uint32_t startPosition, uint32_t searchValue, uint32_t searchLength, bool forward, uint32_t &foundPosition);
-    bool searchX(uint32_t nStartPos, uint8_t *anSearchVal, uint32_t nSearchLen, bool bDirFwd, uint32_t &nFoundPos);
+    QString readStr(uint64_t nPosition);
+    QString readUniStr(uint64_t nPosition);
+    QString readUniStr2(uint64_t nPos, uint32_t nBufLen);
+    QString readStrN(uint64_t nPosition, uint32_t nLen);
 
-    bool overlayAlloc(uint32_t nInd);
-    bool overlayInstall(uint32_t nOvrInd, uint8_t *pOverlay, uint32_t nLen, uint32_t nBegin,
+    bool search(uint64_t startPosition, uint32_t searchValue, uint32_t searchLength, bool forward, uint64_t &foundPosition,
+                uint64_t lastPosition = UINT64_MAX);
+    bool searchX(uint64_t nStartPos, uint8_t *anSearchVal, uint32_t nSearchLen, bool bDirFwd, uint64_t &nFoundPos);
+    bool searchX(uint64_t nStartPos, const SearchPattern &pattern, bool bDirFwd, uint64_t &nFoundPos);
+    void searchAll(uint64_t nStartPos, uint64_t nEndPos, const MultiPattern &patterns, std::vector<PatternHit> &hits);
+    bool skipScanData(uint64_t nStartPos, uint64_t &nMarkerPos, std::vector<uint64_t> *pRstPos = nullptr,
+                      ContentHash *pHash = nullptr, ContentHash *pRawHash = nullptr);
+
+    bool overlayInstall(uint32_t nOvrInd, uint8_t *pOverlay, uint32_t nLen, uint64_t nBegin,
                         uint32_t nMcuX, uint32_t nMcuY, uint32_t nMcuLen, uint32_t nMcuLenIns, int nAdjY, int nAdjCb,
                         int nAdjCr);
     void overlayRemove();
     void overlayRemoveAll();
-    bool overlayGet(uint32_t nOvrInd, uint8_t *&pOverlay, uint32_t &nLen, uint32_t &nBegin);
+    bool overlayGet(uint32_t nOvrInd, uint8_t *&pOverlay, uint32_t &nLen, uint64_t &nBegin);
     uint32_t overlayGetNum();
     void reportOverlays(ILog &log);
 
 private:
     void reset();
+    bool mapFile();
+    void unmapFile();
+    void clearWindows();
+    void selectWindow(uint32_t nInd);
+    uint32_t findWindow(qint64 position, qint64 len) const;
+    uint32_t victimWindow() const;
+    void adaptWindowSize(qint64 position, qint64 len);
+    bool loadWindow(qint64 position, qint64 len);
+    void openReadAhead();
+    void closeReadAhead();
+    void startReadAhead();
+    bool takeReadAhead(qint64 position, qint64 len);
+    bool searchPattern(uint64_t nStartPos, uint64_t nLastPos, const SearchPattern &pattern, bool bDirFwd, uint64_t &nFoundPos);
+    bool loadSearchWindow(uint64_t nPos, uint32_t nLen, bool bDirFwd);
+    bool matchAt(uint64_t nPos, const uint8_t *anPattern, uint32_t nLen);
+    bool overlayInRange(uint64_t nStart, uint64_t nEnd) const;
+    const OverlaySpan *overlayFind(uint64_t nPos) const;
+    void overlayAddSpans(const Overlay &overlay);
+    void overlayRebuildSpans();
+    void updateWindowOverlay();
 
     ILog &_log;
-    unsigned char *_buf;
+    CacheWindow _windows[NUM_WINDOWS]{};
+    uint32_t _curWindow = 0;               // Index of the current cache window
+    uint64_t _useClock = 0;                // Source of CacheWindow::lastUse stamps
+    qint64 _winLoadSize = MAX_BUF_WINDOW;  // Bytes to load on the next miss
+    uint64_t _cacheHits = 0;               // Window switches served from the cache
+    uint64_t _cacheMisses = 0;             // Window loads that went to the file
+    const unsigned char *_win = nullptr;   // Current window: a cache window buffer or _map
 
     QFile *_file = nullptr;
 
+    bool _mapEnabled = true;    // Try to memory-map files on setFile()
+    uchar *_map = nullptr;      // Mapping of the whole file (if mapped)
+
+    bool _readAheadEnabled = true;          // Prefetch on setFile() when not mapped
+    bool _kernelCopyEnabled = true;         // Let copyToFile() copy inside the kernel
+    std::unique_ptr<QFile> _aheadFile;      // Handle owned by the read-ahead thread
+    unsigned char *_aheadBuf;               // Back buffer filled by the read-ahead thread
+    qint64 _aheadStart = 0;                 // File position of the back buffer
+    std::future<qint64> _ahead;             // Pending read-ahead, yields bytes read
+
     bool _bufOk = false;
     qint64 _position = 0;
     qint64 _fileSize = 0;
-    uint32_t _bufWinSize = 0;
-    uint32_t _bufWinStart = 0;
+    qint64 _bufWinSize = 0;
+    qint64 _bufWinStart = 0;
 
-    uint32_t _overlayMax;       // Number of overlays allocated (limited by mem)
-    uint32_t _overlayNum;
-    Overlay *_overlays[NUM_OVERLAYS]{};
+    std::vector<std::unique_ptr<Overlay>> _overlays;   // In order of installation
+    std::vector<OverlaySpan> _overlaySpans;            // Resolved view of _overlays, by position
+    bool _winOverlayFree = true;                       // No overlay touches the current window
 };
 
 #endif
@@ -0,0 +1,139 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "WorkPool.h"
+
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Items still owed to one worker
+// - The owner takes from the front, thieves take from the back
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<size_t> items;
+};
+
+}
+
+// INPUT:
+// - nThreads                   Number of worker threads (0 for one per core)
+//
+WorkPool::WorkPool(uint32_t nThreads) :
+    _threads(nThreads > 0 ? nThreads : defaultThreadCount()) {
+}
+
+uint32_t WorkPool::threadCount() const {
+    return _threads;
+}
+
+uint32_t WorkPool::defaultThreadCount() {
+    const auto nCores = std::thread::hardware_concurrency();
+    return nCores > 0 ? nCores : 1;
+}
+
+// Run fn on every item in [0, nItems) and wait for all of them
+// - With a single worker the items run in order on the calling thread
+// - If any item throws, the remaining items still run and the first
+//   exception is rethrown once all workers have finished
+//
+void WorkPool::run(size_t nItems, const WorkFn &fn) {
+    if (nItems == 0) return;
+
+    const auto nWorkers = static_cast<uint32_t>(qMin<size_t>(_threads, nItems));
+
+    if (nWorkers == 1) {
+        for (size_t nItem = 0; nItem < nItems; nItem++) {
+            fn(0, nItem);
+        }
+
+        return;
+    }
+
+    // Deal out contiguous shares so that neighbouring items (eg. files
+    // from the same directory) tend to stay on the same worker
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    for (uint32_t nWorker = 0; nWorker < nWorkers; nWorker++) {
+        auto queue = std::make_unique<WorkQueue>();
+
+        const auto nFirst = nItems * nWorker / nWorkers;
+        const auto nLast = nItems * (nWorker + 1) / nWorkers;
+        for (auto nItem = nFirst; nItem < nLast; nItem++) {
+            queue->items.push_back(nItem);
+        }
+
+        queues.push_back(std::move(queue));
+    }
+
+    std::mutex errorLock;
+    std::exception_ptr error;
+
+    const auto work = [&](uint32_t nWorker) {
+        while (true) {
+            size_t nItem = 0;
+            auto bFound = false;
+
+            // Own queue first, then steal from the others. Items are never
+            // added once started, so empty queues everywhere means done.
+            for (uint32_t nOffset = 0; nOffset < nWorkers && !bFound; nOffset++) {
+                auto &queue = *queues[(nWorker + nOffset) % nWorkers];
+                std::lock_guard<std::mutex> guard(queue.lock);
+
+                if (queue.items.empty()) continue;
+
+                if (nOffset == 0) {
+                    nItem = queue.items.front();
+                    queue.items.pop_front();
+                } else {
+                    nItem = queue.items.back();
+                    queue.items.pop_back();
+                }
+
+                bFound = true;
+            }
+
+            if (!bFound) return;
+
+            try {
+                fn(nWorker, nItem);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(errorLock);
+                if (!error) error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t nWorker = 1; nWorker < nWorkers; nWorker++) {
+        threads.emplace_back(work, nWorker);
+    }
+
+    // The calling thread is worker 0
+    work(0);
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    if (error) std::rethrow_exception(error);
+}
@@ -0,0 +1,56 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// ==========================================================================
+// CLASS DESCRIPTION:
+// - Runs a numbered set of work items on a fixed number of threads
+// - Each thread starts with its own contiguous share of the items and,
+//   once that runs dry, steals from the far end of the other threads'
+//   shares, so one long item never holds up the items queued behind it
+// - Items are identified by index; the worker index is passed along so
+//   that callers can keep per-thread state (eg. one SnoopCore each)
+//
+// ==========================================================================
+
+#pragma once
+
+#ifndef JPEGSNOOP_WORKPOOL_H
+#define JPEGSNOOP_WORKPOOL_H
+
+#include <QtGlobal>
+
+#include <functional>
+
+class WorkPool {
+    Q_DISABLE_COPY(WorkPool)
+public:
+    typedef std::function<void(uint32_t nWorker, size_t nItem)> WorkFn;
+
+    explicit WorkPool(uint32_t nThreads = 0);
+
+    uint32_t threadCount() const;
+
+    void run(size_t nItems, const WorkFn &fn);
+
+    static uint32_t defaultThreadCount();
+
+private:
+    uint32_t _threads;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "AsyncLog.h"
+
+#include <atomic>
+
+#include "../LineWriter.h"
+
+static std::atomic<uint64_t> g_nextLogId(1);
+
+AsyncLog::AsyncLog(const QString &filePath, size_t maxQueued) :
+    _id(g_nextLogId++),
+    _maxQueued(maxQueued) {
+
+    LineWriter::openOutput(_file, filePath);
+
+    _writer = std::thread(&AsyncLog::writerLoop, this);
+}
+
+// Queue whatever the threads still hold, then wait for the writer
+// - Threads that log must have finished by now
+//
+AsyncLog::~AsyncLog() {
+    {
+        std::lock_guard<std::mutex> lock(_bufMutex);
+        for (auto &entry : _threadBufs) {
+            submit(entry.second->data);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _stop = true;
+    }
+
+    _queueNotEmpty.notify_one();
+    _writer.join();
+
+    _file.close();
+}
+
+bool AsyncLog::isOpen() const {
+    return _file.isOpen();
+}
+
+void AsyncLog::debug(const QString &text) {
+    if (!isEnabled() || !isDebugEnabled()) return;
+
+    append("", text);
+}
+
+void AsyncLog::trace(const QString &text) {
+    if (!isEnabled() || !isTraceEnabled()) return;
+
+    append("", text);
+}
+
+void AsyncLog::info(const QString &text) {
+    if (!isEnabled() || !isInfoEnabled()) return;
+
+    append("", text);
+}
+
+void AsyncLog::warn(const QString &text) {
+    if (!isEnabled() || !isWarnEnabled()) return;
+
+    append("WARN: ", text);
+}
+
+void AsyncLog::error(const QString &text) {
+    if (!isEnabled() || !isErrorEnabled()) return;
+
+    append("ERROR: ", text);
+}
+
+void AsyncLog::flush() {
+    submit(threadBuf().data);
+}
+
+void AsyncLog::append(const char *prefix, const QString &text) {
+    auto &data = threadBuf().data;
+
+    data += prefix;
+    data += text.toUtf8();
+    data += '\n';
+}
+
+// The calling thread's buffer
+// - Looked up once per thread and then cached, as long as the thread
+//   keeps logging to the same log
+//
+AsyncLog::ThreadBuf &AsyncLog::threadBuf() {
+    thread_local uint64_t cachedId = 0;
+    thread_local ThreadBuf *cachedBuf = nullptr;
+
+    if (cachedId != _id) {
+        std::lock_guard<std::mutex> lock(_bufMutex);
+
+        auto &buf = _threadBufs[std::this_thread::get_id()];
+        if (!buf) {
+            buf = std::make_unique<ThreadBuf>();
+        }
+
+        cachedId = _id;
+        cachedBuf = buf.get();
+    }
+
+    return *cachedBuf;
+}
+
+// Hand a block of lines to the writer, waiting while the queue is full
+// - A block larger than the queue limit still goes through once the
+//   queue is empty
+//
+void AsyncLog::submit(QByteArray &block) {
+    if (block.isEmpty()) return;
+
+    const auto size = static_cast<size_t>(block.size());
+
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        _queueNotFull.wait(lock, [&] { return _queuedBytes == 0 || _queuedBytes + size <= _maxQueued; });
+
+        _queue.push_back(std::move(block));
+        _queuedBytes += size;
+    }
+
+    block = QByteArray();
+    _queueNotEmpty.notify_one();
+}
+
+void AsyncLog::writerLoop() {
+    std::deque<QByteArray> blocks;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _queueNotEmpty.wait(lock, [&] { return _stop || !_queue.empty(); });
+
+            if (_queue.empty()) break;
+
+            blocks.swap(_queue);
+        }
+
+        size_t written = 0;
+        for (const auto &block : blocks) {
+            if (_file.isOpen()) {
+                _file.write(block);
+            }
+
+            written += static_cast<size_t>(block.size());
+        }
+
+        blocks.clear();
+        _file.flush();
+
+        // The blocks only stop counting against the limit once written
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _queuedBytes -= written;
+        }
+
+        _queueNotFull.notify_all();
+    }
+}
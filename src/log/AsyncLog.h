@@ -0,0 +1,80 @@
+#pragma once
+
+#ifndef JPEGSNOOP_ASYNCLOG_H
+#define JPEGSNOOP_ASYNCLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ILog.h"
+
+// Bytes queued for the writer before loggers have to wait
+static constexpr size_t ASYNC_LOG_QUEUE_MAX = 8 * 1024 * 1024;
+
+// Log that writes from a background thread
+// - Each logging thread appends to its own buffer, with no locking. The
+//   buffers are registered under a mutex, which a thread only takes the
+//   first time it logs (see threadBuf()).
+// - flush() ends a group of lines (eg. the report of one image) and
+//   queues it for the writer as one block, so groups from different
+//   threads never interleave, however large they get
+// - The writer drains the queue in large sequential writes
+// - Loggers wait while ASYNC_LOG_QUEUE_MAX bytes are queued or still
+//   being written, which bounds the memory held when the output can't
+//   keep up
+//
+class AsyncLog : public ILog {
+    Q_DISABLE_COPY(AsyncLog)
+public:
+    // Opened as by LineWriter::openOutput()
+    explicit AsyncLog(const QString &filePath, size_t maxQueued = ASYNC_LOG_QUEUE_MAX);
+    ~AsyncLog() override;
+
+    bool isOpen() const;
+
+    void debug(const QString &text) override;
+    void trace(const QString &text) override;
+    void info(const QString &text) override;
+
+    void warn(const QString &text) override;
+    void error(const QString &text) override;
+
+    void flush() override;
+
+private:
+    struct ThreadBuf {
+        QByteArray data;
+    };
+
+    void append(const char *prefix, const QString &text);
+    ThreadBuf &threadBuf();
+    void submit(QByteArray &block);
+    void writerLoop();
+
+    QFile _file;
+    const uint64_t _id;                 // Tells apart logs that reuse an address
+    const size_t _maxQueued;
+
+    std::mutex _queueMutex;
+    std::condition_variable _queueNotEmpty;
+    std::condition_variable _queueNotFull;
+    std::deque<QByteArray> _queue;
+    size_t _queuedBytes = 0;            // Queued or being written
+    bool _stop = false;
+
+    std::mutex _bufMutex;
+    std::map<std::thread::id, std::unique_ptr<ThreadBuf>> _threadBufs;
+
+    std::thread _writer;
+};
+
+#endif //JPEGSNOOP_ASYNCLOG_H
@@ -16,6 +16,10 @@ public:
     virtual void warn(const QString &text) = 0;
     virtual void error(const QString &text) = 0;
 
+    // End a group of lines that belong together (eg. one image's report)
+    virtual void flush() {
+    }
+
     virtual bool isEnabled() const {
         return _enabled;
     }
@@ -81,4 +85,30 @@ private:
     bool _errorEnabled = true;
 };
 
+// Logging front end
+// - Each macro tests the level before its message is evaluated, so no
+//   message is formatted for a disabled level
+// - LOG_xxx_ON() guards a message that is built over several statements
+// - Building with JPEGSNOOP_NULL_LOG compiles out the info, debug and
+//   trace levels. Warnings and errors are always kept.
+//
+#ifdef JPEGSNOOP_NULL_LOG
+#define LOG_DEBUG_ON(log) false
+#define LOG_TRACE_ON(log) false
+#define LOG_INFO_ON(log) false
+#else
+#define LOG_DEBUG_ON(log) ((log).isEnabled() && (log).isDebugEnabled())
+#define LOG_TRACE_ON(log) ((log).isEnabled() && (log).isTraceEnabled())
+#define LOG_INFO_ON(log) ((log).isEnabled() && (log).isInfoEnabled())
+#endif
+
+#define LOG_WARN_ON(log) ((log).isEnabled() && (log).isWarnEnabled())
+#define LOG_ERROR_ON(log) ((log).isEnabled() && (log).isErrorEnabled())
+
+#define LOG_DEBUG(log, ...) do { if (LOG_DEBUG_ON(log)) (log).debug(__VA_ARGS__); } while (0)
+#define LOG_TRACE(log, ...) do { if (LOG_TRACE_ON(log)) (log).trace(__VA_ARGS__); } while (0)
+#define LOG_INFO(log, ...) do { if (LOG_INFO_ON(log)) (log).info(__VA_ARGS__); } while (0)
+#define LOG_WARN(log, ...) do { if (LOG_WARN_ON(log)) (log).warn(__VA_ARGS__); } while (0)
+#define LOG_ERROR(log, ...) do { if (LOG_ERROR_ON(log)) (log).error(__VA_ARGS__); } while (0)
+
 #endif //JPEGSNOOP_ILOG_H
@@ -1,10 +1,19 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
 #include <QDirIterator>
 #include <QDebug>
-#include <QFileInfo>
 
+#include <memory>
+
+#include "log/AsyncLog.h"
 #include "log/ConsoleLog.h"
+#include "BatchCarver.h"
+#include "HashManifest.h"
+#include "KnownHashSet.h"
+#include "PackWriter.h"
+#include "ResultWriter.h"
 #include "SnoopConfig.h"
-#include "SnoopCore.h"
 
 QStringList GetFilePathsFromDir(const QString &dir) {
     if (dir.isEmpty()) return {};
@@ -18,47 +27,141 @@ QStringList GetFilePathsFromDir(const QString &dir) {
     return result;
 }
 
-QString GetFilePath(const QString &dirPath, const QString &srcFilePath, int index) {
-    QFileInfo info(srcFilePath);
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Carves the JPEG images out of every file in a directory.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("input", "Directory of the files to carve.");
+    parser.addPositionalArgument("output", "Directory to export the images to.");
+
+    // Options left empty (eg. --known "") are treated as not given
+    const QCommandLineOption threadsOption("threads", "Number of worker threads, 0 for one per core.", "count", "0");
+    const QCommandLineOption reportOption("report", "Write the analysis of every image to <path> (\"-\" for stdout).", "path");
+    const QCommandLineOption resultsOption("results", "Write an NDJSON record per image to <path> (\"-\" for stdout).", "path");
+    const QCommandLineOption packOption("pack", "Store the images in <name>_NNNN.pack files in the output directory, indexed by <name>.idx.", "name");
+    const QCommandLineOption dedupOption("dedup", "Export each distinct image once. <mode> is \"content\", or \"identity\" to also treat copies that differ only in their metadata as the same image.", "mode");
+    const QCommandLineOption knownOption("known", "Leave out the images whose MD5 is in the hash set at <path> (built by the hashset tool).", "path");
+    const QCommandLineOption manifestOption("manifest", "Write the MD5 of every exported image to <path> in md5sum format (\"-\" for stdout).", "path");
+    const QCommandLineOption phashOption("phash", "Add a perceptual hash to the result records.");
+    const QCommandLineOption indexOption("index", "Keep the candidate index of every file in <dir>, and reuse the ones saved by earlier runs.", "dir");
+    const QCommandLineOption indexEoiOption("index-eoi", "Also record the EOI markers in the candidate indexes.");
+    const QCommandLineOption skipValidatedOption("skip-validated", "Don't look for images inside an image that decoded, other than its EXIF thumbnail.");
+    const QCommandLineOption noQuickRejectOption("no-quick-reject", "Run the full decode on every candidate, even those whose markers don't chain (relaxed parsing can still recover some of them).");
+    const QCommandLineOption noMapOption("no-map", "Read the input files through a window buffer instead of memory-mapping them.");
+    const QCommandLineOption noReadAheadOption("no-read-ahead", "Don't prefetch the next window in the background when a file isn't mapped.");
+    const QCommandLineOption noKernelCopyOption("no-kernel-copy", "Export the images with buffered writes instead of copying them inside the kernel.");
+
+    parser.addOptions({threadsOption, reportOption, resultsOption, packOption, dedupOption, knownOption, manifestOption,
+                       phashOption, indexOption, indexEoiOption, skipValidatedOption,
+                       noQuickRejectOption, noMapOption, noReadAheadOption, noKernelCopyOption});
+    parser.process(app);
+
+    const auto args = parser.positionalArguments();
+    if (args.size() != 2) {
+        parser.showHelp(1);
+    }
 
-    const auto newFileName = QString("%1_%2.jpg")
-        .arg(info.baseName(), QString::number(index).rightJustified(4, '0'));
+    const auto &inputDir = args.at(0);
+    const auto &outputDir = args.at(1);
 
-    QDir dir(dirPath);
-    return dir.filePath(newFileName);
-}
+    // With a report path, the analysis of every image is written there
+    // from a background thread
+    const auto reportPath = parser.value(reportOption);
 
-int main(int argc, char *argv[]) {
-    if (argc < 3) return 0;
+    std::unique_ptr<ILog> log;
+    if (!reportPath.isEmpty()) {
+        log.reset(new AsyncLog(reportPath));
+        log->setInfoEnabled(true);
+    } else {
+        log.reset(new ConsoleLog());
+        log->setInfoEnabled(false);
+    }
 
-    ConsoleLog log;
-    log.setTraceEnabled(false);
-    log.setDebugEnabled(false);
-    log.setInfoEnabled(false);
+    log->setTraceEnabled(false);
+    log->setDebugEnabled(false);
 
-    const QString inputDir(argv[1]);
-    const QString outputDir(argv[2]);
+    SnoopConfig appConfig;
+    appConfig.setThreadCount(parser.value(threadsOption).toUInt());
+    appConfig.setPerceptualHash(parser.isSet(phashOption));
+    appConfig.setIndexEoi(parser.isSet(indexEoiOption));
+    appConfig.setSkipValidated(parser.isSet(skipValidatedOption));
+    appConfig.setQuickReject(!parser.isSet(noQuickRejectOption));
+    appConfig.setMapFile(!parser.isSet(noMapOption));
+    appConfig.setReadAhead(!parser.isSet(noReadAheadOption));
+    appConfig.setKernelCopy(!parser.isSet(noKernelCopyOption));
+
+    const auto dedupMode = parser.value(dedupOption);
+    if (!dedupMode.isEmpty()) {
+        if (dedupMode != "content" && dedupMode != "identity") {
+            log->error(QString("Unknown dedup mode [%1]").arg(dedupMode));
+            return 1;
+        }
+
+        appConfig.setDedup(true);
+        appConfig.setDedupIdentity(dedupMode == "identity");
+    }
 
     const auto filePaths = GetFilePathsFromDir(inputDir);
 
-    SnoopConfig appConfig;
-    SnoopCore core(log, appConfig);
-
-    for (const auto &filePath: filePaths) {
-        try {
-            core.openFile(filePath);
-
-            auto index = 1;
-
-            do {
-                if (core.analyze()) {
-                    const auto newFilePath = GetFilePath(outputDir, filePath, index++);
-                    core.exportJpeg(newFilePath);
-                }
-            } while (core.searchForward());
-        } catch (const std::exception &ex) {
-            log.error(ex.what());
+    BatchCarver carver(*log, appConfig);
+
+    std::unique_ptr<ResultWriter> results;
+    const auto resultsPath = parser.value(resultsOption);
+    if (!resultsPath.isEmpty()) {
+        results.reset(new ResultWriter(resultsPath));
+        if (!results->isOpen()) {
+            log->error(QString("Couldn't open the results file [%1]").arg(resultsPath));
+            return 1;
         }
+
+        carver.setResultWriter(results.get());
+    }
+
+    std::unique_ptr<PackWriter> pack;
+    const auto packName = parser.value(packOption);
+    if (!packName.isEmpty()) {
+        const auto indexPath = QDir(outputDir).filePath(QString("%1.idx").arg(packName));
+        pack.reset(new PackWriter(indexPath));
+        if (!pack->isOpen()) {
+            log->error(QString("Couldn't create the pack files for [%1]").arg(indexPath));
+            return 1;
+        }
+
+        carver.setPackWriter(pack.get());
+    }
+
+    KnownHashSet known;
+    const auto knownPath = parser.value(knownOption);
+    if (!knownPath.isEmpty()) {
+        if (!known.open(knownPath)) {
+            log->error(QString("Couldn't open the hash set [%1]").arg(knownPath));
+            return 1;
+        }
+
+        carver.setKnownHashSet(&known);
+    }
+
+    std::unique_ptr<HashManifest> manifest;
+    const auto manifestPath = parser.value(manifestOption);
+    if (!manifestPath.isEmpty()) {
+        manifest.reset(new HashManifest(manifestPath));
+        if (!manifest->isOpen()) {
+            log->error(QString("Couldn't open the manifest [%1]").arg(manifestPath));
+            return 1;
+        }
+
+        carver.setHashManifest(manifest.get());
+    }
+
+    carver.setIndexDir(parser.value(indexOption));
+
+    carver.run(filePaths, outputDir);
+
+    if (pack && !pack->close()) {
+        log->error("Couldn't write the pack files");
+        return 1;
     }
 
     return 0;
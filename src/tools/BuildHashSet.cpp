@@ -0,0 +1,51 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <QString>
+
+#include <cstdio>
+
+#include "../KnownHashSet.h"
+
+// Build a known-file hash set from a hash list (one MD5 per line, eg.
+// md5sum output or an NSRL export) for the carver to load
+//
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <hash list> <hash set> [bloom bits per hash]\n", argv[0]);
+        return 2;
+    }
+
+    auto nBloomBits = HASH_SET_BLOOM_BITS;
+    if (argc > 3) {
+        nBloomBits = QString(argv[3]).toUInt();
+        if (nBloomBits == 0) {
+            fprintf(stderr, "Bloom bits per hash must be at least 1\n");
+            return 2;
+        }
+    }
+
+    uint64_t nCount = 0;
+    if (!KnownHashSet::build(argv[1], argv[2], nBloomBits, &nCount)) {
+        fprintf(stderr, "Couldn't build [%s] from [%s]\n", argv[2], argv[1]);
+        return 1;
+    }
+
+    printf("%llu hashes\n", static_cast<unsigned long long>(nCount));
+    return 0;
+}
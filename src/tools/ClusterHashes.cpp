@@ -0,0 +1,132 @@
+// JPEGsnoop - JPEG Image Decoder & Analysis Utility
+// Copyright (C) 2018 - Calvin Hass
+// http://www.impulseadventure.com/photo/jpeg-snoop.html
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 2 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../PerceptualHash.h"
+
+// Value of a string member of an NDJSON result record, with its escapes
+// undone ("\uXXXX" escapes are kept as they are)
+//
+static bool FindString(const std::string &line, const char *key, std::string &value) {
+    const auto pattern = std::string("\"") + key + "\":\"";
+    auto nPos = line.find(pattern);
+    if (nPos == std::string::npos) return false;
+
+    value.clear();
+    for (nPos += pattern.size(); nPos < line.size() && line[nPos] != '"'; nPos++) {
+        if (line[nPos] == '\\' && nPos + 1 < line.size() && line[nPos + 1] != 'u') {
+            nPos++;
+        }
+
+        value += line[nPos];
+    }
+
+    return true;
+}
+
+static bool FindNumber(const std::string &line, const char *key, unsigned long long &value) {
+    const auto pattern = std::string("\"") + key + "\":";
+    const auto nPos = line.find(pattern);
+    if (nPos == std::string::npos) return false;
+
+    value = strtoull(line.c_str() + nPos + pattern.size(), nullptr, 10);
+    return true;
+}
+
+// Group the carved images of result files (see ResultWriter) whose
+// perceptual hashes are close, and print every group of two or more:
+//   <group> <tab> <phash> <tab> <output, or source@offset if not exported>
+//
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <max distance (0-%u)> <results.ndjson|-> ...\n", argv[0], PHASH_MAX_CLUSTER_DIST);
+        return 2;
+    }
+
+    const auto nMaxDist = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    if (nMaxDist > PHASH_MAX_CLUSTER_DIST) {
+        fprintf(stderr, "Max distance must be at most %u\n", PHASH_MAX_CLUSTER_DIST);
+        return 2;
+    }
+
+    std::vector<uint64_t> hashes;
+    std::vector<std::string> labels;
+
+    for (auto nArg = 2; nArg < argc; nArg++) {
+        std::ifstream file;
+        const auto bStdin = std::string(argv[nArg]) == "-";
+        if (!bStdin) {
+            file.open(argv[nArg]);
+            if (!file) {
+                fprintf(stderr, "Couldn't open [%s]\n", argv[nArg]);
+                return 1;
+            }
+        }
+
+        auto &input = bStdin ? std::cin : static_cast<std::istream &>(file);
+
+        std::string line;
+        std::string value;
+        while (std::getline(input, line)) {
+            if (!FindString(line, "phash", value)) continue;
+
+            hashes.push_back(strtoull(value.c_str(), nullptr, 16));
+
+            if (!FindString(line, "output", value)) {
+                unsigned long long nOffset = 0;
+                FindString(line, "source", value);
+                FindNumber(line, "offset", nOffset);
+
+                char acOffset[24];
+                snprintf(acOffset, sizeof(acOffset), "@0x%llx", nOffset);
+                value += acOffset;
+            }
+
+            labels.push_back(value);
+        }
+    }
+
+    const auto clusters = PerceptualHashClusters(hashes, nMaxDist);
+
+    std::vector<uint32_t> sizes(hashes.size(), 0);
+    for (const auto nCluster : clusters) {
+        sizes[nCluster]++;
+    }
+
+    // Groups in order of their first image, members in input order
+    std::vector<std::vector<uint32_t>> members(hashes.size());
+    for (uint32_t nInd = 0; nInd < hashes.size(); nInd++) {
+        if (sizes[clusters[nInd]] > 1) {
+            members[clusters[nInd]].push_back(nInd);
+        }
+    }
+
+    for (uint32_t nCluster = 0; nCluster < members.size(); nCluster++) {
+        for (const auto nInd : members[nCluster]) {
+            printf("%u\t%016llx\t%s\n", nCluster, static_cast<unsigned long long>(hashes[nInd]), labels[nInd].c_str());
+        }
+    }
+
+    return 0;
+}